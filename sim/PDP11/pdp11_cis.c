@@ -84,7 +84,13 @@
 
    CIS instructions can run for a very long time, so they are interruptible
    and restartable.  In the simulator, all instructions run to completion.
-   The code is unoptimized.
+
+   Where the relocation cache maps a string straight to memory, the
+   character instructions work on it in place, a page at a time, and the
+   decimal instructions fetch and store their operands as a block.  The
+   byte by byte routines remain for everything else (I/O page, aborts,
+   big-endian hosts).  Multiply and divide are done in 64b binary when
+   the operands fit.
 */
 
 #include "pdp11_defs.h"
@@ -192,6 +198,15 @@ void CreateTable (DSTR *dsrc, DSTR mtable[10]);
 t_bool cis_int_test (int32 cycles, int32 oldpc, t_stat *st);
 int32 movx_setup (int32 op, int32 *arg);
 void movx_cleanup (int32 op);
+int32 movx_fast (int32 op, int32 done, t_bool bkwd);
+int32 cmpc_fast (int32 done);
+static uint8 *cis_map (int32 va, int32 max, t_bool wr, int32 *run);
+static uint8 *cis_map_dn (int32 va, int32 max, t_bool wr, int32 *run);
+static void cis_rdstr (int32 va, int32 lnt, uint8 *buf);
+static void cis_wrstr (int32 va, int32 lnt, uint8 *buf);
+static void cis_fill (int32 va, int32 lnt, int32 c);
+static t_bool DstrToQ (DSTR *src, t_uint64 *q);
+static void QToDstr (t_uint64 q, DSTR *dst);
 
 extern int32 ReadW (int32 addr);
 extern void WriteW (int32 data, int32 addr);
@@ -199,6 +214,8 @@ extern int32 ReadB (int32 addr);
 extern int32 ReadMB (int32 addr);
 extern void WriteB (int32 data, int32 addr);
 extern int32 calc_ints (int32 nipl, int32 trq);
+extern int32 reloc_cache_run (int32 va, t_bool wr, uint32 *pa);
+extern uint16 *M;
 
 /* Table of instruction operands */
 
@@ -331,10 +348,12 @@ t_stat cis11 (int32 IR)
 {
 int32 c, i, j, t, op, rn, addr;
 int32 match, limit, mvlnt, shift;
-int32 spc, ldivd, ldivr;
+int32 spc, ldivd, ldivr, n;
 int32 arg[6];                                           /* operands */
 int32 old_PC;
 uint32 nc, digit, result;
+uint8 *p, *q, *tbl;
+t_uint64 q1, q2;
 t_stat st;
 static DSTR accum, src1, src2, dst;
 static DSTR mptable[10];
@@ -427,15 +446,20 @@ switch (op) {                                           /* case on opcode */
         if (R[0] && R[2]) {                             /* move to do? */
             if (R[1] < R[3]) {                          /* backwards? */
                 for (i = 0; R[0] && R[2]; ) {           /* move loop */
-                    t = ReadB (((R[1] - 1) & 0177777) | dsenable);
-                    if (op & 2)
-                        t = ReadB (((R[5] + t) & 0177777) | dsenable);
-                    WriteB (t, ((R[3] - 1) & 0177777) | dsenable);
-                    R[0]--;
-                    R[1] = (R[1] - 1) & 0177777;
-                    R[2]--;
-                    R[3] = (R[3] - 1) & 0177777;
-                    if ((++i >= INT_TEST) && R[0] && R[2]) {
+                    if ((n = movx_fast (op, i, TRUE)))  /* block moved? */
+                        i = i + n;
+                    else {
+                        t = ReadB (((R[1] - 1) & 0177777) | dsenable);
+                        if (op & 2)
+                            t = ReadB (((R[5] + t) & 0177777) | dsenable);
+                        WriteB (t, ((R[3] - 1) & 0177777) | dsenable);
+                        R[0]--;
+                        R[1] = (R[1] - 1) & 0177777;
+                        R[2]--;
+                        R[3] = (R[3] - 1) & 0177777;
+                        i++;
+                        }
+                    if ((i >= INT_TEST) && R[0] && R[2]) {
                         if (cis_int_test (i, old_PC, &st))
                             return st;
                         i = 0;
@@ -446,15 +470,20 @@ switch (op) {                                           /* case on opcode */
                 }                                       /* end if bkwd */
             else {                                      /* forward */
                 for (i = 0; R[0] && R[2]; ) {           /* move loop */
-                    t = ReadB ((R[1] & 0177777) | dsenable);
-                    if (op & 2)
-                        t = ReadB (((R[5] + t) & 0177777) | dsenable);
-                    WriteB (t, (R[3] & 0177777) | dsenable);
-                    R[0]--;
-                    R[1] = (R[1] + 1) & 0177777;
-                    R[2]--;
-                    R[3] = (R[3] + 1) & 0177777;
-                    if ((++i >= INT_TEST) && R[0] && R[2]) {
+                    if ((n = movx_fast (op, i, FALSE))) /* block moved? */
+                        i = i + n;
+                    else {
+                        t = ReadB ((R[1] & 0177777) | dsenable);
+                        if (op & 2)
+                            t = ReadB (((R[5] + t) & 0177777) | dsenable);
+                        WriteB (t, (R[3] & 0177777) | dsenable);
+                        R[0]--;
+                        R[1] = (R[1] + 1) & 0177777;
+                        R[2]--;
+                        R[3] = (R[3] + 1) & 0177777;
+                        i++;
+                        }
+                    if ((i >= INT_TEST) && R[0] && R[2]) {
                         if (cis_int_test (i, old_PC, &st))
                             return st;
                         i = 0;
@@ -462,9 +491,7 @@ switch (op) {                                           /* case on opcode */
                     }                                   /* end for lnts */
                 }                                       /* end else fwd */
             }                                           /* end if move */
-        for (i = 0; i < R[2]; i++) {
-            WriteB (R[4], ((R[3] + i) & 0177777) | dsenable);
-            }
+        cis_fill (R[3], R[2], R[4]);                    /* fill rest of dst */
         movx_cleanup (op);                              /* cleanup */
         return SCPE_OK;
 
@@ -509,13 +536,18 @@ switch (op) {                                           /* case on opcode */
         if (R[0] && R[2]) {                             /* move to do? */
             if (R[1] < R[3]) {                          /* backwards? */
                 for (i = 0; R[0] && R[2]; ) {           /* move loop */
-                    t = ReadB (((R[1] - 1) & 0177777) | dsenable);
-                    WriteB (t, ((R[3] - 1) & 0177777) | dsenable);
-                    R[0]--;
-                    R[1] = (R[1] - 1) & 0177777;
-                    R[2]--;
-                    R[3] = (R[3] - 1) & 0177777;
-                    if ((++i >= INT_TEST) && R[0] && R[2]) {
+                    if ((n = movx_fast (op, i, TRUE)))  /* block moved? */
+                        i = i + n;
+                    else {
+                        t = ReadB (((R[1] - 1) & 0177777) | dsenable);
+                        WriteB (t, ((R[3] - 1) & 0177777) | dsenable);
+                        R[0]--;
+                        R[1] = (R[1] - 1) & 0177777;
+                        R[2]--;
+                        R[3] = (R[3] - 1) & 0177777;
+                        i++;
+                        }
+                    if ((i >= INT_TEST) && R[0] && R[2]) {
                         if (cis_int_test (i, old_PC, &st))
                             return st;
                         i = 0;
@@ -524,13 +556,18 @@ switch (op) {                                           /* case on opcode */
                 }                                       /* end if bkwd */
             else {                                      /* forward */
                 for (i = 0; R[0] && R[2]; ) {           /* move loop */
-                    t = ReadB ((R[1] & 0177777) | dsenable);
-                    WriteB (t, (R[3] & 0177777) | dsenable);
-                    R[0]--;
-                    R[1] = (R[1] + 1) & 0177777;
-                    R[2]--;
-                    R[3] = (R[3] + 1) & 0177777;
-                    if ((++i >= INT_TEST) && R[0] && R[2]) {
+                    if ((n = movx_fast (op, i, FALSE))) /* block moved? */
+                        i = i + n;
+                    else {
+                        t = ReadB ((R[1] & 0177777) | dsenable);
+                        WriteB (t, (R[3] & 0177777) | dsenable);
+                        R[0]--;
+                        R[1] = (R[1] + 1) & 0177777;
+                        R[2]--;
+                        R[3] = (R[3] + 1) & 0177777;
+                        i++;
+                        }
+                    if ((i >= INT_TEST) && R[0] && R[2]) {
                         if (cis_int_test (i, old_PC, &st))
                             return st;
                         i = 0;
@@ -540,9 +577,7 @@ switch (op) {                                           /* case on opcode */
                 R[3] = (R[3] - mvlnt) & 0177777;        /* start of dst str */
                 }                                       /* end else fwd */
             }                                           /* end if move */
-        for (i = 0; i < R[2]; i++) {
-            WriteB (R[4], ((R[3] - R[2] + i) & 0177777) | dsenable);
-            }
+        cis_fill (R[3] - R[2], R[2], R[4]);             /* fill rest of dst */
         movx_cleanup (op);                              /* cleanup */
         return SCPE_OK;
 
@@ -594,12 +629,31 @@ switch (op) {                                           /* case on opcode */
         fpd = 1;                                        /* set FPD */
         R[4] = R[4] & 0377;                             /* match character */
         for (i = 0; R[0] != 0;) {                       /* loop */
-            c = ReadB (R[1] | dsenable);                /* get char */
-            if ((c == R[4]) ^ (op & 1))                 /* = + LOC, != + SKP? */
-                break;
-            R[0]--;                                     /* decr count, */
-            R[1] = (R[1] + 1) & 0177777;                /* incr addr */
-            if ((++i >= INT_TEST) && R[0]) {            /* test for intr? */
+            if ((p = cis_map (R[1], INT_TEST - i, FALSE, &n))) {
+                if (n > R[0])                           /* scan in place */
+                    n = R[0];
+                if (op & 1) {                           /* SKP? */
+                    for (t = 0; (t < n) && (p[t] == R[4]); t++) ;
+                    }
+                else {                                  /* LOC */
+                    q = (uint8 *) memchr (p, R[4], n);
+                    t = q? (int32) (q - p): n;
+                    }
+                R[0] = R[0] - t;                        /* skip chars */
+                R[1] = (R[1] + t) & 0177777;
+                i = i + t;
+                if (t < n)                              /* found? */
+                    break;
+                }
+            else {
+                c = ReadB (R[1] | dsenable);            /* get char */
+                if ((c == R[4]) ^ (op & 1))             /* = + LOC, != + SKP? */
+                    break;
+                R[0]--;                                 /* decr count, */
+                R[1] = (R[1] + 1) & 0177777;            /* incr addr */
+                i++;
+                }
+            if ((i >= INT_TEST) && R[0]) {              /* test for intr? */
                 if (cis_int_test (i, old_PC, &st))
                     return st;
                 i = 0;
@@ -648,13 +702,30 @@ switch (op) {                                           /* case on opcode */
         fpd = 1;                                        /* set FPD */
         R[4] = R[4] & 0377;                             /* match character */
         for (i = 0; R[0] != 0;) {                       /* loop */
-            t = ReadB (R[1] | dsenable);                /* get char as index */
-            c = ReadB (((R[5] + t) & 0177777) | dsenable);
-            if (((c & R[4]) != 0) ^ (op & 1))           /* != + SCN, = + SPN? */
-                break;
-            R[0]--;                                     /* decr count, */
-            R[1] = (R[1] + 1) & 0177777;                /* incr addr */
-            if ((++i >= INT_TEST) && R[0]) {            /* test for intr? */
+            if ((p = cis_map (R[1], INT_TEST - i, FALSE, &n)) &&
+                (tbl = cis_map (R[5], 256, FALSE, &t)) && (t == 256)) {
+                if (n > R[0])                           /* scan in place */
+                    n = R[0];
+                for (t = 0; t < n; t++) {
+                    if (((tbl[p[t]] & R[4]) != 0) ^ (op & 1))
+                        break;
+                    }
+                R[0] = R[0] - t;                        /* skip chars */
+                R[1] = (R[1] + t) & 0177777;
+                i = i + t;
+                if (t < n)                              /* found? */
+                    break;
+                }
+            else {
+                t = ReadB (R[1] | dsenable);            /* get char as index */
+                c = ReadB (((R[5] + t) & 0177777) | dsenable);
+                if (((c & R[4]) != 0) ^ (op & 1))       /* != + SCN, = + SPN? */
+                    break;
+                R[0]--;                                 /* decr count, */
+                R[1] = (R[1] + 1) & 0177777;            /* incr addr */
+                i++;
+                }
+            if ((i >= INT_TEST) && R[0]) {              /* test for intr? */
                 if (cis_int_test (i, old_PC, &st))
                     return st;
                 i = 0;
@@ -710,23 +781,28 @@ switch (op) {                                           /* case on opcode */
         R[4] = R[4] & 0377;                             /* mask fill */
         c = t = 0;
         for (i = 0; (R[0] || R[2]); ) {                 /* until cnts == 0 */
-            if (R[0])                                   /* get src1 or fill */
-                c = ReadB (R[1] | dsenable);
-            else c = R[4];
-            if (R[2])                                   /* get src2 or fill */
-                t = ReadB (R[3] | dsenable);
-            else t = R[4];
-            if (c != t)                                 /* if diff, done */
-                break;
-            if (R[0]) {                                 /* if more src1 */
-                R[0]--;                                 /* decr count, */
-                R[1] = (R[1] + 1) & 0177777;            /* incr addr */
-                }
-            if (R[2]) {                                 /* if more src2 */
-                R[2]--;                                 /* decr count, */
-                R[3] = (R[3] + 1) & 0177777;            /* incr addr */
+            if (R[0] && R[2] && (n = cmpc_fast (i)))    /* equal block? */
+                i = i + n;
+            else {
+                if (R[0])                               /* get src1 or fill */
+                    c = ReadB (R[1] | dsenable);
+                else c = R[4];
+                if (R[2])                               /* get src2 or fill */
+                    t = ReadB (R[3] | dsenable);
+                else t = R[4];
+                if (c != t)                             /* if diff, done */
+                    break;
+                if (R[0]) {                             /* if more src1 */
+                    R[0]--;                             /* decr count, */
+                    R[1] = (R[1] + 1) & 0177777;        /* incr addr */
+                    }
+                if (R[2]) {                             /* if more src2 */
+                    R[2]--;                             /* decr count, */
+                    R[3] = (R[3] + 1) & 0177777;        /* incr addr */
+                    }
+                i++;
                 }
-            if ((++i >= INT_TEST) && (R[0] || R[2])) {  /* test for intr? */
+            if ((i >= INT_TEST) && (R[0] || R[2])) {    /* test for intr? */
                 if (cis_int_test (i, old_PC, &st))
                     return st;
                 i = 0;
@@ -789,10 +865,19 @@ switch (op) {                                           /* case on opcode */
     case 0045:                                          /* register */
         fpd = 1;
         for (match = 0; R[0] >= R[2]; ) {               /* loop thru string */
-            for (i = 0, match = 1; match && (i < R[2]); i++) {
-                c = ReadB (((R[1] + i) & 0177777) | dsenable);
-                t = ReadB (((R[3] + i) & 0177777) | dsenable);
-                match = (c == t);                       /* end for substring */
+            if (R[2] &&                                 /* both in memory? */
+                (p = cis_map (R[1], R[2], FALSE, &n)) && (n == R[2]) &&
+                (q = cis_map (R[3], R[2], FALSE, &n)) && (n == R[2])) {
+                for (i = 0; (i < R[2]) && (p[i] == q[i]); i++) ;
+                if (!(match = (i == R[2])))             /* count mismatch */
+                    i++;
+                }
+            else {
+                for (i = 0, match = 1; match && (i < R[2]); i++) {
+                    c = ReadB (((R[1] + i) & 0177777) | dsenable);
+                    t = ReadB (((R[3] + i) & 0177777) | dsenable);
+                    match = (c == t);                   /* end for substring */
+                    }
                 }
             if (match)                                  /* exit if match */
                 break;
@@ -877,6 +962,15 @@ switch (op) {                                           /* case on opcode */
         dst = Dstr0;                                    /* clear result */
         if (ReadDstr (A1, &src1, op) && ReadDstr (A2, &src2, op)) {
             dst.sign = src1.sign ^ src2.sign;           /* sign of result */
+            if (DstrToQ (&src1, &q1) && DstrToQ (&src2, &q2) &&
+                (q2 <= (~((t_uint64) 0) / q1))) {       /* product fits 64b? */
+                QToDstr (q1 * q2, &dst);                /* multiply in binary */
+                V = C = 0;
+                WriteDstr (A3, &dst, op);               /* store result */
+                if ((op & INLINE) == 0)                 /* if reg, clr reg */
+                    R[0] = R[1] = R[2] = R[3] = 0;
+                return SCPE_OK;
+                }
             accum = Dstr0;                              /* clear accum */
             NibbleRshift (&src1, 1, 0);                 /* shift out sign */
             CreateTable (&src1, mptable);               /* create *1, *2, ... */
@@ -919,6 +1013,16 @@ switch (op) {                                           /* case on opcode */
             }
         ldivr = LntDstr (&src1, ldivr);                 /* get exact length */
         ldivd = ReadDstr (A2, &src2, op);               /* get dividend */
+        if (DstrToQ (&src1, &q1) && DstrToQ (&src2, &q2)) {
+            dst = Dstr0;                                /* divide in binary */
+            QToDstr (q2 / q1, &dst);
+            dst.sign = src1.sign ^ src2.sign;           /* calculate sign */
+            V = C = 0;
+            WriteDstr (A3, &dst, op);                   /* store result */
+            if ((op & INLINE) == 0)                     /* if reg, clr reg */
+                R[0] = R[1] = R[2] = R[3] = 0;
+            return SCPE_OK;
+            }
         ldivd = LntDstr (&src2, ldivd);                 /* get exact length */
         dst = Dstr0;                                    /* clear dest */
         NibbleRshift (&src1, 1, 0);                     /* right justify ops */
@@ -1175,14 +1279,16 @@ return SCPE_OK;
 int32 ReadDstr (int32 *dscr, DSTR *src, int32 flag)
 {
 int32 c, i, end, lnt, type, t = 0;
+uint8 buf[DSTRLNT * 8];
 
 *src = Dstr0;                                           /* clear result */
 type = GET_DTYP (dscr[0]);                              /* get type */
 lnt = GET_DLNT (dscr[0]);                               /* get string length */
 if (flag & PACKED) {                                    /* packed? */
     end = lnt / 2;                                      /* last byte */
+    cis_rdstr (dscr[1], end + 1, buf);                  /* fetch string */
     for (i = 0; i <= end; i++) {                        /* loop thru string */
-        c = ReadB (((dscr[1] + end - i) & 0177777) | dsenable);
+        c = buf[end - i];
         if (i == 0)                                     /* save sign */
             t = c & 0xF;
         if ((i == end) && ((lnt & 1) == 0))
@@ -1200,8 +1306,9 @@ if (flag & PACKED) {                                    /* packed? */
 else {                                                  /* numeric */
     if (type >= TS) src->sign = (ReadB ((((type == TS)?
          dscr[1] + lnt: dscr[1] - 1) & 0177777) | dsenable) == '-');
+    cis_rdstr (dscr[1], lnt, buf);                      /* fetch string */
     for (i = 1; i <= lnt; i++) {                        /* loop thru string */
-        c = ReadB (((dscr[1] + lnt - i) & 0177777) | dsenable);
+        c = buf[lnt - i];
         if ((i == 1) && (type == XZ) && ((c & 0xF0) == 0x70))
             src->sign = 1;                              /* signed zoned */
         else if (((i == 1) && (type == TO)) ||
@@ -1245,6 +1352,7 @@ void WriteDstr (int32 *dscr, DSTR *dst, int32 flag)
 {
 int32 c, i, limit, end, type, lnt;
 uint32 mask;
+uint8 buf[DSTRLNT * 8];
 static uint32 masktab[8] = {
     0xFFFFFFF0, 0xFFFFFF00, 0xFFFFF000, 0xFFFF0000,
     0xFFF00000, 0xFF000000, 0xF0000000, 0x00000000
@@ -1274,15 +1382,14 @@ if (flag & PACKED) {                                    /* packed? */
     if (type == UP)
         dst->val[0] = dst->val[0] | 0xF;
     else dst->val[0] = dst->val[0] | 0xC | dst->sign;
-    for (i = 0; i <= end; i++) {                        /* store string */
-        c = (dst->val[i / 4] >> ((i % 4) * 8)) & 0xFF;
-        WriteB (c, ((dscr[1] + end - i) & 0177777) | dsenable);
-        }                                               /* end for */
+    for (i = 0; i <= end; i++)                          /* build string */
+        buf[end - i] = (dst->val[i / 4] >> ((i % 4) * 8)) & 0xFF;
+    cis_wrstr (dscr[1], end + 1, buf);                  /* store string */
     }                                                   /* end packed */
 else {
     if (type >= TS) WriteB (dst->sign? '-': '+', (((type == TS)?
          dscr[1] + lnt: dscr[1] - 1) & 0177777) | dsenable);
-    for (i = 1; i <= lnt; i++) {                        /* store string */
+    for (i = 1; i <= lnt; i++) {                        /* build string */
         c = (dst->val[i / 8] >> ((i % 8) * 4)) & 0xF;   /* get digit */
         if ((i == 1) && (type == XZ) && dst->sign)
             c = c | 0x70;                               /* signed zoned */
@@ -1290,8 +1397,9 @@ else {
             ((i == lnt) && (type == LO)))
             c = binover[dst->sign][c];                  /* get sign and digit */
         else c = c | 0x30;                              /* default */
-        WriteB (c, ((dscr[1] + lnt - i) & 0177777) |dsenable );    
+        buf[lnt - i] = (uint8) c;
         }                                               /* end for */
+    cis_wrstr (dscr[1], lnt, buf);                      /* store string */
     }                                                   /* end numeric */
 return;
 }
@@ -1555,6 +1663,45 @@ if ((s = sc * 4)) {
 return 0;
 }
 
+/* Convert decimal string magnitude to 64b binary
+
+   Arguments:
+        src     =       decimal string structure
+        q       =       pointer to result
+   Output       =       FALSE if the magnitude has more than 19 digits
+*/
+
+static t_bool DstrToQ (DSTR *src, t_uint64 *q)
+{
+int32 i;
+t_uint64 v;
+
+if (src->val[3] || (src->val[2] & 0xFFFF0000))          /* > 19 digits? */
+    return FALSE;
+for (i = 19, v = 0; i > 0; i--)
+    v = (v * 10) + ((src->val[i / 8] >> ((i % 8) * 4)) & 0xF);
+*q = v;
+return TRUE;
+}
+
+/* Convert 64b binary to decimal string magnitude
+
+   Arguments:
+        q       =       binary value
+        dst     =       decimal string structure, digits must be zero
+*/
+
+static void QToDstr (t_uint64 q, DSTR *dst)
+{
+int32 i;
+
+for (i = 1; q; i++) {
+    dst->val[i / 8] = dst->val[i / 8] | (((uint32) (q % 10)) << ((i % 8) * 4));
+    q = q / 10;
+    }
+return;
+}
+
 /* Common setup routine for MOVC class instructions */
 
 int32 movx_setup (int32 op, int32 *arg)
@@ -1614,6 +1761,108 @@ else R[1] = R[2] = R[3] = 0;                            /* reg, clear R1 - R3 */
 fpd = 0;                                                /* instr done */
 return;
 }
+
+/* Block move for MOVC class instructions
+
+   Moves as many characters as possible, up to the next interrupt test,
+   directly between pages in memory.  Overlapping strings are moved in
+   the order of the byte loop, so the result is the same.  Returns the
+   number of characters moved; 0 if the next character must be moved
+   by the byte loop.
+*/
+
+int32 movx_fast (int32 op, int32 done, t_bool bkwd)
+{
+int32 k, n, run;
+uint8 *sp, *dp, *tbl = NULL;
+
+n = INT_TEST - done;                                    /* limit to int test */
+if (n > R[0])
+    n = R[0];
+if (n > R[2])
+    n = R[2];
+if (op & 2) {                                           /* translate? */
+    if (((tbl = cis_map (R[5], 256, FALSE, &run)) == NULL) || (run < 256))
+        return 0;
+    }
+if (bkwd) {                                             /* sp, dp = last char */
+    if ((sp = cis_map_dn (R[1], n, FALSE, &run)) == NULL)
+        return 0;
+    if (run < n)
+        n = run;
+    if ((dp = cis_map_dn (R[3], n, TRUE, &run)) == NULL)
+        return 0;
+    if (run < n)
+        n = run;
+    sp = sp - n + 1;                                    /* now first char */
+    dp = dp - n + 1;
+    }
+else {
+    if ((sp = cis_map (R[1], n, FALSE, &run)) == NULL)
+        return 0;
+    if (run < n)
+        n = run;
+    if ((dp = cis_map (R[3], n, TRUE, &run)) == NULL)
+        return 0;
+    if (run < n)
+        n = run;
+    }
+if ((tbl == NULL) && ((dp + n <= sp) || (sp + n <= dp)))
+    memcpy (dp, sp, n);                                 /* disjoint, copy */
+else if (bkwd) {
+    for (k = n - 1; k >= 0; k--)
+        dp[k] = tbl? tbl[sp[k]]: sp[k];
+    }
+else {
+    for (k = 0; k < n; k++)
+        dp[k] = tbl? tbl[sp[k]]: sp[k];
+    }
+R[0] = R[0] - n;                                        /* update descriptors */
+R[2] = R[2] - n;
+if (bkwd) {
+    R[1] = (R[1] - n) & 0177777;
+    R[3] = (R[3] - n) & 0177777;
+    }
+else {
+    R[1] = (R[1] + n) & 0177777;
+    R[3] = (R[3] + n) & 0177777;
+    }
+return n;
+}
+
+/* Block compare for CMPC
+
+   Skips the characters, up to the next interrupt test, that are equal
+   in both strings, where both are in memory.  Returns the number of
+   characters skipped; 0 if the next pair must be compared by the byte
+   loop (including when they differ).
+*/
+
+int32 cmpc_fast (int32 done)
+{
+int32 k, n, run;
+uint8 *p1, *p2;
+
+n = INT_TEST - done;                                    /* limit to int test */
+if (n > R[0])
+    n = R[0];
+if (n > R[2])
+    n = R[2];
+if ((p1 = cis_map (R[1], n, FALSE, &run)) == NULL)
+    return 0;
+if (run < n)
+    n = run;
+if ((p2 = cis_map (R[3], n, FALSE, &run)) == NULL)
+    return 0;
+if (run < n)
+    n = run;
+for (k = 0; (k < n) && (p1[k] == p2[k]); k++) ;
+R[0] = R[0] - k;                                        /* skip equal chars */
+R[1] = (R[1] + k) & 0177777;
+R[2] = R[2] - k;
+R[3] = (R[3] + k) & 0177777;
+return k;
+}
     
 /* Test for CIS mid-instruction interrupt */
 
@@ -1638,3 +1887,100 @@ while (cycles >= 0) {                                   /* until delay done */
     }                                                   /* end while delay */
 return FALSE;
 }
+
+/* Map string for direct access
+
+   Arguments:
+        va      =       data space address of first byte
+        max     =       bytes wanted
+        wr      =       TRUE for write access
+        run     =       pointer to number of bytes mapped (<= max)
+   Output       =       host pointer to the byte at va, or NULL
+
+   The string is mapped if the relocation cache has the page in memory
+   for this access, and memory bytes are stored in ascending order
+   (little-endian host).  The run stops at the end of the page.
+*/
+
+static uint8 *cis_map (int32 va, int32 max, t_bool wr, int32 *run)
+{
+uint32 pa;
+int32 n;
+
+if (!sim_end || (max <= 0))
+    return NULL;
+if ((n = reloc_cache_run ((va & 0177777) | dsenable, wr, &pa)) == 0)
+    return NULL;
+*run = (n < max)? n: max;
+return ((uint8 *) M) + pa;
+}
+
+/* Map the bytes below va, working down; returns a host pointer to the
+   byte at va - 1, and the number of bytes mapped below it, in *run */
+
+static uint8 *cis_map_dn (int32 va, int32 max, t_bool wr, int32 *run)
+{
+int32 n, r;
+uint8 *p;
+
+n = ((va - 1) & VA_DF) + 1;                             /* bytes in page */
+if (n > max)
+    n = max;
+if (((p = cis_map (va - n, n, wr, &r)) == NULL) || (r < n))
+    return NULL;
+*run = n;
+return p + n - 1;
+}
+
+/* Read and write decimal strings
+
+   The string is moved as a block if it is mapped; otherwise it is
+   accessed a byte at a time, from the high address down, as the digit
+   loops always did, so any abort happens at the same byte.
+*/
+
+static void cis_rdstr (int32 va, int32 lnt, uint8 *buf)
+{
+int32 i, run;
+uint8 *p;
+
+if ((p = cis_map (va, lnt, FALSE, &run)) && (run == lnt))
+    memcpy (buf, p, lnt);
+else {
+    for (i = lnt - 1; i >= 0; i--)
+        buf[i] = (uint8) ReadB (((va + i) & 0177777) | dsenable);
+    }
+return;
+}
+
+static void cis_wrstr (int32 va, int32 lnt, uint8 *buf)
+{
+int32 i, run;
+uint8 *p;
+
+if ((p = cis_map (va, lnt, TRUE, &run)) && (run == lnt))
+    memcpy (p, buf, lnt);
+else {
+    for (i = lnt - 1; i >= 0; i--)
+        WriteB (buf[i], ((va + i) & 0177777) | dsenable);
+    }
+return;
+}
+
+/* Fill string with character, a page at a time where possible */
+
+static void cis_fill (int32 va, int32 lnt, int32 c)
+{
+int32 i, run;
+uint8 *p;
+
+for (i = 0; i < lnt; i = i + run) {
+    if ((p = cis_map (va + i, lnt - i, TRUE, &run)))
+        memset (p, c & 0377, run);
+    else {
+        WriteB (c, ((va + i) & 0177777) | dsenable);
+        run = 1;
+        }
+    }
+return;
+}
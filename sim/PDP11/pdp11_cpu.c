@@ -269,6 +269,37 @@
 #define HIST_MAX        (1u << 18)
 #define HIST_VLD        1                               /* make PC odd */
 #define HIST_ILNT       4                               /* max inst length */
+#if defined (UC15)
+#define RC_MEMLIM       0                               /* no reloc cache */
+#else
+#define RC_MEMLIM       ((uint32) MEMSIZE)              /* reloc cache limit */
+#endif
+
+/* Instruction dispatch
+
+   With GCC/Clang, the instruction loop (pdp11_cpucore.h) dispatches
+   through a table of label addresses indexed by IR<15:6>, which jumps
+   directly to the handler for an opcode instead of going through the two
+   levels of switch statements.  The handlers are the switch cases
+   themselves; OP_LBL(x) marks the case that handles IR<15:6> = x.  Other
+   compilers use the switch statements.
+*/
+
+#if defined (__GNUC__) && !defined (DONT_USE_COMPUTED_GOTO)
+#define USE_OP_TAB      1
+#define OP_LBL(x)       op_##x:
+#define OP_ENT(x,t,o)   { 0##x, &&op_##x, t, o }
+#else
+#define OP_LBL(x)
+#endif
+
+typedef struct {
+    uint32      base;                                   /* pa of va<12:0> = 0 */
+    uint32      rlo;                                    /* first read offset */
+    uint32      rlen;                                   /* read range length */
+    uint32      wlo;                                    /* first write offset */
+    uint32      wlen;                                   /* write range length */
+    } RCENT;
 
 typedef struct {
     uint16              pc;
@@ -305,6 +336,7 @@ int32 FPS = 0;                                          /* fp status */
 int32 FEC = 0;                                          /* fp exception code */
 int32 FEA = 0;                                          /* fp exception addr */
 int32 APRFILE[64] = { 0 };                              /* PARs/PDRs */
+RCENT reloc_cache[64];                                  /* reloc cache */
 int32 MMR0 = 0;                                         /* MMR0 - status */
 int32 MMR1 = 0;                                         /* MMR1 - R+/-R */
 int32 MMR2 = 0;                                         /* MMR2 - saved PC */
@@ -348,6 +380,9 @@ void relocR_test (int32 va, int32 apridx);
 void relocW_test (int32 va, int32 apridx);
 int32 clean_MMR1 (int32 mmr1);
 t_bool PLF_test (int32 va, int32 apr);
+void reloc_cache_set (int32 apridx);
+void reloc_cache_all (void);
+int32 reloc_cache_run (int32 va, t_bool wr, uint32 *pa);
 void reloc_abort (int32 err, int32 apridx);
 int32 ReadE (int32 addr);
 int32 ReadW (int32 addr);
@@ -630,6 +665,8 @@ MTAB cpu_mod[] = {
     { MTAB_XTD|MTAB_VDV, OPT_MMU, NULL, "NOMMU", &cpu_clr_opt },
     { MTAB_XTD|MTAB_VDV, OPT_BVT, NULL, "BEVENT", &cpu_set_opt },
     { MTAB_XTD|MTAB_VDV, OPT_BVT, NULL, "NOBEVENT", &cpu_clr_opt },
+    { UNIT_HOSTFP, 0, NULL, "NOHOSTFP", NULL },
+    { UNIT_HOSTFP, UNIT_HOSTFP, "host FP", "HOSTFP", NULL },
     { UNIT_MSIZE, 16384, NULL, "16K", &cpu_set_size},
     { UNIT_MSIZE, 32768, NULL, "32K", &cpu_set_size},
     { UNIT_MSIZE, 49152, NULL, "48K", &cpu_set_size},
@@ -678,10 +715,35 @@ DEVICE cpu_dev = {
     NULL, &cpu_set_size, NULL
     };
 
+/* Instruction loop instances
+
+   pdp11_cpucore.h holds the instruction fetch/decode loop, and is
+   compiled once for each of several groups of CPU types.  sim_instr
+   restores the CPU state, runs the instance for the current model,
+   and saves the state when it returns.
+*/
+
+#if !defined (UC15)
+#define CORE_NAME       sim_instr_70                    /* 11/70 */
+#define CORE_TYPES      CPUT_70
+#include "pdp11_cpucore.h"
+
+#define CORE_NAME       sim_instr_j11                   /* J-11 systems */
+#define CORE_TYPES      CPUT_J
+#include "pdp11_cpucore.h"
+
+#define CORE_NAME       sim_instr_34                    /* 11/34 */
+#define CORE_TYPES      CPUT_34
+#include "pdp11_cpucore.h"
+#endif
+
+#define CORE_NAME       sim_instr_all                   /* everything else */
+#define CORE_TYPES      CPUT_ALL
+#include "pdp11_cpucore.h"
+
 t_stat sim_instr (void)
 {
-int abortval, i;
-volatile int32 trapea;                                  /* used by setjmp */
+int i;
 t_stat reason;
 
 /* Restore register state
@@ -700,6 +762,7 @@ if (MEMSIZE >= (cpu_tab[cpu_model].maxm - IOPAGESIZE))  /* mem size >= max - io
     MEMSIZE = cpu_tab[cpu_model].maxm - IOPAGESIZE;     /* max - io page */
 cpu_type = 1u << cpu_model;                             /* reset type mask */
 cpu_bme = (MMR3 & MMR3_BME) && (cpu_opt & OPT_UBM);     /* map enabled? */
+reloc_cache_all ();                                     /* APRs may have changed */
 PC = saved_PC;
 put_PSW (PSW, 0);                                       /* set PSW, call calc_xs */
 for (i = 0; i < 6; i++)
@@ -712,1457 +775,16 @@ STKLIM = STKLIM & STKLIM_RW;                            /* clean up STKLIM */
 MMR0 = MMR0 & ~MMR0_IC;                                 /* usually off */
 
 trap_req = calc_ints (ipl, trap_req);                   /* upd int req */
-trapea = 0;
-reason = 0;
-
-/* Abort handling
-
-   If an abort occurs in memory management or memory access, the lower
-   level routine executes a longjmp to this area OUTSIDE the main
-   simulation loop.  The longjmp specifies a trap mask which is OR'd
-   into the trap_req register.  Simulation then resumes at the fetch
-   phase, and the trap is sprung.
-
-   Aborts which occur within a trap sequence (trapea != 0) require
-   special handling.  If the abort occured on the stack pushes, and
-   the mode (encoded in trapea) is kernel, an "emergency" kernel
-   stack is created at 4, and a red zone stack trap taken.
-
-   All variables used in setjmp processing, or assumed to be valid
-   after setjmp, must be volatile or global.
-*/
-
-abortval = setjmp (save_env);                           /* set abort hdlr */
-if (abortval != 0) {
-    trap_req = trap_req | abortval;                     /* or in trap flag */
-    if ((trapea > 0) && stop_vecabort)
-        reason = STOP_VECABORT;
-    if ((trapea < 0) &&                                 /* stack push abort? */
-        (CPUT (STOP_STKA) || stop_spabort))
-        reason = STOP_SPABORT;
-    if (trapea == ~MD_KER) {                            /* kernel stk abort? */
-        trap_req = trap_req & ~trap_clear[TRAP_RED];    /* clear all traps */
-        setTRAP (TRAP_RED);                             /* set red stack trap */
-        setCPUERR (CPUE_RED);
-        STACKFILE[MD_KER] = 4;
-        if (cm == MD_KER)
-            SP = 4;
-        }
-    }
-
-/* Main instruction fetch/decode loop
-
-   Check for traps or interrupts.  If trap, locate the vector and check
-   for stop condition.  If interrupt, locate the vector.
-*/ 
-
-while (reason == 0)  {
-
-    int32 IR, srcspec, srcreg, dstspec, dstreg;
-    int32 src, src2, dst, pa;
-    int32 i, t, sign, oldrs, trapnum;
-
-    if (cpu_astop) {
-        cpu_astop = 0;
-        reason = SCPE_STOP;
-        break;
-        }
-
-    if (sim_interval <= 0) {                            /* intv cnt expired? */
-        reason = sim_process_event ();                  /* process events */
-        trap_req = calc_ints (ipl, trap_req);           /* recalc int req */
-        continue;
-        }                                               /* end if sim_interval */
-
-    if (trap_req) {                                     /* check traps, ints */
-        trapea = 0;                                     /* assume srch fails */
-        if ((t = trap_req & TRAP_ALL)) {                /* if a trap */
-            for (trapnum = 0; trapnum < TRAP_V_MAX; trapnum++) {
-                if ((t >> trapnum) & 1) {               /* trap set? */
-                    trapea = trap_vec[trapnum];         /* get vec, clr */
-                    trap_req = trap_req & ~trap_clear[trapnum];
-                    if ((stop_trap >> trapnum) & 1)     /* stop on trap? */
-                        reason = trapnum + 1;
-                    break;
-                    }                                   /* end if t & 1 */
-                }                                       /* end for */
-            }                                           /* end if t */
-        else {
-            trapea = get_vector (ipl);                  /* get int vector */
-            trapnum = TRAP_V_MAX;                       /* defang stk trap */
-            }                                           /* end else t */
-        if (trapea == 0) {                              /* nothing to do? */
-            trap_req = calc_ints (ipl, 0);              /* recalculate */
-            continue;                                   /* back to fetch */
-            }                                           /* end if trapea */
-
-/* Process a trap or interrupt
-
-   1. Exit wait state
-   2. Save the current SP and PSW
-   3. Read the new PC, new PSW from trapea, kernel data space
-   4. Get the mode and stack selected by the new PSW
-   5. Push the old PC and PSW on the new stack
-   6. Update SP, PSW, and PC
-   7. If not stack overflow, check for stack overflow
-
-   If the MMU registers are not frozen, the 11/45 and 11/70 will
-   also clear MMR1 and store the trap vector in MMR2, <except>
-   for the four instruction traps (EMT, TRAP, IOT, BPT).
-*/
-
-        wait_state = 0;                                 /* exit wait state */
-        STACKFILE[cm] = SP;
-        PSW = get_PSW ();                               /* assemble PSW */
-        oldrs = rs;
-        if ((CPUT (HAS_MMTR)) && (update_MM)) {         /* 45,70, not frozen? */
-            MMR1 = 0;                                   /* clear MMR1 */
-            if (trap_load_mmr2[trapnum])                /* load MMR2? */
-                MMR2 = trapea;                          /* save vector */
-            }
-        src = ReadW (trapea | calc_ds (MD_KER));        /* new PC */
-        src2 = ReadW ((trapea + 2) | calc_ds (MD_KER)); /* new PSW */
-        t = (src2 >> PSW_V_CM) & 03;                    /* new cm */
-        trapea = ~t;                                    /* flag pushes */
-        WriteW (PSW, ((STACKFILE[t] - 2) & 0177777) | calc_ds (t));
-        WriteW (PC, ((STACKFILE[t] - 4) & 0177777) | calc_ds (t));
-        trapea = 0;                                     /* clear trap flag */
-        src2 = (src2 & ~PSW_PM) | (cm << PSW_V_PM);     /* insert prv mode */
-        put_PSW (src2, 0);                              /* call calc_is,ds */
-        if (rs != oldrs) {                              /* if rs chg, swap */
-            for (i = 0; i < 6; i++) {
-                REGFILE[i][oldrs] = R[i];
-                R[i] = REGFILE[i][rs];
-                }
-            }
-        SP = (STACKFILE[cm] - 4) & 0177777;             /* update SP, PC */
-        isenable = calc_is (cm);
-        dsenable = calc_ds (cm);
-        trap_req = calc_ints (ipl, trap_req);
-        JMP_PC (src);
-        if ((cm == MD_KER) && (SP < (STKLIM + STKL_Y)) &&
-            (trapnum != TRAP_V_RED) && (trapnum != TRAP_V_YEL))
-            set_stack_trap (SP);
-        if (tbit)                                       /* tbit now set? */
-            setTRAP (TRAP_TRC);                         /* immediate trap */
-        continue;                                       /* end if traps */
-        }
-
-/* Fetch and decode next instruction */
-
-    if (tbit)
-        setTRAP (TRAP_TRC);
-    if (wait_state) {                                   /* wait state? */
-        sim_idle (TMR_CLK, TRUE);
-        continue;
-        }
-
-    if (sim_brk_summ && sim_brk_test (PC, SWMASK ('E'))) { /* breakpoint? */
-        reason = STOP_IBKPT;                            /* stop simulation */
-        continue;
-        }
-
-    if (update_MM) {                                    /* if mm not frozen */
-        MMR1 = 0;
-        MMR2 = PC;
-        }
-    IR = ReadE (PC | isenable);                         /* fetch instruction */
-    sim_interval = sim_interval - 1;
-    srcspec = (IR >> 6) & 077;                          /* src, dst specs */
-    dstspec = IR & 077;
-    srcreg = (srcspec <= 07);                           /* src, dst = rmode? */
-    dstreg = (dstspec <= 07);
-    if (hst_lnt) {                                      /* record history? */
-        t_value val;
-        uint32 i;
-        static int32 swmap[4] = {
-            SWMASK ('K') | SWMASK ('V'), SWMASK ('S') | SWMASK ('V'),
-            SWMASK ('U') | SWMASK ('V'), SWMASK ('U') | SWMASK ('V')
-            };
-        hst[hst_p].pc = PC | HIST_VLD;
-        hst[hst_p].sp = SP;
-        hst[hst_p].psw = get_PSW ();
-        hst[hst_p].src = R[srcspec & 07];
-        hst[hst_p].dst = R[dstspec & 07];
-        hst[hst_p].inst[0] = IR;
-        for (i = 1; i < HIST_ILNT; i++) {
-            if (cpu_ex (&val, (PC + (i << 1)) & 0177777, &cpu_unit, swmap[cm & 03]))
-                hst[hst_p].inst[i] = 0;
-            else hst[hst_p].inst[i] = (uint16) val;
-            }
-        hst_p = (hst_p + 1);
-        if (hst_p >= hst_lnt)
-            hst_p = 0;
-        }
-    PC = (PC + 2) & 0177777;                            /* incr PC, mod 65k */
-    switch ((IR >> 12) & 017) {                         /* decode IR<15:12> */
-
-/* Opcode 0: no operands, specials, branches, JSR, SOPs */
-
-    case 000:
-        switch ((IR >> 6) & 077) {                      /* decode IR<11:6> */
-        case 000:                                       /* no operand */
-            if (IR >= 000010) {                         /* 000010 - 000077 */
-                setTRAP (TRAP_ILL);                     /* illegal */
-                break;
-                }
-            switch (IR) {                               /* decode IR<2:0> */
-            case 0:                                     /* HALT */
-                if ((cm == MD_KER) &&
-                    (!CPUT (CPUT_J) || ((MAINT & MAINT_HTRAP) == 0)))
-                    reason = STOP_HALT;
-                else if (CPUT (HAS_HALT4)) {            /* priv trap? */
-                    setTRAP (TRAP_PRV);
-                    setCPUERR (CPUE_HALT);
-                    }
-                else setTRAP (TRAP_ILL);                /* no, ill inst */
-                break;
-            case 1:                                     /* WAIT */
-                wait_state = 1;
-                break;
-            case 3:                                     /* BPT */
-                setTRAP (TRAP_BPT);
-                break;
-            case 4:                                     /* IOT */
-                setTRAP (TRAP_IOT);
-                break;
-            case 5:                                     /* RESET */
-                if (cm == MD_KER) {
-                    reset_all (2);                      /* skip CPU, sys reg */
-                    PIRQ = 0;                           /* clear PIRQ */
-                    STKLIM = 0;                         /* clear STKLIM */
-                    MMR0 = 0;                           /* clear MMR0 */
-                    MMR3 = 0;                           /* clear MMR3 */
-                    cpu_bme = 0;                        /* (also clear bme) */
-                    for (i = 0; i < IPL_HLVL; i++)
-                        int_req[i] = 0;
-                    trap_req = trap_req & ~TRAP_INT;
-                    dsenable = calc_ds (cm);
-                    }
-                break;
-            case 6:                                     /* RTT */
-                if (!CPUT (HAS_RTT)) {
-                    setTRAP (TRAP_ILL);
-                    break;
-                    }
-            case 2:                                     /* RTI */
-                src = ReadW (SP | dsenable);
-                src2 = ReadW (((SP + 2) & 0177777) | dsenable);
-                STACKFILE[cm] = SP = (SP + 4) & 0177777;
-                oldrs = rs;
-                put_PSW (src2, (cm != MD_KER));         /* store PSW, prot */
-                if (rs != oldrs) {
-                    for (i = 0; i < 6; i++) {
-                        REGFILE[i][oldrs] = R[i];
-                        R[i] = REGFILE[i][rs];
-                        }
-                    }
-                SP = STACKFILE[cm];
-                isenable = calc_is (cm);
-                dsenable = calc_ds (cm);
-                trap_req = calc_ints (ipl, trap_req);
-                JMP_PC (src);
-                if (CPUT (HAS_RTT) && tbit &&           /* RTT impl? */
-                    (IR == 000002))
-                    setTRAP (TRAP_TRC);                 /* RTI immed trap */
-                else trap_req = trap_req & ~TRAP_TRC;   /* no trace trap */
-                break;
-            case 7:                                     /* MFPT */
-                if (CPUT (HAS_MFPT))                    /* implemented? */
-                    R[0] = cpu_tab[cpu_model].mfpt;     /* get type */
-                else setTRAP (TRAP_ILL);
-                break;
-                }                                       /* end switch no ops */
-            break;                                      /* end case no ops */
-
-        case 001:                                       /* JMP */
-            if (dstreg)
-                setTRAP (CPUT (HAS_JREG4)? TRAP_PRV: TRAP_ILL);
-            else {
-                dst = GeteaW (dstspec) & 0177777;       /* get eff addr */
-                if (CPUT (CPUT_05|CPUT_20) &&           /* 11/05, 11/20 */
-                    ((dstspec & 070) == 020))           /* JMP (R)+? */
-                    dst = R[dstspec & 07];              /* use post incr */
-                JMP_PC (dst);
-                }
-            break;                                      /* end JMP */
-
-        case 002:                                       /* RTS et al*/
-            if (IR < 000210) {                          /* RTS */
-                dstspec = dstspec & 07;
-                JMP_PC (R[dstspec]);
-                R[dstspec] = ReadW (SP | dsenable);
-                if (dstspec != 6)
-                    SP = (SP + 2) & 0177777;
-                break;
-                }                                       /* end if RTS */
-            if (IR < 000230) {
-                setTRAP (TRAP_ILL);
-                break;
-                }
-            if (IR < 000240) {                          /* SPL */
-                if (CPUT (HAS_SPL)) {
-                    if (cm == MD_KER)
-                        ipl = IR & 07;
-                    trap_req = calc_ints (ipl, trap_req);
-                    }
-                else setTRAP (TRAP_ILL);
-                break;
-                }                                       /* end if SPL */
-            if (IR < 000260) {                          /* clear CC */
-                if (IR & 010)
-                    N = 0;
-                if (IR & 004)
-                    Z = 0;
-                if (IR & 002)
-                    V = 0;
-                if (IR & 001)
-                    C = 0;
-                break;
-                }                                       /* end if clear CCs */
-            if (IR & 010)                               /* set CC */
-                N = 1;
-            if (IR & 004)
-                Z = 1;
-            if (IR & 002)
-                V = 1;
-            if (IR & 001)
-                C = 1;
-            break;                                      /* end case RTS et al */
-
-        case 003:                                       /* SWAB */
-            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = ((dst & 0377) << 8) | ((dst >> 8) & 0377);
-            N = GET_SIGN_B (dst & 0377);
-            Z = GET_Z (dst & 0377);
-            if (!CPUT (CPUT_20))
-                V = 0;
-            C = 0;
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;                                      /* end SWAB */
-
-        case 004: case 005:                             /* BR */
-            BRANCH_F (IR);
-            break;
-
-        case 006: case 007:                             /* BR */
-            BRANCH_B (IR);
-            break;
-
-        case 010: case 011:                             /* BNE */
-            if (Z == 0) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 012: case 013:                             /* BNE */
-            if (Z == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 014: case 015:                             /* BEQ */
-            if (Z) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 016: case 017:                             /* BEQ */
-            if (Z) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 020: case 021:                             /* BGE */
-            if ((N ^ V) == 0) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 022: case 023:                             /* BGE */
-            if ((N ^ V) == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 024: case 025:                             /* BLT */
-            if (N ^ V) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 026: case 027:                             /* BLT */
-            if (N ^ V) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 030: case 031:                             /* BGT */
-            if ((Z | (N ^ V)) == 0) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 032: case 033:                             /* BGT */
-            if ((Z | (N ^ V)) == 0) { BRANCH_B (IR); }
-            break;
-
-        case 034: case 035:                             /* BLE */
-            if (Z | (N ^ V)) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 036: case 037:                             /* BLE */
-            if (Z | (N ^ V)) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 040: case 041: case 042: case 043:         /* JSR */
-        case 044: case 045: case 046: case 047:
-            if (dstreg)
-                setTRAP (CPUT (HAS_JREG4)? TRAP_PRV: TRAP_ILL);
-            else {
-                srcspec = srcspec & 07;
-                dst = GeteaW (dstspec);
-                if (CPUT (CPUT_05|CPUT_20) &&           /* 11/05, 11/20 */
-                    ((dstspec & 070) == 020))           /* JSR (R)+? */
-                    dst = R[dstspec & 07];              /* use post incr */
-                SP = (SP - 2) & 0177777;
-                if (update_MM)
-                    MMR1 = calc_MMR1 (0366);
-                if ((cm == MD_KER) && (SP < (STKLIM + STKL_Y)))
-                    set_stack_trap (SP);
-                WriteW (R[srcspec], SP | dsenable);
-                R[srcspec] = PC;
-                JMP_PC (dst & 0177777);
-                }
-            break;                                      /* end JSR */
-
-        case 050:                                       /* CLR */
-            if (!dstreg)                                /* not reg? */
-                pa = TestMW (GeteaW (dstspec));         /* relocate */
-            N = V = C = 0;                              /* now set CC's */
-            Z = 1;
-            if (dstreg)
-                R[dstspec] = 0;
-            else PWriteW (0, pa);
-            break;
-
-        case 051:                                       /* COM */
-            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = dst ^ 0177777;
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            V = 0;
-            C = 1;
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-        case 052:                                       /* INC */
-            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = (dst + 1) & 0177777;
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            V = (dst == 0100000);
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-        case 053:                                       /* DEC */
-            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = (dst - 1) & 0177777;
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            V = (dst == 077777);
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-        case 054:                                       /* NEG */
-            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = (-dst) & 0177777;
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            V = (dst == 0100000);
-            C = Z ^ 1;
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-        case 055:                                       /* ADC */
-            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = (dst + C) & 0177777;
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            V = (C && (dst == 0100000));
-            C = C & Z;
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-        case 056:                                       /* SBC */
-            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = (dst - C) & 0177777;
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            V = (C && (dst == 077777));
-            C = (C && (dst == 0177777));
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-        case 057:                                       /* TST */
-            dst = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            V = C = 0;
-            break;
-
-        case 060:                                       /* ROR */
-            src = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = (src >> 1) | (C << 15);
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            C = (src & 1);
-            V = N ^ C;
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-        case 061:                                       /* ROL */
-            src = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = ((src << 1) | C) & 0177777;
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            C = GET_SIGN_W (src);
-            V = N ^ C;
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-        case 062:                                       /* ASR */
-            src = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = (src >> 1) | (src & 0100000);
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            C = (src & 1);
-            V = N ^ C;
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-        case 063:                                       /* ASL */
-            src = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            dst = (src << 1) & 0177777;
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            C = GET_SIGN_W (src);
-            V = N ^ C;
-            if (dstreg)
-                R[dstspec] = dst;
-            else PWriteW (dst, last_pa);
-            break;
-
-/* Notes:
-   - MxPI must mask GeteaW returned address to force ispace
-   - MxPI must set MMR1 for SP recovery in case of fault
-*/
-
-        case 064:                                       /* MARK */
-            if (CPUT (HAS_MARK)) {
-                i = (PC + dstspec + dstspec) & 0177777;
-                JMP_PC (R[5]);
-                R[5] = ReadW (i | dsenable);
-                SP = (i + 2) & 0177777;
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 065:                                       /* MFPI */
-            if (CPUT (HAS_MXPY)) {
-                if (dstreg) {
-                    if ((dstspec == 6) && (cm != pm))
-                        dst = STACKFILE[pm];
-                    else dst = R[dstspec];
-                    }
-                else {
-                    i = ((cm == pm) && (cm == MD_USR))? (int32)calc_ds (pm): (int32)calc_is (pm);
-                    dst = ReadW ((GeteaW (dstspec) & 0177777) | i);
-                    }
-                SP = (SP - 2) & 0177777;
-                if (update_MM)
-                    MMR1 = calc_MMR1 (0366);
-                if ((cm == MD_KER) && (SP < (STKLIM + STKL_Y)))
-                    set_stack_trap (SP);
-                pa = TestMW (SP | dsenable);        /* relocate SP */
-                N = GET_SIGN_W (dst);               /* now update CC's */
-                Z = GET_Z (dst);
-                V = 0;
-                PWriteW (dst, pa);
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 066:                                       /* MTPI */
-            if (CPUT (HAS_MXPY)) {
-                dst = ReadW (SP | dsenable);
-                SP = (SP + 2) & 0177777;
-                if (update_MM)
-                    MMR1 = 026;
-                if (!dstreg)
-                    pa = TestMW ((GeteaW (dstspec) & 0177777) | calc_is (pm));
-                N = GET_SIGN_W (dst);                   /* now update CCs */
-                Z = GET_Z (dst);
-                V = 0;
-                if (dstreg) {
-                    if ((dstspec == 6) && (cm != pm))
-                        STACKFILE[pm] = dst;
-                    else R[dstspec] = dst;
-                    }
-                else PWriteW (dst, pa);
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 067:                                       /* SXT */
-            if (CPUT (HAS_SXS)) {
-                if (!dstreg)
-                    pa = TestMW (GeteaW (dstspec));
-                dst = N? 0177777: 0;                    /* now update CCs */
-                Z = N ^ 1;
-                V = 0;
-                if (dstreg)
-                    R[dstspec] = dst;
-                else PWriteW (dst, pa);
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 070:                                       /* CSM */
-            if (CPUT (HAS_CSM) && (MMR3 & MMR3_CSM) && (cm != MD_KER)) {
-                dst = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-                PSW = get_PSW () & ~PSW_CC;             /* PSW, cc = 0 */
-                STACKFILE[cm] = SP;
-                WriteW (PSW, ((SP - 2) & 0177777) | calc_ds (MD_SUP));
-                WriteW (PC, ((SP - 4) & 0177777) | calc_ds (MD_SUP));
-                WriteW (dst, ((SP - 6) & 0177777) | calc_ds (MD_SUP));
-                SP = (SP - 6) & 0177777;
-                pm = cm;
-                cm = MD_SUP;
-                tbit = 0;
-                isenable = calc_is (cm);
-                dsenable = calc_ds (cm);
-                PC = ReadW (010 | isenable);
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 072:                                       /* TSTSET */
-            if (CPUT (HAS_TSWLK) && !dstreg) {
-                dst = ReadMW (GeteaW (dstspec));
-                N = GET_SIGN_W (dst);
-                Z = GET_Z (dst);
-                V = 0;
-                C = (dst & 1);
-                R[0] = dst;                             /* R[0] <- dst */
-                PWriteW (R[0] | 1, last_pa);            /* dst <- R[0] | 1 */
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 073:                                       /* WRTLCK */
-            if (CPUT (HAS_TSWLK) && !dstreg) {
-                dst = ReadMW (GeteaW (dstspec));        /* data thrown away */
-                N = GET_SIGN_W (R[0]);
-                Z = GET_Z (R[0]);
-                V = 0;
-                PWriteW (R[0], last_pa);                /* dst <- R[0] */
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        default:
-            setTRAP (TRAP_ILL);
-            break;
-            }                                           /* end switch SOPs */
-        break;                                          /* end case 000 */
-
-/* Opcodes 01 - 06: double operand word instructions
-
-   J-11 (and F-11) optimize away register source operand decoding.
-   As a result, dop R,+/-(R) use the modified version of R as source.
-   Most (but not all) other PDP-11's fetch the source operand before
-   any destination operand decoding.
-
-   Add: v = [sign (src) = sign (src2)] and [sign (src) != sign (result)]
-   Cmp: v = [sign (src) != sign (src2)] and [sign (src2) = sign (result)]
-*/
-
-    case 001:                                           /* MOV */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            pa = TestMW (GeteaW (dstspec));             /* reloc dest */
-            dst = R[srcspec];
-            }
-        else {
-            dst = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            if (!dstreg)
-                pa = TestMW (GeteaW (dstspec));
-            }
-        N = GET_SIGN_W (dst);                           /* now update CCs */
-        Z = GET_Z (dst);
-        V = 0;
-        if (dstreg)
-            R[dstspec] = dst;
-        else PWriteW (dst, pa);
-        break;
-
-    case 002:                                           /* CMP */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-            }
-        dst = (src - src2) & 0177777;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = GET_SIGN_W ((src ^ src2) & (~src2 ^ dst));
-        C = (src < src2);
-        break;
-
-    case 003:                                           /* BIT */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-            }
-        dst = src2 & src;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        break;
-
-    case 004:                                           /* BIC */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            }
-        dst = src2 & ~src;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        if (dstreg)
-            R[dstspec] = dst;
-        else PWriteW (dst, last_pa);
-        break;
-
-    case 005:                                           /* BIS */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            }
-        dst = src2 | src;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        if (dstreg)
-            R[dstspec] = dst;
-        else PWriteW (dst, last_pa);
-        break;
-
-    case 006:                                           /* ADD */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            }
-        dst = (src2 + src) & 0177777;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = GET_SIGN_W ((~src ^ src2) & (src ^ dst));
-        C = (dst < src);
-        if (dstreg)
-            R[dstspec] = dst;
-        else PWriteW (dst, last_pa);
-        break;
-
-/* Opcode 07: EIS, FIS, CIS
-
-   Notes:
-   - The code assumes that the host int length is at least 32 bits.
-   - MUL carry: C is set if the (signed) result doesn't fit in 16 bits.
-   - Divide has three error cases:
-        1. Divide by zero.
-        2. Divide largest negative number by -1.
-        3. (Signed) quotient doesn't fit in 16 bits.
-     Cases 1 and 2 must be tested in advance, to avoid C runtime errors.
-   - ASHx left: overflow if the bits shifted out do not equal the sign
-     of the result (convert shift out to 1/0, xor against sign).
-   - ASHx right: if right shift sign extends, then the shift and
-     conditional or of shifted -1 is redundant.  If right shift zero
-     extends, then the shift and conditional or does sign extension.
-*/
-
-    case 007:
-        srcspec = srcspec & 07;
-        switch ((IR >> 9) & 07)  {                      /* decode IR<11:9> */
-
-        case 0:                                         /* MUL */
-            if (!CPUO (OPT_EIS)) {
-                setTRAP (TRAP_ILL);
-                break;
-                }
-            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-            src = R[srcspec];
-            if (GET_SIGN_W (src2))
-                src2 = src2 | ~077777;
-            if (GET_SIGN_W (src))
-                src = src | ~077777;
-            dst = src * src2;
-            R[srcspec] = (dst >> 16) & 0177777;
-            R[srcspec | 1] = dst & 0177777;
-            N = (dst < 0);
-            Z = GET_Z (dst);
-            V = 0;
-            C = ((dst > 077777) || (dst < -0100000));
-            break;
-
-        case 1:                                         /* DIV */
-            if (!CPUO (OPT_EIS)) {
-                setTRAP (TRAP_ILL);
-                break;
-                }
-            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-            src = (((uint32) R[srcspec]) << 16) | R[srcspec | 1];
-            if (src2 == 0) {
-                N = 0;                                  /* J11,11/70 compat */
-                Z = V = C = 1;                          /* N = 0, Z = 1 */
-                break;
-                }
-            if ((((uint32)src) == 020000000000) && (src2 == 0177777)) {
-                V = 1;                                  /* V = 1 */
-                N = Z = C = 0;                          /* N = Z = 0 */
-                break;
-                }
-            if (GET_SIGN_W (src2))
-                src2 = src2 | ~077777;
-            if (GET_SIGN_W (R[srcspec]))
-                src = src | ~017777777777;
-            dst = src / src2;
-            N = (dst < 0);                              /* N set on 32b result */
-            if ((dst > 077777) || (dst < -0100000)) {
-                V = 1;                                  /* V = 1 */
-                Z = C = 0;                              /* Z = C = 0 */
-                break;
-                }
-            R[srcspec] = dst & 0177777;
-            R[srcspec | 1] = (src - (src2 * dst)) & 0177777;
-            Z = GET_Z (dst);
-            V = C = 0;
-            break;
-
-        case 2:                                         /* ASH */
-            if (!CPUO (OPT_EIS)) {
-                setTRAP (TRAP_ILL);
-                break;
-                }
-            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-            src2 = src2 & 077;
-            sign = GET_SIGN_W (R[srcspec]);
-            src = sign? R[srcspec] | ~077777: R[srcspec];
-            if (src2 == 0) {                            /* [0] */
-                dst = src;
-                V = C = 0;
-                }
-            else if (src2 <= 15) {                      /* [1,15] */
-                dst = src << src2;
-                i = (src >> (16 - src2)) & 0177777;
-                V = (i != ((dst & 0100000)? 0177777: 0));
-                C = (i & 1);
-                }
-            else if (src2 <= 31) {                      /* [16,31] */
-                dst = 0;
-                V = (src != 0);
-                C = (src << (src2 - 16)) & 1;
-                }
-            else if (src2 == 32) {                      /* [32] = -32 */
-                dst = -sign;
-                V = 0;
-                C = sign;
-                }
-            else {                                      /* [33,63] = -31,-1 */
-                dst = (src >> (64 - src2)) | (-sign << (src2 - 32));
-                V = 0;
-                C = ((src >> (63 - src2)) & 1);
-                }
-            dst = R[srcspec] = dst & 0177777;
-            N = GET_SIGN_W (dst);
-            Z = GET_Z (dst);
-            break;
-
-        case 3:                                         /* ASHC */
-            if (!CPUO (OPT_EIS)) {
-                setTRAP (TRAP_ILL);
-                break;
-                }
-            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-            src2 = src2 & 077;
-            sign = GET_SIGN_W (R[srcspec]);
-            src = (((uint32) R[srcspec]) << 16) | R[srcspec | 1];
-            if (src2 == 0) {                            /* [0] */
-                dst = src;
-                V = C = 0;
-                }
-            else if (src2 <= 31) {                      /* [1,31] */
-                dst = ((uint32) src) << src2;
-                i = (src >> (32 - src2)) | (-sign << src2);
-                V = (i != ((dst & 020000000000)? -1: 0));
-                C = (i & 1);
-                }
-            else if (src2 == 32) {                      /* [32] = -32 */
-                dst = -sign;
-                V = 0;
-                C = sign;
-                }
-            else {                                      /* [33,63] = -31,-1 */
-                dst = (src >> (64 - src2)) | (-sign << (src2 - 32));
-                V = 0;
-                C = ((src >> (63 - src2)) & 1);
-                }
-            i = R[srcspec] = (dst >> 16) & 0177777;
-            dst = R[srcspec | 1] = dst & 0177777;
-            N = GET_SIGN_W (i);
-            Z = GET_Z (dst | i);
-            break;
-
-        case 4:                                         /* XOR */
-            if (CPUT (HAS_SXS)) {
-                if (CPUT (IS_SDSD) && !dstreg) {        /* R,not R */
-                    src2 = ReadMW (GeteaW (dstspec));
-                    src = R[srcspec];
-                    }
-                else {
-                    src = R[srcspec];
-                    src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-                    }
-                dst = src ^ src2;
-                N = GET_SIGN_W (dst);
-                Z = GET_Z (dst);
-                V = 0;
-                if (dstreg)
-                    R[dstspec] = dst;
-                else PWriteW (dst, last_pa);
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 5:                                         /* FIS */
-            if (CPUO (OPT_FIS))
-                fis11 (IR);
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 6:                                         /* CIS */
-            if (CPUT (CPUT_60) && (cm == MD_KER) &&     /* 11/60 MED? */
-                (IR == 076600)) {
-                ReadE (PC | isenable);                  /* read immediate */
-                PC = (PC + 2) & 0177777;
-                }
-            else if (CPUO (OPT_CIS))                    /* CIS option? */
-                reason = cis11 (IR);
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 7:                                         /* SOB */
-            if (CPUT (HAS_SXS)) {
-                R[srcspec] = (R[srcspec] - 1) & 0177777;
-                if (R[srcspec]) {
-                    JMP_PC ((PC - dstspec - dstspec) & 0177777);
-                    }
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-            }                                           /* end switch EIS */
-        break;                                          /* end case 007 */
-
-/* Opcode 10: branches, traps, SOPs */
-
-    case 010:
-        switch ((IR >> 6) & 077) {                      /* decode IR<11:6> */
-
-        case 000: case 001:                             /* BPL */
-            if (N == 0) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 002: case 003:                             /* BPL */
-            if (N == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 004: case 005:                             /* BMI */
-            if (N) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 006: case 007:                             /* BMI */
-            if (N) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 010: case 011:                             /* BHI */
-            if ((C | Z) == 0) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 012: case 013:                             /* BHI */
-            if ((C | Z) == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 014: case 015:                             /* BLOS */
-            if (C | Z) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 016: case 017:                             /* BLOS */
-            if (C | Z) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 020: case 021:                             /* BVC */
-            if (V == 0) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 022: case 023:                             /* BVC */
-            if (V == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 024: case 025:                             /* BVS */
-            if (V) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 026: case 027:                             /* BVS */
-            if (V) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 030: case 031:                             /* BCC */
-            if (C == 0) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 032: case 033:                             /* BCC */
-            if (C == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 034: case 035:                             /* BCS */
-            if (C) {
-                BRANCH_F (IR);
-                } 
-            break;
-
-        case 036: case 037:                             /* BCS */
-            if (C) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 040: case 041: case 042: case 043:         /* EMT */
-            setTRAP (TRAP_EMT);
-            break;
-
-        case 044: case 045: case 046: case 047:         /* TRAP */
-            setTRAP (TRAP_TRAP);
-            break;
-
-        case 050:                                       /* CLRB */
-            if (!dstreg)
-                pa = TestMB (GeteaB (dstspec));
-            N = V = C = 0;                              /* now update CCs */
-            Z = 1;
-            if (dstreg)
-                R[dstspec] = R[dstspec] & 0177400;
-            else PWriteB (0, pa);
-            break;
-
-        case 051:                                       /* COMB */
-            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = (dst ^ 0377) & 0377;
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            V = 0;
-            C = 1;
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-        case 052:                                       /* INCB */
-            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = (dst + 1) & 0377;
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            V = (dst == 0200);
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-        case 053:                                       /* DECB */
-            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = (dst - 1) & 0377;
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            V = (dst == 0177);
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-        case 054:                                       /* NEGB */
-            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = (-dst) & 0377;
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            V = (dst == 0200);
-            C = (Z ^ 1);
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-        case 055:                                       /* ADCB */
-            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = (dst + C) & 0377;
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            V = (C && (dst == 0200));
-            C = C & Z;
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-        case 056:                                       /* SBCB */
-            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = (dst - C) & 0377;
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            V = (C && (dst == 0177));
-            C = (C && (dst == 0377));
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-        case 057:                                       /* TSTB */
-            dst = dstreg? R[dstspec] & 0377: ReadB (GeteaB (dstspec));
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            V = C = 0;
-            break;
-
-        case 060:                                       /* RORB */
-            src = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = ((src & 0377) >> 1) | (C << 7);
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            C = (src & 1);
-            V = N ^ C;
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-        case 061:                                       /* ROLB */
-            src = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = ((src << 1) | C) & 0377;
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            C = GET_SIGN_B (src & 0377);
-            V = N ^ C;
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-        case 062:                                       /* ASRB */
-            src = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = ((src & 0377) >> 1) | (src & 0200);
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            C = (src & 1);
-            V = N ^ C;
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-        case 063:                                       /* ASLB */
-            src = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            dst = (src << 1) & 0377;
-            N = GET_SIGN_B (dst);
-            Z = GET_Z (dst);
-            C = GET_SIGN_B (src & 0377);
-            V = N ^ C;
-            if (dstreg)
-                R[dstspec] = (R[dstspec] & 0177400) | dst;
-            else PWriteB (dst, last_pa);
-            break;
-
-/* Notes:
-   - MTPS cannot alter the T bit
-   - MxPD must mask GeteaW returned address, dspace is from cm not pm
-   - MxPD must set MMR1 for SP recovery in case of fault
-*/
-
-        case 064:                                       /* MTPS */
-            if (CPUT (HAS_MXPS)) {
-                dst = dstreg? R[dstspec]: ReadB (GeteaB (dstspec));
-                if (cm == MD_KER) {
-                    ipl = (dst >> PSW_V_IPL) & 07;
-                    trap_req = calc_ints (ipl, trap_req);
-                    }
-                N = (dst >> PSW_V_N) & 01;
-                Z = (dst >> PSW_V_Z) & 01;
-                V = (dst >> PSW_V_V) & 01;
-                C = (dst >> PSW_V_C) & 01;
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 065:                                       /* MFPD */
-            if (CPUT (HAS_MXPY)) {
-                if (dstreg) {
-                    if ((dstspec == 6) && (cm != pm))
-                        dst = STACKFILE[pm];
-                    else dst = R[dstspec];
-                    }
-                else dst = ReadW ((GeteaW (dstspec) & 0177777) | calc_ds (pm));
-                SP = (SP - 2) & 0177777;
-                if (update_MM)
-                    MMR1 = calc_MMR1 (0366);
-                if ((cm == MD_KER) && (SP < (STKLIM + STKL_Y)))
-                    set_stack_trap (SP);
-                pa = TestMW (SP | dsenable);
-                N = GET_SIGN_W (dst);                   /* now update CCs */
-                Z = GET_Z (dst);
-                V = 0;
-                PWriteW (dst, pa);
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 066:                                       /* MTPD */
-            if (CPUT (HAS_MXPY)) {
-                dst = ReadW (SP | dsenable);
-                SP = (SP + 2) & 0177777;
-                if (update_MM)
-                    MMR1 = 026;
-                if (!dstreg)
-                    pa = TestMW ((GeteaW (dstspec) & 0177777) | calc_ds (pm));
-                N = GET_SIGN_W (dst);                   /* now set CCs */
-                Z = GET_Z (dst);
-                V = 0;
-               if (dstreg) {
-                    if ((dstspec == 6) && (cm != pm))
-                        STACKFILE[pm] = dst;
-                    else R[dstspec] = dst;
-                    }
-               else PWriteW (dst, pa);
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        case 067:                                       /* MFPS */
-            if (CPUT (HAS_MXPS)) {
-                dst = get_PSW () & 0377;
-                if (!dstreg)
-                    pa = TestMB (GeteaB (dstspec));
-                N = GET_SIGN_B (dst);
-                Z = GET_Z (dst);
-                V = 0;
-                if (dstreg)
-                    R[dstspec] = (dst & 0200)? 0177400 | dst: dst;
-                else PWriteB (dst, pa);
-                }
-            else setTRAP (TRAP_ILL);
-            break;
-
-        default:
-            setTRAP (TRAP_ILL);
-            break;
-            }                                           /* end switch SOPs */
-        break;                                          /* end case 010 */
-
-/* Opcodes 11 - 16: double operand byte instructions
-
-   Cmp: v = [sign (src) != sign (src2)] and [sign (src2) = sign (result)]
-   Sub: v = [sign (src) != sign (src2)] and [sign (src) = sign (result)]
-*/
-
-    case 011:                                           /* MOVB */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            pa = TestMB (GeteaB (dstspec));
-            dst = R[srcspec] & 0377;
-            }
-        else {
-            dst = srcreg? R[srcspec] & 0377: ReadB (GeteaB (srcspec));
-            if (!dstreg)
-                pa = TestMB (GeteaB (dstspec));
-            }
-        N = GET_SIGN_B (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        if (dstreg)
-            R[dstspec] = (dst & 0200)? 0177400 | dst: dst;
-        else PWriteB (dst, pa);
-        break;
-
-    case 012:                                           /* CMPB */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadB (GeteaB (dstspec));
-            src = R[srcspec] & 0377;
-            }
-        else {
-            src = srcreg? R[srcspec] & 0377: ReadB (GeteaB (srcspec));
-            src2 = dstreg? R[dstspec] & 0377: ReadB (GeteaB (dstspec));
-            }
-        dst = (src - src2) & 0377;
-        N = GET_SIGN_B (dst);
-        Z = GET_Z (dst);
-        V = GET_SIGN_B ((src ^ src2) & (~src2 ^ dst));
-        C = (src < src2);
-        break;
-
-    case 013:                                           /* BITB */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadB (GeteaB (dstspec));
-            src = R[srcspec] & 0377;
-            }
-        else {
-            src = srcreg? R[srcspec] & 0377: ReadB (GeteaB (srcspec));
-            src2 = dstreg? R[dstspec] & 0377: ReadB (GeteaB (dstspec));
-            }
-        dst = (src2 & src) & 0377;
-        N = GET_SIGN_B (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        break;
-
-    case 014:                                           /* BICB */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMB (GeteaB (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadB (GeteaB (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            }
-        dst = (src2 & ~src) & 0377;
-        N = GET_SIGN_B (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        if (dstreg)
-            R[dstspec] = (R[dstspec] & 0177400) | dst;
-        else PWriteB (dst, last_pa);
-        break;
-
-    case 015:                                           /* BISB */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMB (GeteaB (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadB (GeteaB (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
-            }
-        dst = (src2 | src) & 0377;
-        N = GET_SIGN_B (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        if (dstreg)
-            R[dstspec] = (R[dstspec] & 0177400) | dst;
-        else PWriteB (dst, last_pa);
-        break;
-
-    case 016:                                           /* SUB */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            }
-        dst = (src2 - src) & 0177777;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = GET_SIGN_W ((src ^ src2) & (~src ^ dst));
-        C = (src2 < src);
-        if (dstreg)
-            R[dstspec] = dst;
-        else PWriteW (dst, last_pa);
-        break;
-
-/* Opcode 17: floating point */
-
-    case 017:
-        if (CPUO (OPT_FPP))
-            fp11 (IR);                                  /* call fpp */
-        else setTRAP (TRAP_ILL);
-        break;                                          /* end case 017 */
-        }                                               /* end switch op */
-    }                                                   /* end main loop */
+#if !defined (UC15)
+if (CPUT (CPUT_70))                                     /* pick instr loop */
+    reason = sim_instr_70 ();
+else if (CPUT (CPUT_J))
+    reason = sim_instr_j11 ();
+else if (CPUT (CPUT_34))
+    reason = sim_instr_34 ();
+else
+#endif
+    reason = sim_instr_all ();
 
 /* Simulation halted */
 
@@ -2350,11 +972,17 @@ switch (spec >> 3) {                                    /* decode spec<5:3> */
 int32 ReadE (int32 va)
 {
 int32 pa, data;
+uint32 off;
+RCENT *rc;
 
 if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     setCPUERR (CPUE_ODD);
     ABORT (TRAP_ODD);
     }
+off = va & VA_DF;
+rc = &reloc_cache[(va >> VA_V_APF) & 077];
+if ((uint32) (off - rc->rlo) < rc->rlen)                /* cached memory ref? */
+    return RdMemW (rc->base + off);
 pa = relocR (va);                                       /* relocate */
 if (ADDR_IS_MEM (pa))                                   /* memory address? */
     return RdMemW (pa);
@@ -2373,11 +1001,17 @@ return data;
 int32 ReadW (int32 va)
 {
 int32 pa, data;
+uint32 off;
+RCENT *rc;
 
 if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     setCPUERR (CPUE_ODD);
     ABORT (TRAP_ODD);
     }
+off = va & VA_DF;
+rc = &reloc_cache[(va >> VA_V_APF) & 077];
+if ((uint32) (off - rc->rlo) < rc->rlen)                /* cached memory ref? */
+    return RdMemW (rc->base + off);
 pa = relocR (va);                                       /* relocate */
 if (ADDR_IS_MEM (pa))                                   /* memory address? */
     return RdMemW (pa);
@@ -2395,7 +1029,13 @@ return data;
 int32 ReadB (int32 va)
 {
 int32 pa, data;
+uint32 off;
+RCENT *rc;
 
+off = va & VA_DF;
+rc = &reloc_cache[(va >> VA_V_APF) & 077];
+if ((uint32) (off - rc->rlo) < rc->rlen)                /* cached memory ref? */
+    return RdMemB (rc->base + off);
 pa = relocR (va);                                       /* relocate */
 if (ADDR_IS_MEM (pa))                                   /* memory address? */
     return RdMemB (pa);
@@ -2413,11 +1053,17 @@ return ((va & 1)? data >> 8: data) & 0377;
 int32 ReadMW (int32 va)
 {
 int32 data;
+uint32 off;
+RCENT *rc;
 
 if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     setCPUERR (CPUE_ODD);
     ABORT (TRAP_ODD);
     }
+off = va & VA_DF;
+rc = &reloc_cache[(va >> VA_V_APF) & 077];
+if ((uint32) (off - rc->wlo) < rc->wlen)                /* cached memory ref? */
+    return RdMemW (last_pa = rc->base + off);
 last_pa = relocW (va);                                  /* reloc, wrt chk */
 if (ADDR_IS_MEM (last_pa))                              /* memory address? */
     return RdMemW (last_pa);
@@ -2435,7 +1081,13 @@ return data;
 int32 ReadMB (int32 va)
 {
 int32 data;
+uint32 off;
+RCENT *rc;
 
+off = va & VA_DF;
+rc = &reloc_cache[(va >> VA_V_APF) & 077];
+if ((uint32) (off - rc->wlo) < rc->wlen)                /* cached memory ref? */
+    return RdMemB (last_pa = rc->base + off);
 last_pa = relocW (va);                                  /* reloc, wrt chk */
 if (ADDR_IS_MEM (last_pa))
     return RdMemB (last_pa);
@@ -2484,11 +1136,19 @@ return relocW (va);                                     /* relocate */
 void WriteW (int32 data, int32 va)
 {
 int32 pa;
+uint32 off;
+RCENT *rc;
 
 if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
     setCPUERR (CPUE_ODD);
     ABORT (TRAP_ODD);
     }
+off = va & VA_DF;
+rc = &reloc_cache[(va >> VA_V_APF) & 077];
+if ((uint32) (off - rc->wlo) < rc->wlen)                /* cached memory ref? */ {
+    WrMemW (rc->base + off, data);
+    return;
+    }
 pa = relocW (va);                                       /* relocate */
 if (ADDR_IS_MEM (pa)) {                                 /* memory address? */
     WrMemW (pa, data);
@@ -2508,7 +1168,15 @@ return;
 void WriteB (int32 data, int32 va)
 {
 int32 pa;
+uint32 off;
+RCENT *rc;
 
+off = va & VA_DF;
+rc = &reloc_cache[(va >> VA_V_APF) & 077];
+if ((uint32) (off - rc->wlo) < rc->wlen)                /* cached memory ref? */ {
+    WrMemB (rc->base + off, data);
+    return;
+    }
 pa = relocW (va);                                       /* relocate */
 if (ADDR_IS_MEM (pa)) {                                 /* memory address? */
     WrMemB (pa, data);
@@ -2695,7 +1363,10 @@ if (MMR0 & MMR0_MME) {                                  /* if mmgt */
         relocW_test (va, apridx);                       /* long test */
     if (PLF_test (va, apr))                             /* pg lnt error? */
         reloc_abort (MMR0_PL, apridx);
-    APRFILE[apridx] |= PDR_W;                           /* set W */
+    if ((apr & PDR_W) == 0) {                           /* first write? */
+        APRFILE[apridx] |= PDR_W;                       /* set W */
+        reloc_cache_set (apridx);                       /* now cacheable */
+        }
     pa = ((va & VA_DF) + ((apr >> 10) & 017777700)) & PAMASK;
     if ((MMR3 & MMR3_M22E) == 0) {
         pa = pa & 0777777;
@@ -2763,6 +1434,100 @@ reloc_abort (err, apridx);
 return;
 }
 
+/* Relocation cache
+
+   For each APR (va<18:13>), the relocation cache holds the physical
+   address of va<12:0> = 0, and the ranges of va<12:0> that can be read
+   or written with no further checks: the access is allowed, the block
+   is within the page length, and the physical address is in memory.
+   Writes are only cached once PDR<W> is set.  With memory management
+   off, the entries map pages 0-6 directly.  Everything else takes the
+   full relocation path.
+
+   The cache must be recomputed whenever an APR, MMR0, MMR3, or the
+   memory size changes.
+*/
+
+void reloc_cache_set (int32 apridx)
+{
+RCENT *rc = &reloc_cache[apridx];
+int32 apr = APRFILE[apridx];
+uint32 base, lo, hi, lim;
+t_bool rd, wr;
+
+rc->rlen = rc->wlen = 0;                                /* assume uncached */
+lim = RC_MEMLIM;
+if (MMR0 & MMR0_MME) {                                  /* if mmgt */
+    base = (apr >> 10) & 017777700;
+    if ((MMR3 & MMR3_M22E) == 0) {                      /* 18b? */
+        base = base & 0777777;
+        if (lim > 0760000)                              /* I/O page above */
+            lim = 0760000;
+        }
+    if (apr & PDR_ED) {                                 /* expand down? */
+        lo = (apr & PDR_PLF) >> 2;
+        hi = VA_DF;
+        }
+    else {
+        lo = 0;
+        hi = ((apr & PDR_PLF) >> 2) | (VA_DF & ~VA_BN);
+        }
+    rd = ((apr & PDR_PRD) == 2);
+    wr = ((apr & PDR_ACF) == 6) && (apr & PDR_W);
+    }
+else {
+    if ((apridx & 07) == 07)                            /* I/O page? */
+        return;
+    base = (apridx & 07) << VA_V_APF;
+    lo = 0;
+    hi = VA_DF;
+    rd = wr = TRUE;
+    }
+if (base >= lim)                                        /* not in memory? */
+    return;
+if (hi > (lim - 1 - base))                              /* clip to memory */
+    hi = lim - 1 - base;
+if (hi < lo)
+    return;
+rc->base = base;
+rc->rlo = rc->wlo = lo;
+if (rd)
+    rc->rlen = hi - lo + 1;
+if (wr)
+    rc->wlen = hi - lo + 1;
+return;
+}
+
+void reloc_cache_all (void)
+{
+int32 i;
+
+for (i = 0; i < 64; i++)
+    reloc_cache_set (i);
+return;
+}
+
+/* Return the number of bytes, starting at va, that the relocation cache
+   maps straight to memory for a read (wr = FALSE) or write (wr = TRUE),
+   and the physical address of va in *pa.  The run stops at the end of
+   the page; zero means va must go through the normal access routines.
+*/
+
+int32 reloc_cache_run (int32 va, t_bool wr, uint32 *pa)
+{
+uint32 off, lo, len;
+RCENT *rc;
+
+off = va & VA_DF;
+rc = &reloc_cache[(va >> VA_V_APF) & 077];
+lo = wr? rc->wlo: rc->rlo;
+len = wr? rc->wlen: rc->rlen;
+if ((uint32) (off - lo) >= len)                         /* not cached? */
+    return 0;
+*pa = rc->base + off;
+return (int32) (lo + len - off);
+}
+
 /* Relocate virtual address, console access
 
    Inputs:
@@ -2855,6 +1620,7 @@ switch ((pa >> 1) & 3) {                                /* decode pa<2:1> */
             data = (pa & 1)? (MMR0 & 0377) | (data << 8): (MMR0 & ~0377) | data;
         data = data & cpu_tab[cpu_model].mm0;
         MMR0 = (MMR0 & ~MMR0_WR) | (data & MMR0_WR);
+        reloc_cache_all ();
         return SCPE_OK;
 
     default:                                            /* MMR1, MMR2 */
@@ -2875,6 +1641,7 @@ if (pa & 1)
 MMR3 = data & cpu_tab[cpu_model].mm3;
 cpu_bme = (MMR3 & MMR3_BME) && (cpu_opt & OPT_UBM);
 dsenable = calc_ds (cm);
+reloc_cache_all ();
 return SCPE_OK;
 }
 
@@ -2955,6 +1722,7 @@ if (left)
         (((uint32) (data & cpu_tab[cpu_model].par)) << 16)) & ~(PDR_A|PDR_W);
 else APRFILE[idx] = ((APRFILE[idx] & ~0177777) |
     (data & cpu_tab[cpu_model].pdr)) & ~(PDR_A|PDR_W);
+reloc_cache_set (idx);
 return SCPE_OK;
 }
 
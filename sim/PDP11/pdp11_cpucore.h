@@ -0,0 +1,1668 @@
+/* pdp11_cpucore.h: PDP-11 CPU instruction loop
+
+   Copyright (c) 1993-2023, Robert M Supnik
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in
+   all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+   ROBERT M SUPNIK BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+   IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   Except as contained in this notice, the name of Robert M Supnik shall not be
+   used in advertising or otherwise to promote the sale, use or other dealings
+   in this Software without prior written authorization from Robert M Supnik.
+
+   This file is included by pdp11_cpu.c once per instance of the instruction
+   loop.  Before each inclusion, the includer defines
+
+        CORE_NAME       name of the instance
+        CORE_TYPES      mask of the CPU types (CPUT_xx) it runs
+
+   Within the instance, a CPUT test that is true for all of CORE_TYPES, or
+   false for all of them, is a compile time constant, and the compiler
+   drops the code it guards.  Other CPUT tests, and all CPUO option tests,
+   are evaluated at run time as usual.
+*/
+
+#undef CPUT
+#define CPUT(x)         ((((x) & (CORE_TYPES)) == 0)? 0: \
+                         (((x) & (CORE_TYPES)) == (CORE_TYPES))? 1: \
+                         ((cpu_type & (x)) != 0))
+
+static t_stat CORE_NAME (void)
+{
+int abortval;
+volatile int32 trapea;                                  /* used by setjmp */
+t_stat reason;
+#if defined (USE_OP_TAB)
+static void *op_tab[02000];                             /* IR<15:6> dispatch */
+static const struct {
+    int32       op;                                     /* first IR<15:6> */
+    void        *lbl;                                   /* handler */
+    uint32      typ;                                    /* required CPU types */
+    uint32      opt;                                    /* required options */
+    } op_ent[] = {
+    OP_ENT (0000, 0, 0),            OP_ENT (0001, 0, 0),        /* no op, JMP */
+    OP_ENT (0002, 0, 0),            OP_ENT (0003, 0, 0),        /* RTS, SWAB */
+    OP_ENT (0004, 0, 0),            OP_ENT (0006, 0, 0),        /* BR */
+    OP_ENT (0010, 0, 0),            OP_ENT (0012, 0, 0),        /* BNE */
+    OP_ENT (0014, 0, 0),            OP_ENT (0016, 0, 0),        /* BEQ */
+    OP_ENT (0020, 0, 0),            OP_ENT (0022, 0, 0),        /* BGE */
+    OP_ENT (0024, 0, 0),            OP_ENT (0026, 0, 0),        /* BLT */
+    OP_ENT (0030, 0, 0),            OP_ENT (0032, 0, 0),        /* BGT */
+    OP_ENT (0034, 0, 0),            OP_ENT (0036, 0, 0),        /* BLE */
+    OP_ENT (0040, 0, 0),                                        /* JSR */
+    OP_ENT (0050, 0, 0),            OP_ENT (0051, 0, 0),        /* CLR, COM */
+    OP_ENT (0052, 0, 0),            OP_ENT (0053, 0, 0),        /* INC, DEC */
+    OP_ENT (0054, 0, 0),            OP_ENT (0055, 0, 0),        /* NEG, ADC */
+    OP_ENT (0056, 0, 0),            OP_ENT (0057, 0, 0),        /* SBC, TST */
+    OP_ENT (0060, 0, 0),            OP_ENT (0061, 0, 0),        /* ROR, ROL */
+    OP_ENT (0062, 0, 0),            OP_ENT (0063, 0, 0),        /* ASR, ASL */
+    OP_ENT (0064, HAS_MARK, 0),                                 /* MARK */
+    OP_ENT (0065, HAS_MXPY, 0),     OP_ENT (0066, HAS_MXPY, 0), /* MFPI, MTPI */
+    OP_ENT (0067, HAS_SXS, 0),      OP_ENT (0070, HAS_CSM, 0),  /* SXT, CSM */
+    { 00071, &&op_ILL, 0, 0 },
+    OP_ENT (0072, HAS_TSWLK, 0),                                /* TSTSET */
+    OP_ENT (0073, HAS_TSWLK, 0),                                /* WRTLCK */
+    { 00074, &&op_ILL, 0, 0 },
+    OP_ENT (0100, 0, 0),            OP_ENT (0200, 0, 0),        /* MOV, CMP */
+    OP_ENT (0300, 0, 0),            OP_ENT (0400, 0, 0),        /* BIT, BIC */
+    OP_ENT (0500, 0, 0),            OP_ENT (0600, 0, 0),        /* BIS, ADD */
+    OP_ENT (0700, 0, 0),                                        /* EIS, FIS, CIS, SOB */
+    OP_ENT (1000, 0, 0),            OP_ENT (1002, 0, 0),        /* BPL */
+    OP_ENT (1004, 0, 0),            OP_ENT (1006, 0, 0),        /* BMI */
+    OP_ENT (1010, 0, 0),            OP_ENT (1012, 0, 0),        /* BHI */
+    OP_ENT (1014, 0, 0),            OP_ENT (1016, 0, 0),        /* BLOS */
+    OP_ENT (1020, 0, 0),            OP_ENT (1022, 0, 0),        /* BVC */
+    OP_ENT (1024, 0, 0),            OP_ENT (1026, 0, 0),        /* BVS */
+    OP_ENT (1030, 0, 0),            OP_ENT (1032, 0, 0),        /* BCC */
+    OP_ENT (1034, 0, 0),            OP_ENT (1036, 0, 0),        /* BCS */
+    OP_ENT (1040, 0, 0),            OP_ENT (1044, 0, 0),        /* EMT, TRAP */
+    OP_ENT (1050, 0, 0),            OP_ENT (1051, 0, 0),        /* CLRB, COMB */
+    OP_ENT (1052, 0, 0),            OP_ENT (1053, 0, 0),        /* INCB, DECB */
+    OP_ENT (1054, 0, 0),            OP_ENT (1055, 0, 0),        /* NEGB, ADCB */
+    OP_ENT (1056, 0, 0),            OP_ENT (1057, 0, 0),        /* SBCB, TSTB */
+    OP_ENT (1060, 0, 0),            OP_ENT (1061, 0, 0),        /* RORB, ROLB */
+    OP_ENT (1062, 0, 0),            OP_ENT (1063, 0, 0),        /* ASRB, ASLB */
+    OP_ENT (1064, HAS_MXPS, 0),     OP_ENT (1065, HAS_MXPY, 0), /* MTPS, MFPD */
+    OP_ENT (1066, HAS_MXPY, 0),     OP_ENT (1067, HAS_MXPS, 0), /* MTPD, MFPS */
+    { 01070, &&op_ILL, 0, 0 },
+    OP_ENT (1100, 0, 0),            OP_ENT (1200, 0, 0),        /* MOVB, CMPB */
+    OP_ENT (1300, 0, 0),            OP_ENT (1400, 0, 0),        /* BITB, BICB */
+    OP_ENT (1500, 0, 0),            OP_ENT (1600, 0, 0),        /* BISB, SUB */
+    OP_ENT (1700, 0, OPT_FPP),                                  /* FPP */
+    { 02000, NULL, 0, 0 }
+    };
+int32 i, j;
+#endif
+
+#if defined (USE_OP_TAB)
+for (i = 0; op_ent[i].lbl != NULL; i++) {               /* build dispatch tab */
+    void *lbl = op_ent[i].lbl;
+    if ((op_ent[i].typ && !CPUT (op_ent[i].typ)) ||     /* not on this model? */
+        (op_ent[i].opt && !CPUO (op_ent[i].opt)))
+        lbl = &&op_ILL;                                 /* reserved instr */
+    for (j = op_ent[i].op; j < op_ent[i + 1].op; j++)
+        op_tab[j] = lbl;
+    }
+#endif
+trapea = 0;
+reason = 0;
+
+/* Abort handling
+
+   If an abort occurs in memory management or memory access, the lower
+   level routine executes a longjmp to this area OUTSIDE the main
+   simulation loop.  The longjmp specifies a trap mask which is OR'd
+   into the trap_req register.  Simulation then resumes at the fetch
+   phase, and the trap is sprung.
+
+   Aborts which occur within a trap sequence (trapea != 0) require
+   special handling.  If the abort occured on the stack pushes, and
+   the mode (encoded in trapea) is kernel, an "emergency" kernel
+   stack is created at 4, and a red zone stack trap taken.
+
+   All variables used in setjmp processing, or assumed to be valid
+   after setjmp, must be volatile or global.
+*/
+
+abortval = setjmp (save_env);                           /* set abort hdlr */
+if (abortval != 0) {
+    trap_req = trap_req | abortval;                     /* or in trap flag */
+    if ((trapea > 0) && stop_vecabort)
+        reason = STOP_VECABORT;
+    if ((trapea < 0) &&                                 /* stack push abort? */
+        (CPUT (STOP_STKA) || stop_spabort))
+        reason = STOP_SPABORT;
+    if (trapea == ~MD_KER) {                            /* kernel stk abort? */
+        trap_req = trap_req & ~trap_clear[TRAP_RED];    /* clear all traps */
+        setTRAP (TRAP_RED);                             /* set red stack trap */
+        setCPUERR (CPUE_RED);
+        STACKFILE[MD_KER] = 4;
+        if (cm == MD_KER)
+            SP = 4;
+        }
+    }
+
+/* Main instruction fetch/decode loop
+
+   Check for traps or interrupts.  If trap, locate the vector and check
+   for stop condition.  If interrupt, locate the vector.
+*/ 
+
+while (reason == 0)  {
+
+    int32 IR, srcspec, srcreg, dstspec, dstreg;
+    int32 src, src2, dst, pa;
+    int32 i, t, sign, oldrs, trapnum;
+
+    if (cpu_astop) {
+        cpu_astop = 0;
+        reason = SCPE_STOP;
+        break;
+        }
+
+    if (sim_interval <= 0) {                            /* intv cnt expired? */
+        reason = sim_process_event ();                  /* process events */
+        trap_req = calc_ints (ipl, trap_req);           /* recalc int req */
+        continue;
+        }                                               /* end if sim_interval */
+
+    if (trap_req) {                                     /* check traps, ints */
+        trapea = 0;                                     /* assume srch fails */
+        if ((t = trap_req & TRAP_ALL)) {                /* if a trap */
+            for (trapnum = 0; trapnum < TRAP_V_MAX; trapnum++) {
+                if ((t >> trapnum) & 1) {               /* trap set? */
+                    trapea = trap_vec[trapnum];         /* get vec, clr */
+                    trap_req = trap_req & ~trap_clear[trapnum];
+                    if ((stop_trap >> trapnum) & 1)     /* stop on trap? */
+                        reason = trapnum + 1;
+                    break;
+                    }                                   /* end if t & 1 */
+                }                                       /* end for */
+            }                                           /* end if t */
+        else {
+            trapea = get_vector (ipl);                  /* get int vector */
+            trapnum = TRAP_V_MAX;                       /* defang stk trap */
+            }                                           /* end else t */
+        if (trapea == 0) {                              /* nothing to do? */
+            trap_req = calc_ints (ipl, 0);              /* recalculate */
+            continue;                                   /* back to fetch */
+            }                                           /* end if trapea */
+
+/* Process a trap or interrupt
+
+   1. Exit wait state
+   2. Save the current SP and PSW
+   3. Read the new PC, new PSW from trapea, kernel data space
+   4. Get the mode and stack selected by the new PSW
+   5. Push the old PC and PSW on the new stack
+   6. Update SP, PSW, and PC
+   7. If not stack overflow, check for stack overflow
+
+   If the MMU registers are not frozen, the 11/45 and 11/70 will
+   also clear MMR1 and store the trap vector in MMR2, <except>
+   for the four instruction traps (EMT, TRAP, IOT, BPT).
+*/
+
+        wait_state = 0;                                 /* exit wait state */
+        STACKFILE[cm] = SP;
+        PSW = get_PSW ();                               /* assemble PSW */
+        oldrs = rs;
+        if ((CPUT (HAS_MMTR)) && (update_MM)) {         /* 45,70, not frozen? */
+            MMR1 = 0;                                   /* clear MMR1 */
+            if (trap_load_mmr2[trapnum])                /* load MMR2? */
+                MMR2 = trapea;                          /* save vector */
+            }
+        src = ReadW (trapea | calc_ds (MD_KER));        /* new PC */
+        src2 = ReadW ((trapea + 2) | calc_ds (MD_KER)); /* new PSW */
+        t = (src2 >> PSW_V_CM) & 03;                    /* new cm */
+        trapea = ~t;                                    /* flag pushes */
+        WriteW (PSW, ((STACKFILE[t] - 2) & 0177777) | calc_ds (t));
+        WriteW (PC, ((STACKFILE[t] - 4) & 0177777) | calc_ds (t));
+        trapea = 0;                                     /* clear trap flag */
+        src2 = (src2 & ~PSW_PM) | (cm << PSW_V_PM);     /* insert prv mode */
+        put_PSW (src2, 0);                              /* call calc_is,ds */
+        if (rs != oldrs) {                              /* if rs chg, swap */
+            for (i = 0; i < 6; i++) {
+                REGFILE[i][oldrs] = R[i];
+                R[i] = REGFILE[i][rs];
+                }
+            }
+        SP = (STACKFILE[cm] - 4) & 0177777;             /* update SP, PC */
+        isenable = calc_is (cm);
+        dsenable = calc_ds (cm);
+        trap_req = calc_ints (ipl, trap_req);
+        JMP_PC (src);
+        if ((cm == MD_KER) && (SP < (STKLIM + STKL_Y)) &&
+            (trapnum != TRAP_V_RED) && (trapnum != TRAP_V_YEL))
+            set_stack_trap (SP);
+        if (tbit)                                       /* tbit now set? */
+            setTRAP (TRAP_TRC);                         /* immediate trap */
+        continue;                                       /* end if traps */
+        }
+
+/* Fetch and decode next instruction */
+
+    if (tbit)
+        setTRAP (TRAP_TRC);
+    if (wait_state) {                                   /* wait state? */
+        sim_idle (TMR_CLK, TRUE);
+        continue;
+        }
+
+    if (sim_brk_summ && sim_brk_test (PC, SWMASK ('E'))) { /* breakpoint? */
+        reason = STOP_IBKPT;                            /* stop simulation */
+        continue;
+        }
+
+    if (update_MM) {                                    /* if mm not frozen */
+        MMR1 = 0;
+        MMR2 = PC;
+        }
+    IR = ReadE (PC | isenable);                         /* fetch instruction */
+    sim_interval = sim_interval - 1;
+    srcspec = (IR >> 6) & 077;                          /* src, dst specs */
+    dstspec = IR & 077;
+    srcreg = (srcspec <= 07);                           /* src, dst = rmode? */
+    dstreg = (dstspec <= 07);
+    if (hst_lnt) {                                      /* record history? */
+        t_value val;
+        uint32 i;
+        static int32 swmap[4] = {
+            SWMASK ('K') | SWMASK ('V'), SWMASK ('S') | SWMASK ('V'),
+            SWMASK ('U') | SWMASK ('V'), SWMASK ('U') | SWMASK ('V')
+            };
+        hst[hst_p].pc = PC | HIST_VLD;
+        hst[hst_p].sp = SP;
+        hst[hst_p].psw = get_PSW ();
+        hst[hst_p].src = R[srcspec & 07];
+        hst[hst_p].dst = R[dstspec & 07];
+        hst[hst_p].inst[0] = IR;
+        for (i = 1; i < HIST_ILNT; i++) {
+            if (cpu_ex (&val, (PC + (i << 1)) & 0177777, &cpu_unit, swmap[cm & 03]))
+                hst[hst_p].inst[i] = 0;
+            else hst[hst_p].inst[i] = (uint16) val;
+            }
+        hst_p = (hst_p + 1);
+        if (hst_p >= hst_lnt)
+            hst_p = 0;
+        }
+    PC = (PC + 2) & 0177777;                            /* incr PC, mod 65k */
+#if defined (USE_OP_TAB)
+    goto *op_tab[IR >> 6];                              /* dispatch IR<15:6> */
+#endif
+    switch ((IR >> 12) & 017) {                         /* decode IR<15:12> */
+
+/* Opcode 0: no operands, specials, branches, JSR, SOPs */
+
+    case 000:
+        switch ((IR >> 6) & 077) {                      /* decode IR<11:6> */
+        OP_LBL (0000)
+        case 000:                                       /* no operand */
+            if (IR >= 000010) {                         /* 000010 - 000077 */
+                setTRAP (TRAP_ILL);                     /* illegal */
+                break;
+                }
+            switch (IR) {                               /* decode IR<2:0> */
+            case 0:                                     /* HALT */
+                if ((cm == MD_KER) &&
+                    (!CPUT (CPUT_J) || ((MAINT & MAINT_HTRAP) == 0)))
+                    reason = STOP_HALT;
+                else if (CPUT (HAS_HALT4)) {            /* priv trap? */
+                    setTRAP (TRAP_PRV);
+                    setCPUERR (CPUE_HALT);
+                    }
+                else setTRAP (TRAP_ILL);                /* no, ill inst */
+                break;
+            case 1:                                     /* WAIT */
+                wait_state = 1;
+                break;
+            case 3:                                     /* BPT */
+                setTRAP (TRAP_BPT);
+                break;
+            case 4:                                     /* IOT */
+                setTRAP (TRAP_IOT);
+                break;
+            case 5:                                     /* RESET */
+                if (cm == MD_KER) {
+                    reset_all (2);                      /* skip CPU, sys reg */
+                    PIRQ = 0;                           /* clear PIRQ */
+                    STKLIM = 0;                         /* clear STKLIM */
+                    MMR0 = 0;                           /* clear MMR0 */
+                    MMR3 = 0;                           /* clear MMR3 */
+                    cpu_bme = 0;                        /* (also clear bme) */
+                    reloc_cache_all ();                 /* mmgt now off */
+                    for (i = 0; i < IPL_HLVL; i++)
+                        int_req[i] = 0;
+                    trap_req = trap_req & ~TRAP_INT;
+                    dsenable = calc_ds (cm);
+                    }
+                break;
+            case 6:                                     /* RTT */
+                if (!CPUT (HAS_RTT)) {
+                    setTRAP (TRAP_ILL);
+                    break;
+                    }
+            case 2:                                     /* RTI */
+                src = ReadW (SP | dsenable);
+                src2 = ReadW (((SP + 2) & 0177777) | dsenable);
+                STACKFILE[cm] = SP = (SP + 4) & 0177777;
+                oldrs = rs;
+                put_PSW (src2, (cm != MD_KER));         /* store PSW, prot */
+                if (rs != oldrs) {
+                    for (i = 0; i < 6; i++) {
+                        REGFILE[i][oldrs] = R[i];
+                        R[i] = REGFILE[i][rs];
+                        }
+                    }
+                SP = STACKFILE[cm];
+                isenable = calc_is (cm);
+                dsenable = calc_ds (cm);
+                trap_req = calc_ints (ipl, trap_req);
+                JMP_PC (src);
+                if (CPUT (HAS_RTT) && tbit &&           /* RTT impl? */
+                    (IR == 000002))
+                    setTRAP (TRAP_TRC);                 /* RTI immed trap */
+                else trap_req = trap_req & ~TRAP_TRC;   /* no trace trap */
+                break;
+            case 7:                                     /* MFPT */
+                if (CPUT (HAS_MFPT))                    /* implemented? */
+                    R[0] = cpu_tab[cpu_model].mfpt;     /* get type */
+                else setTRAP (TRAP_ILL);
+                break;
+                }                                       /* end switch no ops */
+            break;                                      /* end case no ops */
+
+        OP_LBL (0001)
+        case 001:                                       /* JMP */
+            if (dstreg)
+                setTRAP (CPUT (HAS_JREG4)? TRAP_PRV: TRAP_ILL);
+            else {
+                dst = GeteaW (dstspec) & 0177777;       /* get eff addr */
+                if (CPUT (CPUT_05|CPUT_20) &&           /* 11/05, 11/20 */
+                    ((dstspec & 070) == 020))           /* JMP (R)+? */
+                    dst = R[dstspec & 07];              /* use post incr */
+                JMP_PC (dst);
+                }
+            break;                                      /* end JMP */
+
+        OP_LBL (0002)
+        case 002:                                       /* RTS et al*/
+            if (IR < 000210) {                          /* RTS */
+                dstspec = dstspec & 07;
+                JMP_PC (R[dstspec]);
+                R[dstspec] = ReadW (SP | dsenable);
+                if (dstspec != 6)
+                    SP = (SP + 2) & 0177777;
+                break;
+                }                                       /* end if RTS */
+            if (IR < 000230) {
+                setTRAP (TRAP_ILL);
+                break;
+                }
+            if (IR < 000240) {                          /* SPL */
+                if (CPUT (HAS_SPL)) {
+                    if (cm == MD_KER)
+                        ipl = IR & 07;
+                    trap_req = calc_ints (ipl, trap_req);
+                    }
+                else setTRAP (TRAP_ILL);
+                break;
+                }                                       /* end if SPL */
+            if (IR < 000260) {                          /* clear CC */
+                if (IR & 010)
+                    N = 0;
+                if (IR & 004)
+                    Z = 0;
+                if (IR & 002)
+                    V = 0;
+                if (IR & 001)
+                    C = 0;
+                break;
+                }                                       /* end if clear CCs */
+            if (IR & 010)                               /* set CC */
+                N = 1;
+            if (IR & 004)
+                Z = 1;
+            if (IR & 002)
+                V = 1;
+            if (IR & 001)
+                C = 1;
+            break;                                      /* end case RTS et al */
+
+        OP_LBL (0003)
+        case 003:                                       /* SWAB */
+            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = ((dst & 0377) << 8) | ((dst >> 8) & 0377);
+            N = GET_SIGN_B (dst & 0377);
+            Z = GET_Z (dst & 0377);
+            if (!CPUT (CPUT_20))
+                V = 0;
+            C = 0;
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;                                      /* end SWAB */
+
+        OP_LBL (0004)
+        case 004: case 005:                             /* BR */
+            BRANCH_F (IR);
+            break;
+
+        OP_LBL (0006)
+        case 006: case 007:                             /* BR */
+            BRANCH_B (IR);
+            break;
+
+        OP_LBL (0010)
+        case 010: case 011:                             /* BNE */
+            if (Z == 0) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (0012)
+        case 012: case 013:                             /* BNE */
+            if (Z == 0) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (0014)
+        case 014: case 015:                             /* BEQ */
+            if (Z) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (0016)
+        case 016: case 017:                             /* BEQ */
+            if (Z) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (0020)
+        case 020: case 021:                             /* BGE */
+            if ((N ^ V) == 0) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (0022)
+        case 022: case 023:                             /* BGE */
+            if ((N ^ V) == 0) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (0024)
+        case 024: case 025:                             /* BLT */
+            if (N ^ V) {
+                BRANCH_F (IR);
+                }
+            break;
+
+        OP_LBL (0026)
+        case 026: case 027:                             /* BLT */
+            if (N ^ V) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (0030)
+        case 030: case 031:                             /* BGT */
+            if ((Z | (N ^ V)) == 0) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (0032)
+        case 032: case 033:                             /* BGT */
+            if ((Z | (N ^ V)) == 0) { BRANCH_B (IR); }
+            break;
+
+        OP_LBL (0034)
+        case 034: case 035:                             /* BLE */
+            if (Z | (N ^ V)) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (0036)
+        case 036: case 037:                             /* BLE */
+            if (Z | (N ^ V)) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (0040)
+        case 040: case 041: case 042: case 043:         /* JSR */
+        case 044: case 045: case 046: case 047:
+            if (dstreg)
+                setTRAP (CPUT (HAS_JREG4)? TRAP_PRV: TRAP_ILL);
+            else {
+                srcspec = srcspec & 07;
+                dst = GeteaW (dstspec);
+                if (CPUT (CPUT_05|CPUT_20) &&           /* 11/05, 11/20 */
+                    ((dstspec & 070) == 020))           /* JSR (R)+? */
+                    dst = R[dstspec & 07];              /* use post incr */
+                SP = (SP - 2) & 0177777;
+                if (update_MM)
+                    MMR1 = calc_MMR1 (0366);
+                if ((cm == MD_KER) && (SP < (STKLIM + STKL_Y)))
+                    set_stack_trap (SP);
+                WriteW (R[srcspec], SP | dsenable);
+                R[srcspec] = PC;
+                JMP_PC (dst & 0177777);
+                }
+            break;                                      /* end JSR */
+
+        OP_LBL (0050)
+        case 050:                                       /* CLR */
+            if (!dstreg)                                /* not reg? */
+                pa = TestMW (GeteaW (dstspec));         /* relocate */
+            N = V = C = 0;                              /* now set CC's */
+            Z = 1;
+            if (dstreg)
+                R[dstspec] = 0;
+            else PWriteW (0, pa);
+            break;
+
+        OP_LBL (0051)
+        case 051:                                       /* COM */
+            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = dst ^ 0177777;
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            V = 0;
+            C = 1;
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+        OP_LBL (0052)
+        case 052:                                       /* INC */
+            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = (dst + 1) & 0177777;
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            V = (dst == 0100000);
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+        OP_LBL (0053)
+        case 053:                                       /* DEC */
+            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = (dst - 1) & 0177777;
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            V = (dst == 077777);
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+        OP_LBL (0054)
+        case 054:                                       /* NEG */
+            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = (-dst) & 0177777;
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            V = (dst == 0100000);
+            C = Z ^ 1;
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+        OP_LBL (0055)
+        case 055:                                       /* ADC */
+            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = (dst + C) & 0177777;
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            V = (C && (dst == 0100000));
+            C = C & Z;
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+        OP_LBL (0056)
+        case 056:                                       /* SBC */
+            dst = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = (dst - C) & 0177777;
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            V = (C && (dst == 077777));
+            C = (C && (dst == 0177777));
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+        OP_LBL (0057)
+        case 057:                                       /* TST */
+            dst = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            V = C = 0;
+            break;
+
+        OP_LBL (0060)
+        case 060:                                       /* ROR */
+            src = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = (src >> 1) | (C << 15);
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            C = (src & 1);
+            V = N ^ C;
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+        OP_LBL (0061)
+        case 061:                                       /* ROL */
+            src = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = ((src << 1) | C) & 0177777;
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            C = GET_SIGN_W (src);
+            V = N ^ C;
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+        OP_LBL (0062)
+        case 062:                                       /* ASR */
+            src = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = (src >> 1) | (src & 0100000);
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            C = (src & 1);
+            V = N ^ C;
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+        OP_LBL (0063)
+        case 063:                                       /* ASL */
+            src = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            dst = (src << 1) & 0177777;
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            C = GET_SIGN_W (src);
+            V = N ^ C;
+            if (dstreg)
+                R[dstspec] = dst;
+            else PWriteW (dst, last_pa);
+            break;
+
+/* Notes:
+   - MxPI must mask GeteaW returned address to force ispace
+   - MxPI must set MMR1 for SP recovery in case of fault
+*/
+
+        OP_LBL (0064)
+        case 064:                                       /* MARK */
+            if (CPUT (HAS_MARK)) {
+                i = (PC + dstspec + dstspec) & 0177777;
+                JMP_PC (R[5]);
+                R[5] = ReadW (i | dsenable);
+                SP = (i + 2) & 0177777;
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (0065)
+        case 065:                                       /* MFPI */
+            if (CPUT (HAS_MXPY)) {
+                if (dstreg) {
+                    if ((dstspec == 6) && (cm != pm))
+                        dst = STACKFILE[pm];
+                    else dst = R[dstspec];
+                    }
+                else {
+                    i = ((cm == pm) && (cm == MD_USR))? (int32)calc_ds (pm): (int32)calc_is (pm);
+                    dst = ReadW ((GeteaW (dstspec) & 0177777) | i);
+                    }
+                SP = (SP - 2) & 0177777;
+                if (update_MM)
+                    MMR1 = calc_MMR1 (0366);
+                if ((cm == MD_KER) && (SP < (STKLIM + STKL_Y)))
+                    set_stack_trap (SP);
+                pa = TestMW (SP | dsenable);        /* relocate SP */
+                N = GET_SIGN_W (dst);               /* now update CC's */
+                Z = GET_Z (dst);
+                V = 0;
+                PWriteW (dst, pa);
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (0066)
+        case 066:                                       /* MTPI */
+            if (CPUT (HAS_MXPY)) {
+                dst = ReadW (SP | dsenable);
+                SP = (SP + 2) & 0177777;
+                if (update_MM)
+                    MMR1 = 026;
+                if (!dstreg)
+                    pa = TestMW ((GeteaW (dstspec) & 0177777) | calc_is (pm));
+                N = GET_SIGN_W (dst);                   /* now update CCs */
+                Z = GET_Z (dst);
+                V = 0;
+                if (dstreg) {
+                    if ((dstspec == 6) && (cm != pm))
+                        STACKFILE[pm] = dst;
+                    else R[dstspec] = dst;
+                    }
+                else PWriteW (dst, pa);
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (0067)
+        case 067:                                       /* SXT */
+            if (CPUT (HAS_SXS)) {
+                if (!dstreg)
+                    pa = TestMW (GeteaW (dstspec));
+                dst = N? 0177777: 0;                    /* now update CCs */
+                Z = N ^ 1;
+                V = 0;
+                if (dstreg)
+                    R[dstspec] = dst;
+                else PWriteW (dst, pa);
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (0070)
+        case 070:                                       /* CSM */
+            if (CPUT (HAS_CSM) && (MMR3 & MMR3_CSM) && (cm != MD_KER)) {
+                dst = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+                PSW = get_PSW () & ~PSW_CC;             /* PSW, cc = 0 */
+                STACKFILE[cm] = SP;
+                WriteW (PSW, ((SP - 2) & 0177777) | calc_ds (MD_SUP));
+                WriteW (PC, ((SP - 4) & 0177777) | calc_ds (MD_SUP));
+                WriteW (dst, ((SP - 6) & 0177777) | calc_ds (MD_SUP));
+                SP = (SP - 6) & 0177777;
+                pm = cm;
+                cm = MD_SUP;
+                tbit = 0;
+                isenable = calc_is (cm);
+                dsenable = calc_ds (cm);
+                PC = ReadW (010 | isenable);
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (0072)
+        case 072:                                       /* TSTSET */
+            if (CPUT (HAS_TSWLK) && !dstreg) {
+                dst = ReadMW (GeteaW (dstspec));
+                N = GET_SIGN_W (dst);
+                Z = GET_Z (dst);
+                V = 0;
+                C = (dst & 1);
+                R[0] = dst;                             /* R[0] <- dst */
+                PWriteW (R[0] | 1, last_pa);            /* dst <- R[0] | 1 */
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (0073)
+        case 073:                                       /* WRTLCK */
+            if (CPUT (HAS_TSWLK) && !dstreg) {
+                dst = ReadMW (GeteaW (dstspec));        /* data thrown away */
+                N = GET_SIGN_W (R[0]);
+                Z = GET_Z (R[0]);
+                V = 0;
+                PWriteW (R[0], last_pa);                /* dst <- R[0] */
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (ILL)
+        default:
+            setTRAP (TRAP_ILL);
+            break;
+            }                                           /* end switch SOPs */
+        break;                                          /* end case 000 */
+
+/* Opcodes 01 - 06: double operand word instructions
+
+   J-11 (and F-11) optimize away register source operand decoding.
+   As a result, dop R,+/-(R) use the modified version of R as source.
+   Most (but not all) other PDP-11's fetch the source operand before
+   any destination operand decoding.
+
+   Add: v = [sign (src) = sign (src2)] and [sign (src) != sign (result)]
+   Cmp: v = [sign (src) != sign (src2)] and [sign (src2) = sign (result)]
+*/
+
+    OP_LBL (0100)
+    case 001:                                           /* MOV */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            pa = TestMW (GeteaW (dstspec));             /* reloc dest */
+            dst = R[srcspec];
+            }
+        else {
+            dst = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+            if (!dstreg)
+                pa = TestMW (GeteaW (dstspec));
+            }
+        N = GET_SIGN_W (dst);                           /* now update CCs */
+        Z = GET_Z (dst);
+        V = 0;
+        if (dstreg)
+            R[dstspec] = dst;
+        else PWriteW (dst, pa);
+        break;
+
+    OP_LBL (0200)
+    case 002:                                           /* CMP */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadW (GeteaW (dstspec));
+            src = R[srcspec];
+            }
+        else {
+            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+            }
+        dst = (src - src2) & 0177777;
+        N = GET_SIGN_W (dst);
+        Z = GET_Z (dst);
+        V = GET_SIGN_W ((src ^ src2) & (~src2 ^ dst));
+        C = (src < src2);
+        break;
+
+    OP_LBL (0300)
+    case 003:                                           /* BIT */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadW (GeteaW (dstspec));
+            src = R[srcspec];
+            }
+        else {
+            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+            }
+        dst = src2 & src;
+        N = GET_SIGN_W (dst);
+        Z = GET_Z (dst);
+        V = 0;
+        break;
+
+    OP_LBL (0400)
+    case 004:                                           /* BIC */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadMW (GeteaW (dstspec));
+            src = R[srcspec];
+            }
+        else {
+            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            }
+        dst = src2 & ~src;
+        N = GET_SIGN_W (dst);
+        Z = GET_Z (dst);
+        V = 0;
+        if (dstreg)
+            R[dstspec] = dst;
+        else PWriteW (dst, last_pa);
+        break;
+
+    OP_LBL (0500)
+    case 005:                                           /* BIS */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadMW (GeteaW (dstspec));
+            src = R[srcspec];
+            }
+        else {
+            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            }
+        dst = src2 | src;
+        N = GET_SIGN_W (dst);
+        Z = GET_Z (dst);
+        V = 0;
+        if (dstreg)
+            R[dstspec] = dst;
+        else PWriteW (dst, last_pa);
+        break;
+
+    OP_LBL (0600)
+    case 006:                                           /* ADD */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadMW (GeteaW (dstspec));
+            src = R[srcspec];
+            }
+        else {
+            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            }
+        dst = (src2 + src) & 0177777;
+        N = GET_SIGN_W (dst);
+        Z = GET_Z (dst);
+        V = GET_SIGN_W ((~src ^ src2) & (src ^ dst));
+        C = (dst < src);
+        if (dstreg)
+            R[dstspec] = dst;
+        else PWriteW (dst, last_pa);
+        break;
+
+/* Opcode 07: EIS, FIS, CIS
+
+   Notes:
+   - The code assumes that the host int length is at least 32 bits.
+   - MUL carry: C is set if the (signed) result doesn't fit in 16 bits.
+   - Divide has three error cases:
+        1. Divide by zero.
+        2. Divide largest negative number by -1.
+        3. (Signed) quotient doesn't fit in 16 bits.
+     Cases 1 and 2 must be tested in advance, to avoid C runtime errors.
+   - ASHx left: overflow if the bits shifted out do not equal the sign
+     of the result (convert shift out to 1/0, xor against sign).
+   - ASHx right: if right shift sign extends, then the shift and
+     conditional or of shifted -1 is redundant.  If right shift zero
+     extends, then the shift and conditional or does sign extension.
+*/
+
+    OP_LBL (0700)
+    case 007:
+        srcspec = srcspec & 07;
+        switch ((IR >> 9) & 07)  {                      /* decode IR<11:9> */
+
+        case 0:                                         /* MUL */
+            if (!CPUO (OPT_EIS)) {
+                setTRAP (TRAP_ILL);
+                break;
+                }
+            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+            src = R[srcspec];
+            if (GET_SIGN_W (src2))
+                src2 = src2 | ~077777;
+            if (GET_SIGN_W (src))
+                src = src | ~077777;
+            dst = src * src2;
+            R[srcspec] = (dst >> 16) & 0177777;
+            R[srcspec | 1] = dst & 0177777;
+            N = (dst < 0);
+            Z = GET_Z (dst);
+            V = 0;
+            C = ((dst > 077777) || (dst < -0100000));
+            break;
+
+        case 1:                                         /* DIV */
+            if (!CPUO (OPT_EIS)) {
+                setTRAP (TRAP_ILL);
+                break;
+                }
+            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+            src = (((uint32) R[srcspec]) << 16) | R[srcspec | 1];
+            if (src2 == 0) {
+                N = 0;                                  /* J11,11/70 compat */
+                Z = V = C = 1;                          /* N = 0, Z = 1 */
+                break;
+                }
+            if ((((uint32)src) == 020000000000) && (src2 == 0177777)) {
+                V = 1;                                  /* V = 1 */
+                N = Z = C = 0;                          /* N = Z = 0 */
+                break;
+                }
+            if (GET_SIGN_W (src2))
+                src2 = src2 | ~077777;
+            if (GET_SIGN_W (R[srcspec]))
+                src = src | ~017777777777;
+            dst = src / src2;
+            N = (dst < 0);                              /* N set on 32b result */
+            if ((dst > 077777) || (dst < -0100000)) {
+                V = 1;                                  /* V = 1 */
+                Z = C = 0;                              /* Z = C = 0 */
+                break;
+                }
+            R[srcspec] = dst & 0177777;
+            R[srcspec | 1] = (src - (src2 * dst)) & 0177777;
+            Z = GET_Z (dst);
+            V = C = 0;
+            break;
+
+        case 2:                                         /* ASH */
+            if (!CPUO (OPT_EIS)) {
+                setTRAP (TRAP_ILL);
+                break;
+                }
+            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+            src2 = src2 & 077;
+            sign = GET_SIGN_W (R[srcspec]);
+            src = sign? R[srcspec] | ~077777: R[srcspec];
+            if (src2 == 0) {                            /* [0] */
+                dst = src;
+                V = C = 0;
+                }
+            else if (src2 <= 15) {                      /* [1,15] */
+                dst = src << src2;
+                i = (src >> (16 - src2)) & 0177777;
+                V = (i != ((dst & 0100000)? 0177777: 0));
+                C = (i & 1);
+                }
+            else if (src2 <= 31) {                      /* [16,31] */
+                dst = 0;
+                V = (src != 0);
+                C = (src << (src2 - 16)) & 1;
+                }
+            else if (src2 == 32) {                      /* [32] = -32 */
+                dst = -sign;
+                V = 0;
+                C = sign;
+                }
+            else {                                      /* [33,63] = -31,-1 */
+                dst = (src >> (64 - src2)) | (-sign << (src2 - 32));
+                V = 0;
+                C = ((src >> (63 - src2)) & 1);
+                }
+            dst = R[srcspec] = dst & 0177777;
+            N = GET_SIGN_W (dst);
+            Z = GET_Z (dst);
+            break;
+
+        case 3:                                         /* ASHC */
+            if (!CPUO (OPT_EIS)) {
+                setTRAP (TRAP_ILL);
+                break;
+                }
+            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+            src2 = src2 & 077;
+            sign = GET_SIGN_W (R[srcspec]);
+            src = (((uint32) R[srcspec]) << 16) | R[srcspec | 1];
+            if (src2 == 0) {                            /* [0] */
+                dst = src;
+                V = C = 0;
+                }
+            else if (src2 <= 31) {                      /* [1,31] */
+                dst = ((uint32) src) << src2;
+                i = (src >> (32 - src2)) | (-sign << src2);
+                V = (i != ((dst & 020000000000)? -1: 0));
+                C = (i & 1);
+                }
+            else if (src2 == 32) {                      /* [32] = -32 */
+                dst = -sign;
+                V = 0;
+                C = sign;
+                }
+            else {                                      /* [33,63] = -31,-1 */
+                dst = (src >> (64 - src2)) | (-sign << (src2 - 32));
+                V = 0;
+                C = ((src >> (63 - src2)) & 1);
+                }
+            i = R[srcspec] = (dst >> 16) & 0177777;
+            dst = R[srcspec | 1] = dst & 0177777;
+            N = GET_SIGN_W (i);
+            Z = GET_Z (dst | i);
+            break;
+
+        case 4:                                         /* XOR */
+            if (CPUT (HAS_SXS)) {
+                if (CPUT (IS_SDSD) && !dstreg) {        /* R,not R */
+                    src2 = ReadMW (GeteaW (dstspec));
+                    src = R[srcspec];
+                    }
+                else {
+                    src = R[srcspec];
+                    src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+                    }
+                dst = src ^ src2;
+                N = GET_SIGN_W (dst);
+                Z = GET_Z (dst);
+                V = 0;
+                if (dstreg)
+                    R[dstspec] = dst;
+                else PWriteW (dst, last_pa);
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        case 5:                                         /* FIS */
+            if (CPUO (OPT_FIS))
+                fis11 (IR);
+            else setTRAP (TRAP_ILL);
+            break;
+
+        case 6:                                         /* CIS */
+            if (CPUT (CPUT_60) && (cm == MD_KER) &&     /* 11/60 MED? */
+                (IR == 076600)) {
+                ReadE (PC | isenable);                  /* read immediate */
+                PC = (PC + 2) & 0177777;
+                }
+            else if (CPUO (OPT_CIS))                    /* CIS option? */
+                reason = cis11 (IR);
+            else setTRAP (TRAP_ILL);
+            break;
+
+        case 7:                                         /* SOB */
+            if (CPUT (HAS_SXS)) {
+                R[srcspec] = (R[srcspec] - 1) & 0177777;
+                if (R[srcspec]) {
+                    JMP_PC ((PC - dstspec - dstspec) & 0177777);
+                    }
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+            }                                           /* end switch EIS */
+        break;                                          /* end case 007 */
+
+/* Opcode 10: branches, traps, SOPs */
+
+    case 010:
+        switch ((IR >> 6) & 077) {                      /* decode IR<11:6> */
+
+        OP_LBL (1000)
+        case 000: case 001:                             /* BPL */
+            if (N == 0) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (1002)
+        case 002: case 003:                             /* BPL */
+            if (N == 0) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (1004)
+        case 004: case 005:                             /* BMI */
+            if (N) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (1006)
+        case 006: case 007:                             /* BMI */
+            if (N) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (1010)
+        case 010: case 011:                             /* BHI */
+            if ((C | Z) == 0) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (1012)
+        case 012: case 013:                             /* BHI */
+            if ((C | Z) == 0) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (1014)
+        case 014: case 015:                             /* BLOS */
+            if (C | Z) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (1016)
+        case 016: case 017:                             /* BLOS */
+            if (C | Z) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (1020)
+        case 020: case 021:                             /* BVC */
+            if (V == 0) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (1022)
+        case 022: case 023:                             /* BVC */
+            if (V == 0) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (1024)
+        case 024: case 025:                             /* BVS */
+            if (V) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (1026)
+        case 026: case 027:                             /* BVS */
+            if (V) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (1030)
+        case 030: case 031:                             /* BCC */
+            if (C == 0) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (1032)
+        case 032: case 033:                             /* BCC */
+            if (C == 0) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (1034)
+        case 034: case 035:                             /* BCS */
+            if (C) {
+                BRANCH_F (IR);
+                } 
+            break;
+
+        OP_LBL (1036)
+        case 036: case 037:                             /* BCS */
+            if (C) {
+                BRANCH_B (IR);
+                }
+            break;
+
+        OP_LBL (1040)
+        case 040: case 041: case 042: case 043:         /* EMT */
+            setTRAP (TRAP_EMT);
+            break;
+
+        OP_LBL (1044)
+        case 044: case 045: case 046: case 047:         /* TRAP */
+            setTRAP (TRAP_TRAP);
+            break;
+
+        OP_LBL (1050)
+        case 050:                                       /* CLRB */
+            if (!dstreg)
+                pa = TestMB (GeteaB (dstspec));
+            N = V = C = 0;                              /* now update CCs */
+            Z = 1;
+            if (dstreg)
+                R[dstspec] = R[dstspec] & 0177400;
+            else PWriteB (0, pa);
+            break;
+
+        OP_LBL (1051)
+        case 051:                                       /* COMB */
+            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = (dst ^ 0377) & 0377;
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            V = 0;
+            C = 1;
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+        OP_LBL (1052)
+        case 052:                                       /* INCB */
+            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = (dst + 1) & 0377;
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            V = (dst == 0200);
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+        OP_LBL (1053)
+        case 053:                                       /* DECB */
+            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = (dst - 1) & 0377;
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            V = (dst == 0177);
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+        OP_LBL (1054)
+        case 054:                                       /* NEGB */
+            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = (-dst) & 0377;
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            V = (dst == 0200);
+            C = (Z ^ 1);
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+        OP_LBL (1055)
+        case 055:                                       /* ADCB */
+            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = (dst + C) & 0377;
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            V = (C && (dst == 0200));
+            C = C & Z;
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+        OP_LBL (1056)
+        case 056:                                       /* SBCB */
+            dst = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = (dst - C) & 0377;
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            V = (C && (dst == 0177));
+            C = (C && (dst == 0377));
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+        OP_LBL (1057)
+        case 057:                                       /* TSTB */
+            dst = dstreg? R[dstspec] & 0377: ReadB (GeteaB (dstspec));
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            V = C = 0;
+            break;
+
+        OP_LBL (1060)
+        case 060:                                       /* RORB */
+            src = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = ((src & 0377) >> 1) | (C << 7);
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            C = (src & 1);
+            V = N ^ C;
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+        OP_LBL (1061)
+        case 061:                                       /* ROLB */
+            src = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = ((src << 1) | C) & 0377;
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            C = GET_SIGN_B (src & 0377);
+            V = N ^ C;
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+        OP_LBL (1062)
+        case 062:                                       /* ASRB */
+            src = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = ((src & 0377) >> 1) | (src & 0200);
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            C = (src & 1);
+            V = N ^ C;
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+        OP_LBL (1063)
+        case 063:                                       /* ASLB */
+            src = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            dst = (src << 1) & 0377;
+            N = GET_SIGN_B (dst);
+            Z = GET_Z (dst);
+            C = GET_SIGN_B (src & 0377);
+            V = N ^ C;
+            if (dstreg)
+                R[dstspec] = (R[dstspec] & 0177400) | dst;
+            else PWriteB (dst, last_pa);
+            break;
+
+/* Notes:
+   - MTPS cannot alter the T bit
+   - MxPD must mask GeteaW returned address, dspace is from cm not pm
+   - MxPD must set MMR1 for SP recovery in case of fault
+*/
+
+        OP_LBL (1064)
+        case 064:                                       /* MTPS */
+            if (CPUT (HAS_MXPS)) {
+                dst = dstreg? R[dstspec]: ReadB (GeteaB (dstspec));
+                if (cm == MD_KER) {
+                    ipl = (dst >> PSW_V_IPL) & 07;
+                    trap_req = calc_ints (ipl, trap_req);
+                    }
+                N = (dst >> PSW_V_N) & 01;
+                Z = (dst >> PSW_V_Z) & 01;
+                V = (dst >> PSW_V_V) & 01;
+                C = (dst >> PSW_V_C) & 01;
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (1065)
+        case 065:                                       /* MFPD */
+            if (CPUT (HAS_MXPY)) {
+                if (dstreg) {
+                    if ((dstspec == 6) && (cm != pm))
+                        dst = STACKFILE[pm];
+                    else dst = R[dstspec];
+                    }
+                else dst = ReadW ((GeteaW (dstspec) & 0177777) | calc_ds (pm));
+                SP = (SP - 2) & 0177777;
+                if (update_MM)
+                    MMR1 = calc_MMR1 (0366);
+                if ((cm == MD_KER) && (SP < (STKLIM + STKL_Y)))
+                    set_stack_trap (SP);
+                pa = TestMW (SP | dsenable);
+                N = GET_SIGN_W (dst);                   /* now update CCs */
+                Z = GET_Z (dst);
+                V = 0;
+                PWriteW (dst, pa);
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (1066)
+        case 066:                                       /* MTPD */
+            if (CPUT (HAS_MXPY)) {
+                dst = ReadW (SP | dsenable);
+                SP = (SP + 2) & 0177777;
+                if (update_MM)
+                    MMR1 = 026;
+                if (!dstreg)
+                    pa = TestMW ((GeteaW (dstspec) & 0177777) | calc_ds (pm));
+                N = GET_SIGN_W (dst);                   /* now set CCs */
+                Z = GET_Z (dst);
+                V = 0;
+               if (dstreg) {
+                    if ((dstspec == 6) && (cm != pm))
+                        STACKFILE[pm] = dst;
+                    else R[dstspec] = dst;
+                    }
+               else PWriteW (dst, pa);
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        OP_LBL (1067)
+        case 067:                                       /* MFPS */
+            if (CPUT (HAS_MXPS)) {
+                dst = get_PSW () & 0377;
+                if (!dstreg)
+                    pa = TestMB (GeteaB (dstspec));
+                N = GET_SIGN_B (dst);
+                Z = GET_Z (dst);
+                V = 0;
+                if (dstreg)
+                    R[dstspec] = (dst & 0200)? 0177400 | dst: dst;
+                else PWriteB (dst, pa);
+                }
+            else setTRAP (TRAP_ILL);
+            break;
+
+        default:
+            setTRAP (TRAP_ILL);
+            break;
+            }                                           /* end switch SOPs */
+        break;                                          /* end case 010 */
+
+/* Opcodes 11 - 16: double operand byte instructions
+
+   Cmp: v = [sign (src) != sign (src2)] and [sign (src2) = sign (result)]
+   Sub: v = [sign (src) != sign (src2)] and [sign (src) = sign (result)]
+*/
+
+    OP_LBL (1100)
+    case 011:                                           /* MOVB */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            pa = TestMB (GeteaB (dstspec));
+            dst = R[srcspec] & 0377;
+            }
+        else {
+            dst = srcreg? R[srcspec] & 0377: ReadB (GeteaB (srcspec));
+            if (!dstreg)
+                pa = TestMB (GeteaB (dstspec));
+            }
+        N = GET_SIGN_B (dst);
+        Z = GET_Z (dst);
+        V = 0;
+        if (dstreg)
+            R[dstspec] = (dst & 0200)? 0177400 | dst: dst;
+        else PWriteB (dst, pa);
+        break;
+
+    OP_LBL (1200)
+    case 012:                                           /* CMPB */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadB (GeteaB (dstspec));
+            src = R[srcspec] & 0377;
+            }
+        else {
+            src = srcreg? R[srcspec] & 0377: ReadB (GeteaB (srcspec));
+            src2 = dstreg? R[dstspec] & 0377: ReadB (GeteaB (dstspec));
+            }
+        dst = (src - src2) & 0377;
+        N = GET_SIGN_B (dst);
+        Z = GET_Z (dst);
+        V = GET_SIGN_B ((src ^ src2) & (~src2 ^ dst));
+        C = (src < src2);
+        break;
+
+    OP_LBL (1300)
+    case 013:                                           /* BITB */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadB (GeteaB (dstspec));
+            src = R[srcspec] & 0377;
+            }
+        else {
+            src = srcreg? R[srcspec] & 0377: ReadB (GeteaB (srcspec));
+            src2 = dstreg? R[dstspec] & 0377: ReadB (GeteaB (dstspec));
+            }
+        dst = (src2 & src) & 0377;
+        N = GET_SIGN_B (dst);
+        Z = GET_Z (dst);
+        V = 0;
+        break;
+
+    OP_LBL (1400)
+    case 014:                                           /* BICB */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadMB (GeteaB (dstspec));
+            src = R[srcspec];
+            }
+        else {
+            src = srcreg? R[srcspec]: ReadB (GeteaB (srcspec));
+            src2 = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            }
+        dst = (src2 & ~src) & 0377;
+        N = GET_SIGN_B (dst);
+        Z = GET_Z (dst);
+        V = 0;
+        if (dstreg)
+            R[dstspec] = (R[dstspec] & 0177400) | dst;
+        else PWriteB (dst, last_pa);
+        break;
+
+    OP_LBL (1500)
+    case 015:                                           /* BISB */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadMB (GeteaB (dstspec));
+            src = R[srcspec];
+            }
+        else {
+            src = srcreg? R[srcspec]: ReadB (GeteaB (srcspec));
+            src2 = dstreg? R[dstspec]: ReadMB (GeteaB (dstspec));
+            }
+        dst = (src2 | src) & 0377;
+        N = GET_SIGN_B (dst);
+        Z = GET_Z (dst);
+        V = 0;
+        if (dstreg)
+            R[dstspec] = (R[dstspec] & 0177400) | dst;
+        else PWriteB (dst, last_pa);
+        break;
+
+    OP_LBL (1600)
+    case 016:                                           /* SUB */
+        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
+            src2 = ReadMW (GeteaW (dstspec));
+            src = R[srcspec];
+            }
+        else {
+            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+            }
+        dst = (src2 - src) & 0177777;
+        N = GET_SIGN_W (dst);
+        Z = GET_Z (dst);
+        V = GET_SIGN_W ((src ^ src2) & (~src ^ dst));
+        C = (src2 < src);
+        if (dstreg)
+            R[dstspec] = dst;
+        else PWriteW (dst, last_pa);
+        break;
+
+/* Opcode 17: floating point */
+
+    OP_LBL (1700)
+    case 017:
+        if (CPUO (OPT_FPP))
+            fp11 (IR);                                  /* call fpp */
+        else setTRAP (TRAP_ILL);
+        break;                                          /* end case 017 */
+        }                                               /* end switch op */
+    }                                                   /* end main loop */
+return reason;
+}
+
+#undef CPUT
+#define CPUT(x)         ((cpu_type & (x)) != 0)
+#undef CORE_NAME
+#undef CORE_TYPES
@@ -114,6 +114,11 @@
 #define MEMSIZE         (cpu_unit.capac)
 #define DMASK           0177777
 
+/* CPU unit flags shared with the instruction modules */
+
+#define UNIT_V_HOSTFP   (UNIT_V_UF + 1)                 /* host FP fast path */
+#define UNIT_HOSTFP     (1u << UNIT_V_HOSTFP)
+
 /* CPU models */
 
 #define MOD_1103        0
@@ -90,6 +90,8 @@ extern int32 int_req[IPL_HLVL];
 #define DZ_LNOMASK      (DZ_LINES - 1)                  /* mask for lineno */
 #define DZ_LMASK        ((1 << DZ_LINES) - 1)           /* mask of lines */
 #define DZ_SILO_ALM     16                              /* silo alarm level */
+#define UNIT_V_FASTLN   (TTUF_V_UF + 0)                 /* fast line mode */
+#define UNIT_FASTLN     (1 << UNIT_V_FASTLN)
 
 /* DZCSR - 160100 - control/status register */
 
@@ -158,6 +160,7 @@ uint32 dz_rxi = 0;                                      /* rcv interrupts */
 uint32 dz_txi = 0;                                      /* xmt interrupts */
 int32 dz_mctl = 0;                                      /* modem ctrl enabled */
 int32 dz_auto = 0;                                      /* autodiscon enabled */
+int32 dz_txflush = 64;                                  /* fast line flush lvl */
 TMLN dz_ldsc[DZ_MUXES * DZ_LINES] = { 0 };              /* line descriptors */
 TMXR dz_desc = { DZ_MUXES * DZ_LINES, 0, 0, dz_ldsc };  /* mux descriptor */
 
@@ -209,6 +212,7 @@ REG dz_reg[] = {
     { GRDATA (TXINT, dz_txi, DEV_RDX, DZ_MUXES, 0) },
     { FLDATA (MDMCTL, dz_mctl, 0) },
     { FLDATA (AUTODS, dz_auto, 0) },
+    { DRDATA (TXFLUSH, dz_txflush, 9), PV_LEFT },
     { GRDATA (DEVADDR, dz_dib.ba, DEV_RDX, 32, 0), REG_HRO },
     { GRDATA (DEVVEC, dz_dib.vec, DEV_RDX, 16, 0), REG_HRO },
     { NULL }
@@ -218,6 +222,8 @@ MTAB dz_mod[] = {
     { TT_MODE, TT_MODE_7B, "7b", "7B", NULL },
     { TT_MODE, TT_MODE_8B, "8b", "8B", NULL },
     { TT_MODE, TT_MODE_7P, "7p", "7P", NULL },
+    { UNIT_FASTLN, 0, NULL, "NOFASTLINE", NULL },
+    { UNIT_FASTLN, UNIT_FASTLN, "fast line", "FASTLINE", NULL },
     { MTAB_XTD | MTAB_VDV, 1, NULL, "DISCONNECT",
       &tmxr_dscln, NULL, &dz_desc },
     { UNIT_ATT, UNIT_ATT, "summary", NULL,
@@ -309,7 +315,10 @@ switch ((PA >> 1) & 03) {                               /* case on PA<2:1> */
             dz_clear (dz, FALSE);
         if (data & CSR_MSE)                             /* MSE? start poll */
             sim_activate (&dz_unit, clk_cosched (tmxr_poll));
-        else dz_csr[dz] &= ~(CSR_SA | CSR_RDONE | CSR_TRDY);
+        else {
+            dz_csr[dz] &= ~(CSR_SA | CSR_RDONE | CSR_TRDY);
+            tmxr_poll_tx (&dz_desc);                    /* flush held output */
+            }
         if ((data & CSR_RIE) == 0)                      /* RIE = 0? */
             dz_clr_rxint (dz);
         else if (((dz_csr[dz] & CSR_IE) == 0) &&        /* RIE 0->1? */
@@ -373,7 +382,10 @@ switch ((PA >> 1) & 03) {                               /* case on PA<2:1> */
             c = sim_tt_outcvt (dz_tdr[dz], TT_GET_MODE (dz_unit.flags));
             if (c >= 0)                                 /* store char */
                 tmxr_putc_ln (lp, c);
-            tmxr_poll_tx (&dz_desc);                    /* poll output */
+            if (((dz_unit.flags & UNIT_FASTLN) == 0) || /* not fast line, */
+                (lp->xmte == 0) ||                      /* buffer filling, */
+                (tmxr_tqln (lp) >= dz_txflush))         /* or at flush lvl? */
+                tmxr_poll_tx (&dz_desc);                /* poll output */
             dz_update_xmti ();                          /* update int */
             }
         break;
@@ -389,6 +401,9 @@ return SCPE_OK;
    simulator, so for most environments, it is calibrated to real time.
    Typical polling intervals are 50-60 times per second.
 
+   In fast line mode, TDR writes only buffer the character; the buffer is
+   flushed here, or sooner if it reaches TXFLUSH characters or fills up.
+
    The simulator assumes that software enables all of the multiplexors,
    or none of them.
 */
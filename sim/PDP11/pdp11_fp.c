@@ -104,6 +104,7 @@
 */
 
 #include "pdp11_defs.h"
+#include <float.h>
 
 /* Floating point status register */
 
@@ -236,6 +237,7 @@ extern int32 R[8];
 extern int32 STKLIM;
 extern int32 cm, isenable, dsenable, MMR0, MMR1;
 extern fpac_t FR[6];
+extern UNIT cpu_unit;
 
 fpac_t zero_fac = { 0, 0 };
 fpac_t one_fac = { 1, 0 };
@@ -935,6 +937,150 @@ else return SCPE_IERR;                                  /* what??? */
 return SCPE_OK;
 }
 
+/* Host floating point fast path
+
+   With SET CPU HOSTFP, add, subtract, multiply, and divide (FP11 and FIS)
+   are done in host IEEE double precision, on hosts that evaluate double
+   expressions in double (FLT_EVAL_METHOD 0), whenever the result is
+   provably identical to that of the routines below.  FP11 operands with
+   at most 53 significant bits are exact in double, and the exponent
+   range of the FP11 is well inside that of the host.
+
+   - A sum is used only if it is exact (TwoSum error of zero).  The
+     routines below are then also exact, since the alignment shift only
+     discards bits that an exact 53b result cannot have.
+   - A product is exact for F operands (24b x 24b); for D operands, it
+     is used only if the operands have at most 53 significant bits
+     between them.
+   - An F quotient is correctly rounded to 53b.  A quotient of 24b
+     fractions is never a tie, and is always at least 2**-49 away from
+     any 25b boundary, so rounding the host quotient to F gives the same
+     result as rounding the exact quotient.  D quotients are always done
+     in software.
+
+   An F result is rounded (half away from zero) or truncated (FPS<T>) to
+   24b; a D result is exact and needs no rounding.  Everything else -
+   zero or dirty zero operands, D operands with more than 53 significant
+   bits, overflow and underflow - returns FALSE, and the caller uses the
+   software routines, which also handle the traps and the interrupt
+   enables.
+*/
+
+#if defined (FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+
+typedef union {
+    double              d;
+    t_uint64            i;
+    } HFP;
+
+#define HF_SIGN         0x8000000000000000              /* sign */
+#define HF_V_EXP        52                              /* exponent */
+#define HF_FRAC         0x000FFFFFFFFFFFFF              /* fraction */
+#define HF_OFF          (1023 - FP_BIAS - 1)            /* host exp - FP11 exp */
+#define HF_V_F          (HF_V_EXP - FP_V_HB)            /* F lsb */
+#define HF_FRND         (((t_uint64) 1) << (HF_V_F - 1)) /* F round */
+#define HF_V_D          (HF_V_EXP - FP_V_HB - 32)       /* D lsb, < 0 */
+
+#define HFP_ADD         0                               /* fac + fsrc */
+#define HFP_MUL         1                               /* fac * fsrc */
+#define HFP_DIV         2                               /* fac / fsrc */
+
+#define HFP_OP(op,fac,fsrc) \
+                        ((cpu_unit.flags & UNIT_HOSTFP) && hfp_op (op, fac, fsrc))
+
+static t_bool hfp_unpack (fpac_t *fptr, HFP *r)
+{
+int32 exp = GET_EXP (fptr->h);
+t_uint64 frac;
+
+if (exp == 0)                                           /* zero or dirty zero? */
+    return FALSE;
+frac = (((t_uint64) (fptr->h & FP_FRACH)) << 32) | fptr->l;
+if (frac & ((1u << -HF_V_D) - 1))                       /* more than 53b? */
+    return FALSE;
+r->i = (((t_uint64) (fptr->h & FP_SIGN)) << 32) |
+    (((t_uint64) (exp + HF_OFF)) << HF_V_EXP) | (frac >> -HF_V_D);
+return TRUE;
+}
+
+static t_bool hfp_pack (HFP *r, fpac_t *fptr)
+{
+t_uint64 mag = r->i & ~HF_SIGN;
+int32 exp;
+
+if (mag == 0) {                                         /* result 0? */
+    *fptr = zero_fac;
+    return TRUE;
+    }
+if ((FPS & FPS_D) == 0) {                               /* F? round to 24b */
+    if ((FPS & FPS_T) == 0)
+        mag = mag + HF_FRND;
+    mag = mag & ~(HF_FRND + HF_FRND - 1);
+    }
+exp = (int32) (mag >> HF_V_EXP) - HF_OFF;
+if ((exp <= 0) || (exp > FP_M_EXP))                     /* unfl or ovfl? */
+    return FALSE;
+mag = (mag & HF_FRAC) << -HF_V_D;
+fptr->h = ((r->i & HF_SIGN)? FP_SIGN: 0) | (exp << FP_V_EXP) |
+    (((uint32) (mag >> 32)) & FP_FRACH);
+fptr->l = ((uint32) mag) & FP_FRACL;
+return TRUE;
+}
+
+static int32 hfp_sigbits (t_uint64 i)
+{
+t_uint64 m = (i & HF_FRAC) | (HF_FRAC + 1);             /* 53b significand */
+int32 n = HF_V_EXP + 1;
+
+while ((m & 0xFF) == 0) {
+    m = m >> 8;
+    n = n - 8;
+    }
+while ((m & 1) == 0) {
+    m = m >> 1;
+    n = n - 1;
+    }
+return n;
+}
+
+static t_bool hfp_op (int32 op, fpac_t *facp, fpac_t *fsrcp)
+{
+HFP a, b, r;
+double bb;
+
+if (((op == HFP_DIV) && (FPS & FPS_D)) ||               /* D divide? */
+    !hfp_unpack (facp, &a) ||                           /* or unusable */
+    !hfp_unpack (fsrcp, &b))                            /* operands? */
+    return FALSE;
+switch (op) {
+
+    case HFP_ADD:
+        r.d = a.d + b.d;
+        bb = r.d - a.d;
+        if (((a.d - (r.d - bb)) + (b.d - bb)) != 0.0)   /* inexact? */
+            return FALSE;
+        break;
+
+    case HFP_MUL:
+        if ((FPS & FPS_D) &&                            /* D, inexact? */
+            ((hfp_sigbits (a.i) + hfp_sigbits (b.i)) > (HF_V_EXP + 1)))
+            return FALSE;
+        r.d = a.d * b.d;
+        break;
+
+    case HFP_DIV:
+        r.d = a.d / b.d;
+        break;
+        }
+return hfp_pack (&r, facp);
+}
+
+#else
+
+#define HFP_OP(op,fac,fsrc)     FALSE                   /* no host FP path */
+
+#endif
+
 /* Floating point add
 
    Inputs:
@@ -949,6 +1095,8 @@ int32 addfp11 (fpac_t *facp, fpac_t *fsrcp)
 int32 facexp, fsrcexp, ediff;
 fpac_t facfrac, fsrcfrac;
 
+if (HFP_OP (HFP_ADD, facp, fsrcp))                      /* host FP? */
+    return 0;
 if (F_LT_AP (facp, fsrcp)) {                            /* if !fac! < !fsrc! */
     facfrac = *facp;
     *facp = *fsrcp;                                     /* swap operands */
@@ -1024,6 +1172,8 @@ int32 mulfp11 (fpac_t *facp, fpac_t *fsrcp)
 int32 facexp, fsrcexp;
 fpac_t facfrac, fsrcfrac;
 
+if (HFP_OP (HFP_MUL, facp, fsrcp))                      /* host FP? */
+    return 0;
 facexp = GET_EXP (facp->h);                             /* get exponents */
 fsrcexp = GET_EXP (fsrcp->h);
 if ((facexp == 0) || (fsrcexp == 0)) {                  /* test for zero */
@@ -1217,6 +1367,8 @@ int32 divfp11 (fpac_t *facp, fpac_t *fsrcp)
 int32 facexp, fsrcexp, i, count, qd;
 fpac_t facfrac, fsrcfrac, quo;
 
+if (HFP_OP (HFP_DIV, facp, fsrcp))                      /* host FP? */
+    return 0;
 fsrcexp = GET_EXP (fsrcp->h);                           /* get divisor exp */
 facexp = GET_EXP (facp->h);                             /* get dividend exp */
 if (facexp == 0) {                                      /* test for zero */
@@ -350,6 +350,8 @@ int32 hk_cwait = 5;                                     /* command time */
 int32 hk_swait = 10;                                    /* seek time */
 int32 hk_rwait = 10;                                    /* rotate time */
 int32 hk_min2wait = 300;                                /* min time to 2nd int */
+DKTIME hk_dktm = { DKT_NORMAL, 0 };                     /* timing model */
+DKSTAT hk_dkst[HK_NUMDR] = { { 0 } };                   /* statistics */
 int16 hkdb[3] = { 0 };                                  /* data buffer silo */
 int16 hk_off[HK_NUMDR] = { 0 };                         /* saved offset */
 int16 hk_dif[HK_NUMDR] = { 0 };                         /* cylinder diff */
@@ -437,6 +439,8 @@ REG hk_reg[] = {
     { DRDATA (RTIME, hk_rwait, 24), REG_NZ + PV_LEFT },
     { DRDATA (M2TIME, hk_min2wait, 24), REG_NZ + PV_LEFT },
     { DRDATA (MIN2TIME, hk_min2wait, 24), REG_NZ + PV_LEFT + REG_HRO },
+    { DRDATA (TMODEL, hk_dktm.model, 2), REG_HRO },
+    { DRDATA (TFIXED, hk_dktm.fixed, 24), REG_HRO },
     { URDATA (FNC, hk_unit[0].FNC, DEV_RDX, 5, 0,
               HK_NUMDR, REG_HRO) },
     { URDATA (CYL, hk_unit[0].CYL, DEV_RDX, 10, 0,
@@ -472,6 +476,10 @@ MTAB hk_mod[] = {
       &set_addr, &show_addr, NULL },
     { MTAB_XTD|MTAB_VDV, 0, "VECTOR", "VECTOR",
       &set_vec, &show_vec, NULL },
+    { MTAB_XTD|MTAB_VDV, 0, "TIMING", "TIMING",
+      &dk_set_timing, &dk_show_timing, (void *) &hk_dktm },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "STATS", "CLRSTATS",
+      &dk_clr_stats, &dk_show_stats, (void *) hk_dkst },
     { 0 }
     };
 
@@ -806,7 +814,8 @@ switch (fnc) {                                          /* case on function */
         hk_dif[drv] = hkdc - uptr->CYL;                 /* cyl diff */
         t = abs (hk_dif[drv]);                          /* |cyl diff| */
         uptr->FNC = fnc;                                /* save function */
-        sim_activate (uptr, hk_rwait + (hk_swait * t)); /* schedule */
+        t = dk_delay (&hk_dktm, &hk_dkst[drv], hk_rwait + (hk_swait * t));
+        sim_activate (uptr, t);                         /* schedule */
         uptr->CYL = hkdc;                               /* update cyl */
         return;
 
@@ -872,6 +881,7 @@ switch (fnc) {                                          /* case on function */
             dc = (fnc == FNC_SEEK)? hkdc: 0;            /* get cyl */
             hk_dif[drv] = dc - uptr->CYL;               /* cyl diff */
             t = abs (hk_dif[drv]) * hk_swait;           /* |cyl diff| */
+            t = dk_delay (&hk_dktm, &hk_dkst[drv], t);
             if (t < hk_min2wait)                        /* min time */
                 t = hk_min2wait;
             uptr->CYL = dc;                             /* save cyl */          
@@ -934,11 +944,15 @@ switch (fnc) {                                          /* case on function */
             for (i = wc; i < awc; i++)                  /* fill buf */
                 hkxb[i] = 0;
             if (wc && !err) {                           /* write buf */
+                dk_xfer (&hk_dkst[drv], TRUE, da * sizeof (int16),
+                    awc * sizeof (uint16));
                 fxwrite (hkxb, sizeof (uint16), awc, uptr->fileref);
                 err = ferror (uptr->fileref);
                 }
             }                                           /* end if wr */
         else if (uptr->FNC == FNC_READ) {               /* read? */
+            dk_xfer (&hk_dkst[drv], FALSE, da * sizeof (int16),
+                wc * sizeof (uint16));
             i = fxread (hkxb, sizeof (uint16), wc, uptr->fileref);
             err = ferror (uptr->fileref);
             for ( ; i < wc; i++)                        /* fill buf */
@@ -958,6 +972,8 @@ switch (fnc) {                                          /* case on function */
                 }
             }                                           /* end if read */
         else {                                          /* wchk */                  
+            dk_xfer (&hk_dkst[drv], FALSE, da * sizeof (int16),
+                wc * sizeof (uint16));
             i = fxread (hkxb, sizeof (uint16), wc, uptr->fileref);
             err = ferror (uptr->fileref);
             for ( ; i < wc; i++)                        /* fill buf */
@@ -238,15 +238,59 @@ return uba_last;
      trimmed to 18b.
    - In a Qbus configuration, the map is always disabled.
      Device addresses are trimmed to 22b.
+
+   On little endian hosts (other than the UC15, whose memory is
+   shared with the PDP-15), the byte order of M matches the bus, so
+   transfers are done with memcpy, a run of contiguously mapped pages
+   at a time.
 */
 
+#if defined (UC15)
+#define MAP_BULK        0
+#else
+#define MAP_BULK        sim_end
+#endif
+
+/* Find the run of bus addresses from ba, below lim, that map to
+   contiguous memory starting at *ma; 0 if ba is not mapped to memory */
+
+static uint32 Map_Run (uint32 ba, uint32 lim, uint32 *ma)
+{
+uint32 run, pg;
+
+*ma = Map_Addr (ba);                                    /* map first page */
+if (!ADDR_IS_MEM (*ma))                                 /* NXM? */
+    return 0;
+run = UBM_PAGSIZE - UBM_GETOFF (ba);                    /* rest of page */
+while ((ba + run) < lim) {                              /* next page contig? */
+    pg = UBM_GETPN (ba + run);
+    if ((pg == UBM_M_PN) || ((ub_map[pg] & PAMASK) != (*ma + run)))
+        break;
+    run = run + UBM_PAGSIZE;
+    }
+if (run > (lim - ba))                                   /* limit to xfr */
+    run = lim - ba;
+if (!ADDR_IS_MEM (*ma + run - 1))                       /* and to memory */
+    run = MEMSIZE - *ma;
+return run;
+}
+
 int32 Map_ReadB (uint32 ba, int32 bc, uint8 *buf)
 {
-uint32 alim, lim, ma;
+uint32 alim, lim, ma, run;
 
 ba = ba & BUSMASK;                                      /* trim address */
 lim = ba + bc;
 if (cpu_bme) {                                          /* map enabled? */
+    if (MAP_BULK && (ba < lim)) {                       /* bulk? */
+        for ( ; ba < lim; ba = ba + run, buf = buf + run) {
+            if ((run = Map_Run (ba, lim, &ma)) == 0)    /* NXM? err */
+                return (lim - ba);
+            memcpy (buf, ((uint8 *) M) + ma, run);
+            }
+        Map_Addr (lim - 1);                             /* last addr mapped */
+        return 0;
+        }
     for ( ; ba < lim; ba++) {                           /* by bytes */
         ma = Map_Addr (ba);                             /* map addr */
         if (!ADDR_IS_MEM (ma))                          /* NXM? err */
@@ -261,6 +305,10 @@ else {                                                  /* physical */
     else if (ADDR_IS_MEM (ba))                          /* no, strt ok? */
         alim = MEMSIZE;
     else return bc;                                     /* no, err */
+    if (MAP_BULK) {                                     /* bulk? */
+        memcpy (buf, ((uint8 *) M) + ba, alim - ba);
+        return (lim - alim);
+        }
     for ( ; ba < alim; ba++) {                          /* by bytes */
         *buf++ = (uint8) RdMemB (ba);                   /* get byte */
         }
@@ -270,11 +318,20 @@ else {                                                  /* physical */
 
 int32 Map_ReadW (uint32 ba, int32 bc, uint16 *buf)
 {
-uint32 alim, lim, ma;
+uint32 alim, lim, ma, run;
 
 ba = (ba & BUSMASK) & ~01;                              /* trim, align addr */
 lim = ba + (bc & ~01);
 if (cpu_bme) {                                          /* map enabled? */
+    if (MAP_BULK && (ba < lim)) {                       /* bulk? */
+        for ( ; ba < lim; ba = ba + run, buf = buf + (run >> 1)) {
+            if ((run = Map_Run (ba, lim, &ma)) == 0)    /* NXM? err */
+                return (lim - ba);
+            memcpy (buf, ((uint8 *) M) + ma, run);
+            }
+        Map_Addr (lim - 2);                             /* last addr mapped */
+        return 0;
+        }
     for (; ba < lim; ba = ba + 2) {                     /* by words */
         ma = Map_Addr (ba);                             /* map addr */
         if (!ADDR_IS_MEM (ma))                          /* NXM? err */
@@ -289,6 +346,10 @@ else {                                                  /* physical */
     else if (ADDR_IS_MEM (ba))                          /* no, strt ok? */
         alim = MEMSIZE;
     else return bc;                                     /* no, err */
+    if (MAP_BULK) {                                     /* bulk? */
+        memcpy (buf, ((uint8 *) M) + ba, alim - ba);
+        return (lim - alim);
+        }
     for ( ; ba < alim; ba = ba + 2) {                   /* by words */
         *buf++ = (uint16) RdMemW (ba);
         }
@@ -298,11 +359,20 @@ else {                                                  /* physical */
 
 int32 Map_WriteB (uint32 ba, int32 bc, uint8 *buf)
 {
-uint32 alim, lim, ma;
+uint32 alim, lim, ma, run;
 
 ba = ba & BUSMASK;                                      /* trim address */
 lim = ba + bc;
 if (cpu_bme) {                                          /* map enabled? */
+    if (MAP_BULK && (ba < lim)) {                       /* bulk? */
+        for ( ; ba < lim; ba = ba + run, buf = buf + run) {
+            if ((run = Map_Run (ba, lim, &ma)) == 0)    /* NXM? err */
+                return (lim - ba);
+            memcpy (((uint8 *) M) + ma, buf, run);
+            }
+        Map_Addr (lim - 1);                             /* last addr mapped */
+        return 0;
+        }
     for ( ; ba < lim; ba++) {                           /* by bytes */
         ma = Map_Addr (ba);                             /* map addr */
         if (!ADDR_IS_MEM (ma))                          /* NXM? err */
@@ -317,6 +387,10 @@ else {                                                  /* physical */
     else if (ADDR_IS_MEM (ba))                          /* no, strt ok? */
         alim = MEMSIZE;
     else return bc;                                     /* no, err */
+    if (MAP_BULK) {                                     /* bulk? */
+        memcpy (((uint8 *) M) + ba, buf, alim - ba);
+        return (lim - alim);
+        }
     for ( ; ba < alim; ba++) {                          /* by bytes */
         WrMemB (ba, ((uint16) *buf++));
         }
@@ -326,11 +400,20 @@ else {                                                  /* physical */
 
 int32 Map_WriteW (uint32 ba, int32 bc, uint16 *buf)
 {
-uint32 alim, lim, ma;
+uint32 alim, lim, ma, run;
 
 ba = (ba & BUSMASK) & ~01;                              /* trim, align addr */
 lim = ba + (bc & ~01);
 if (cpu_bme) {                                          /* map enabled? */
+    if (MAP_BULK && (ba < lim)) {                       /* bulk? */
+        for ( ; ba < lim; ba = ba + run, buf = buf + (run >> 1)) {
+            if ((run = Map_Run (ba, lim, &ma)) == 0)    /* NXM? err */
+                return (lim - ba);
+            memcpy (((uint8 *) M) + ma, buf, run);
+            }
+        Map_Addr (lim - 2);                             /* last addr mapped */
+        return 0;
+        }
     for (; ba < lim; ba = ba + 2) {                     /* by words */
         ma = Map_Addr (ba);                             /* map addr */
         if (!ADDR_IS_MEM (ma))                          /* NXM? err */
@@ -345,6 +428,10 @@ else {                                                  /* physical */
     else if (ADDR_IS_MEM (ba))                          /* no, strt ok? */
         alim = MEMSIZE;
     else return bc;                                     /* no, err */
+    if (MAP_BULK) {                                     /* bulk? */
+        memcpy (((uint8 *) M) + ba, buf, alim - ba);
+        return (lim - alim);
+        }
     for ( ; ba < alim; ba = ba + 2) {                   /* by words */
         WrMemW (ba, *buf++);
         }
@@ -549,3 +549,141 @@ if (ferror (uptr->fileref))
     return SCPE_IOERR;
 return SCPE_OK;
 }
+
+/* Disk timing models and statistics
+
+   The disk controllers compute their own seek, rotation and transfer
+   delays.  dk_delay passes each delay through the controller's timing
+   model:
+
+        NORMAL          use the controller's delay unchanged
+        INSTANT         use DKT_MINWAIT, so transfers complete almost at
+                        once; the controller's own minimum still applies
+        n               use a fixed delay of n instructions
+
+   and accumulates it in the unit's statistics.  dk_xfer counts each host
+   transfer, and whether it started where the previous one ended.
+
+   Statistics are kept in an array of DKSTAT, indexed by unit number,
+   which is the desc argument of dk_show_stats and dk_clr_stats.  Only
+   entries for attachable units are used.
+*/
+
+int32 dk_delay (DKTIME *tm, DKSTAT *dks, int32 dly)
+{
+if (tm->model == DKT_INSTANT)
+    dly = DKT_MINWAIT;
+else if (tm->model == DKT_FIXED)
+    dly = tm->fixed;
+if (dks) {
+    dks->waits++;
+    dks->wtime = dks->wtime + dly;
+    }
+return dly;
+}
+
+void dk_xfer (DKSTAT *dks, t_bool wr, t_addr pos, uint32 bytes)
+{
+if ((dks->rdops || dks->wrops) && (pos == dks->nextpos))
+    dks->seqops++;
+if (wr) {
+    dks->wrops++;
+    dks->wrbytes = dks->wrbytes + bytes;
+    }
+else {
+    dks->rdops++;
+    dks->rdbytes = dks->rdbytes + bytes;
+    }
+dks->nextpos = pos + bytes;
+return;
+}
+
+/* Set/show timing model */
+
+t_stat dk_set_timing (UNIT *uptr, int32 val, char *cptr, void *desc)
+{
+DKTIME *tm = (DKTIME *) desc;
+int32 t;
+t_stat r;
+
+if ((cptr == NULL) || (tm == NULL))
+    return SCPE_ARG;
+if (strcmp (cptr, "NORMAL") == 0)
+    tm->model = DKT_NORMAL;
+else if (strcmp (cptr, "INSTANT") == 0)
+    tm->model = DKT_INSTANT;
+else {
+    t = (int32) get_uint (cptr, 10, 1000000, &r);
+    if ((r != SCPE_OK) || (t == 0))
+        return SCPE_ARG;
+    tm->model = DKT_FIXED;
+    tm->fixed = t;
+    }
+return SCPE_OK;
+}
+
+t_stat dk_show_timing (FILE *st, UNIT *uptr, int32 val, void *desc)
+{
+DKTIME *tm = (DKTIME *) desc;
+
+if (tm == NULL)
+    return SCPE_IERR;
+if (tm->model == DKT_INSTANT)
+    fprintf (st, "instant timing");
+else if (tm->model == DKT_FIXED)
+    fprintf (st, "fixed timing=%d", tm->fixed);
+else fprintf (st, "normal timing");
+return SCPE_OK;
+}
+
+/* Show/clear statistics */
+
+t_stat dk_show_stats (FILE *st, UNIT *uptr, int32 val, void *desc)
+{
+DKSTAT *dks;
+DEVICE *dptr;
+UNIT *up;
+uint32 i, ops;
+
+if ((uptr == NULL) || (desc == NULL) ||
+    ((dptr = find_dev_from_unit (uptr)) == NULL))
+    return SCPE_IERR;
+for (i = 0; i < dptr->numunits; i++) {
+    up = dptr->units + i;
+    if (((up->flags & UNIT_ATTABLE) == 0) || (up->flags & UNIT_DIS))
+        continue;
+    dks = ((DKSTAT *) desc) + i;
+    ops = dks->rdops + dks->wrops;
+    fprintf (st, "%s%d: %u reads (%.0f bytes), %u writes (%.0f bytes)\n",
+        sim_dname (dptr), i, dks->rdops, dks->rdbytes,
+        dks->wrops, dks->wrbytes);
+    fprintf (st, "  %u sequential, ", dks->seqops);
+    if (dks->waits)
+        fprintf (st, "average delay %.0f",
+            dks->wtime / (double) dks->waits);
+    else fprintf (st, "no delays");
+    if (ops)
+        fprintf (st, ", %.0f bytes/transfer",
+            (dks->rdbytes + dks->wrbytes) / (double) ops);
+    fprintf (st, "\n");
+    }
+return SCPE_OK;
+}
+
+t_stat dk_clr_stats (UNIT *uptr, int32 val, char *cptr, void *desc)
+{
+DKSTAT *dks = (DKSTAT *) desc;
+DEVICE *dptr;
+uint32 i;
+
+if (cptr != NULL)
+    return SCPE_ARG;
+if ((uptr == NULL) || (dks == NULL) ||
+    ((dptr = find_dev_from_unit (uptr)) == NULL))
+    return SCPE_IERR;
+for (i = 0; i < dptr->numunits; i++) {                  /* drives only */
+    if (dptr->units[i].flags & UNIT_ATTABLE)
+        memset (&dks[i], 0, sizeof (DKSTAT));
+    }
+return SCPE_OK;
+}
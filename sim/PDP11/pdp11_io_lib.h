@@ -27,6 +27,29 @@
 #ifndef PDP11_IO_LIB_H_
 #define PDP11_IO_LIB_H_    0
 
+/* Disk timing models and statistics */
+
+#define DKT_NORMAL      0                               /* controller's timing */
+#define DKT_INSTANT     1                               /* minimal delays */
+#define DKT_FIXED       2                               /* fixed delay */
+#define DKT_MINWAIT     10                              /* instant delay */
+
+typedef struct {
+    int32               model;                          /* timing model */
+    int32               fixed;                          /* fixed delay */
+    } DKTIME;
+
+typedef struct {
+    uint32              rdops;                          /* read transfers */
+    uint32              wrops;                          /* write transfers */
+    uint32              seqops;                         /* sequential xfers */
+    uint32              waits;                          /* delays scheduled */
+    double              rdbytes;                        /* bytes read */
+    double              wrbytes;                        /* bytes written */
+    double              wtime;                          /* total delay */
+    t_addr              nextpos;                        /* end of last xfer */
+    } DKSTAT;
+
 t_stat set_autocon (UNIT *uptr, int32 val, char *cptr, void *desc);
 t_stat show_autocon (FILE *st, UNIT *uptr, int32 val, void *desc);
 t_stat set_addr (UNIT *uptr, int32 val, char *cptr, void *desc);
@@ -40,5 +63,11 @@ t_stat auto_config (char *name, int32 nctrl);
 t_stat pdp11_bad_block (UNIT *uptr, int32 sec, int32 wds);
 void init_ubus_tab (void);
 t_stat build_ubus_tab (DEVICE *dptr, DIB *dibp);
+int32 dk_delay (DKTIME *tm, DKSTAT *dks, int32 dly);
+void dk_xfer (DKSTAT *dks, t_bool wr, t_addr pos, uint32 bytes);
+t_stat dk_set_timing (UNIT *uptr, int32 val, char *cptr, void *desc);
+t_stat dk_show_timing (FILE *st, UNIT *uptr, int32 val, void *desc);
+t_stat dk_show_stats (FILE *st, UNIT *uptr, int32 val, void *desc);
+t_stat dk_clr_stats (UNIT *uptr, int32 val, char *cptr, void *desc);
 
 #endif
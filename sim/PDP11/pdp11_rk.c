@@ -211,6 +211,8 @@ int32 last_drv = 0;                                     /* last r/w drive */
 int32 rk_stopioe = 1;                                   /* stop on error */
 int32 rk_swait = 10;                                    /* seek time */
 int32 rk_rwait = 10;                                    /* rotate time */
+DKTIME rk_dktm = { DKT_NORMAL, 0 };                     /* timing model */
+DKSTAT rk_dkst[RK_NUMDR] = { { 0 } };                   /* statistics */
 
 DEVICE rk_dev;
 t_stat rk_rd (int32 *data, int32 PA, int32 access);
@@ -270,6 +272,8 @@ REG rk_reg[] = {
     { FLDATA (IE, rkcs, CSR_V_IE) },
     { DRDATA (STIME, rk_swait, 24), PV_LEFT },
     { DRDATA (RTIME, rk_rwait, 24), PV_LEFT },
+    { DRDATA (TMODEL, rk_dktm.model, 2), REG_HRO },
+    { DRDATA (TFIXED, rk_dktm.fixed, 24), REG_HRO },
     { FLDATA (STOP_IOE, rk_stopioe, 0) },
     { ORDATA (DEVADDR, rk_dib.ba, 32), REG_HRO },
     { ORDATA (DEVVEC, rk_dib.vec, 16), REG_HRO },
@@ -283,6 +287,10 @@ MTAB rk_mod[] = {
       &set_addr, &show_addr, NULL },
     { MTAB_XTD|MTAB_VDV, 0, "VECTOR", "VECTOR",
       &set_vec, &show_vec, NULL },
+    { MTAB_XTD|MTAB_VDV, 0, "TIMING", "TIMING",
+      &dk_set_timing, &dk_show_timing, (void *) &rk_dktm },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "STATS", "CLRSTATS",
+      &dk_clr_stats, &dk_show_stats, (void *) rk_dkst },
     { 0 }
     };
 
@@ -483,9 +491,11 @@ if (cyl >= RK_NUMCY) {                                  /* bad cyl? */
 i = abs (cyl - uptr->CYL) * rk_swait;                   /* seek time */
 if (func == RKCS_SEEK) {                                /* seek? */
     rk_set_done (0);                                    /* set done */
+    i = dk_delay (&rk_dktm, &rk_dkst[uptr - rk_dev.units], i);
     sim_activate (uptr, MAX (RK_MIN, i));               /* schedule */
     }
-else sim_activate (uptr, i + rk_rwait);
+else sim_activate (uptr, dk_delay (&rk_dktm,
+    &rk_dkst[uptr - rk_dev.units], i + rk_rwait));
 uptr->FUNC = func;                                      /* save func */
 uptr->CYL = cyl;                                        /* put on cylinder */
 return;
@@ -561,6 +571,8 @@ if (wc && (err == 0)) {                                 /* seek ok? */
                 }                                       /* end for wc */
             }                                           /* end if format */
         else {                                          /* normal read */
+            dk_xfer (&rk_dkst[drv], FALSE, da * sizeof (RKCONTR),
+                wc * sizeof (RKCONTR));
             i = fxread (rkxb, sizeof (RKCONTR), wc, uptr->fileref);
             err = ferror (uptr->fileref);               /* read file */
             for ( ; i < wc; i++)                        /* fill buf */
@@ -599,12 +611,16 @@ if (wc && (err == 0)) {                                 /* seek ok? */
             awc = (wc + (RK_NUMWD - 1)) & ~(RK_NUMWD - 1); /* clr to */
             for (i = wc; i < awc; i++)                  /* end of blk */
                 rkxb[i] = 0;
+            dk_xfer (&rk_dkst[drv], TRUE, da * sizeof (RKCONTR),
+                awc * sizeof (RKCONTR));
             fxwrite (rkxb, sizeof (RKCONTR), awc, uptr->fileref);
             err = ferror (uptr->fileref);
             }
         break;                                          /* end write */
 
     case RKCS_WCHK:                                     /* write check */
+        dk_xfer (&rk_dkst[drv], FALSE, da * sizeof (RKCONTR),
+            wc * sizeof (RKCONTR));
         i = fxread (rkxb, sizeof (RKCONTR), wc, uptr->fileref);
         if ((err = ferror (uptr->fileref))) {           /* read error? */
             wc = 0;                                     /* no transfer */
@@ -238,6 +238,8 @@ int32 rlda = 0;                                         /* disk addr */
 uint16 rlmp = 0, rlmp1 = 0, rlmp2 = 0;                  /* mp register queue */
 int32 rl_swait = 10;                                    /* seek wait */
 int32 rl_rwait = 10;                                    /* rotate wait */
+DKTIME rl_dktm = { DKT_NORMAL, 0 };                     /* timing model */
+DKSTAT rl_dkst[RL_NUMDR] = { { 0 } };                   /* statistics */
 int32 rl_stopioe = 1;                                   /* stop on error */
 
 /* forward references */
@@ -299,6 +301,8 @@ static const REG rl_reg[] = {
     { FLDATA (IE, rlcs, CSR_V_IE) },
     { DRDATA (STIME, rl_swait, 24), PV_LEFT },
     { DRDATA (RTIME, rl_rwait, 24), PV_LEFT },
+    { DRDATA (TMODEL, rl_dktm.model, 2), REG_HRO },
+    { DRDATA (TFIXED, rl_dktm.fixed, 24), REG_HRO },
     { URDATA (CAPAC, rl_unit[0].capac, 10, T_ADDR_W, 0,
               RL_NUMDR, PV_LEFT + REG_HRO) },
     { FLDATA (STOP_IOE, rl_stopioe, 0) },
@@ -338,6 +342,10 @@ static const MTAB rl_mod[] = {
       &set_addr, &show_addr, NULL },
     { MTAB_XTD|MTAB_VDV, 0, "VECTOR", "VECTOR",
       &set_vec, &show_vec, NULL },
+    { MTAB_XTD|MTAB_VDV, 0, "TIMING", "TIMING",
+      &dk_set_timing, &dk_show_timing, (void *) &rl_dktm },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "STATS", "CLRSTATS",
+      &dk_clr_stats, &dk_show_stats, (void *) rl_dkst },
     { 0 }
     };
 
@@ -507,6 +515,7 @@ max 17ms for 1 track seek w/head switch
                     (int32) (uptr - rl_dev.units),
                     abs (newc - curr), (rlda & RLDA_SK_HD), tim);
             uptr->FNC = RLCS_SEEK;
+            tim = dk_delay (&rl_dktm, &rl_dkst[uptr - rl_dev.units], tim);
             sim_activate (uptr, tim);               /* must be > 0 */
             rl_set_done (0);                        /* ctrlr is ready */
             break;
@@ -553,7 +562,8 @@ operation now, and queue the next operation.
                 rl_svc (uptr);
                 }
             uptr->FNC = GET_FUNC (rlcs);
-            sim_activate (uptr, rl_swait);              /* activate unit */
+            sim_activate (uptr, dk_delay (&rl_dktm,     /* activate unit */
+                &rl_dkst[uptr - rl_dev.units], rl_swait));
             break;
             }                                           /* end switch func */
         break;                                          /* end case RLCS */
@@ -705,6 +715,7 @@ int32 err, wc, maxwc, t;
 int32 i, da, awc;
 uint32 ma;
 uint16 comp;
+DKSTAT *dks = &rl_dkst[uptr - rl_dev.units];
 static const char * const funcname[] = {
     "NOP", "WCK", "GSTA", "SEEK",
     "RHDR", "WT", "RD", "RNOHDR", "SPECIAL",
@@ -861,6 +872,7 @@ if (DEBUG_PRS (rl_dev))
     GET_CYL (rlda), GET_SECT (rlda), wc, maxwc, err);
 
     if ((uptr->FNC >= RLCS_READ) && (err == 0)) {       /* read (no hdr)? */
+        dk_xfer (dks, FALSE, da * sizeof (int16), wc * sizeof (int16));
         i = fxread (rlxb, sizeof (int16), wc, uptr->fileref);
         err = ferror (uptr->fileref);
         for ( ; i < wc; i++)                            /* fill buffer */
@@ -881,6 +893,7 @@ if ((uptr->FNC == RLCS_WRITE) && (err == 0)) {          /* write? */
         awc = (wc + (RL_NUMWD - 1)) & ~(RL_NUMWD - 1);  /* clr to */
         for (i = wc; i < awc; i++)                      /* end of blk */
             rlxb[i] = 0;
+        dk_xfer (dks, TRUE, da * sizeof (int16), awc * sizeof (int16));
         fxwrite (rlxb, sizeof (int16), awc, uptr->fileref);
         err = ferror (uptr->fileref);
         }
@@ -888,6 +901,7 @@ if ((uptr->FNC == RLCS_WRITE) && (err == 0)) {          /* write? */
 
 else
 if ((uptr->FNC == RLCS_WCHK) && (err == 0)) {           /* write check? */
+    dk_xfer (dks, FALSE, da * sizeof (int16), wc * sizeof (int16));
     i = fxread (rlxb, sizeof (int16), wc, uptr->fileref);
     err = ferror (uptr->fileref);
     for ( ; i < wc; i++)                                /* fill buffer */
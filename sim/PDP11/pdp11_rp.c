@@ -348,6 +348,8 @@ uint16 rpec2[RP_NUMDR] = { 0 };                         /* ECC correction 2 */
 int32 rp_stopioe = 1;                                   /* stop on error */
 int32 rp_swait = 26;                                    /* seek time */
 int32 rp_rwait = 10;                                    /* rotate time */
+DKTIME rp_dktm = { DKT_NORMAL, 0 };                     /* timing model */
+DKSTAT rp_dkst[RP_NUMDR] = { { 0 } };                   /* statistics */
 static const char *rp_fname[CS1_N_FNC] = {
     "NOP", "UNLD", "SEEK", "RECAL", "DCLR", "RLS", "OFFS", "RETN",
     "PRESET", "PACK", "12", "13", "SCH", "15", "16", "17",
@@ -415,6 +417,8 @@ REG rp_reg[] = {
     { BRDATA (MR2, rmmr2, DEV_RDX, 16, RP_NUMDR) },
     { DRDATA (STIME, rp_swait, 24), REG_NZ + PV_LEFT },
     { DRDATA (RTIME, rp_rwait, 24), REG_NZ + PV_LEFT },
+    { DRDATA (TMODEL, rp_dktm.model, 2), REG_HRO },
+    { DRDATA (TFIXED, rp_dktm.fixed, 24), REG_HRO },
     { URDATA (CAPAC, rp_unit[0].capac, 10, T_ADDR_W, 0,
               RP_NUMDR, PV_LEFT | REG_HRO) },
     { FLDATA (STOP_IOE, rp_stopioe, 0) },
@@ -465,6 +469,10 @@ MTAB rp_mod[] = {
       NULL, "RM05", &rp_set_size },
     { (UNIT_AUTO+UNIT_DTYPE), (RP07_DTYPE << UNIT_V_DTYPE),
       NULL, "RP07", &rp_set_size },
+    { MTAB_XTD|MTAB_VDV, 0, "TIMING", "TIMING",
+      &dk_set_timing, &dk_show_timing, (void *) &rp_dktm },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "STATS", "CLRSTATS",
+      &dk_clr_stats, &dk_show_stats, (void *) rp_dkst },
     { 0 }
     };
 
@@ -732,7 +740,8 @@ switch (fnc) {                                          /* case on function */
         t = abs (dc - uptr->CYL);                       /* cyl diff */
         if (t == 0)                                     /* min time */
             t = 1;
-        sim_activate (uptr, rp_swait * t);              /* schedule */
+        sim_activate (uptr, dk_delay (&rp_dktm, &rp_dkst[drv], /* schedule */
+            rp_swait * t));
         uptr->CYL = dc;                                 /* save cylinder */
         return SCPE_OK;
 
@@ -752,7 +761,8 @@ switch (fnc) {                                          /* case on function */
             break;
             }
         rpds[drv] = rpds[drv] & ~DS_RDY;                /* clear drive rdy */
-        sim_activate (uptr, rp_rwait + (rp_swait * abs (dc - uptr->CYL)));
+        sim_activate (uptr, dk_delay (&rp_dktm, &rp_dkst[drv],
+            rp_rwait + (rp_swait * abs (dc - uptr->CYL))));
         uptr->CYL = dc;                                 /* save cylinder */
         return SCPE_OK;
 
@@ -849,11 +859,15 @@ switch (fnc) {                                          /* case on function */
             for (i = wc; i < awc; i++)                  /* fill buf */
                 rpxb[i] = 0;
             if (wc && !err) {                           /* write buf */
+                dk_xfer (&rp_dkst[drv], TRUE, da * sizeof (int16),
+                    awc * sizeof (uint16));
                 fxwrite (rpxb, sizeof (uint16), awc, uptr->fileref);
                 err = ferror (uptr->fileref);
                 }
             }                                           /* end if wr */
         else {                                          /* read or wchk */
+            dk_xfer (&rp_dkst[drv], FALSE, da * sizeof (int16),
+                wc * sizeof (uint16));
             awc = fxread (rpxb, sizeof (uint16), wc, uptr->fileref);
             err = ferror (uptr->fileref);
             for (i = awc; i < wc; i++)                  /* fill buf */
@@ -801,6 +801,7 @@ int32 rq_itime = 200;                                   /* init time, except */
 int32 rq_itime4 = 10;                                   /* stage 4 */
 int32 rq_qtime = RQ_QTIME;                              /* queue time */
 int32 rq_xtime = RQ_XTIME;                              /* transfer time */
+DKTIME rq_dktm = { DKT_NORMAL, 0 };                     /* timing model */
 
 typedef struct {
     uint32              cnum;                           /* ctrl number */
@@ -825,6 +826,7 @@ typedef struct {
     struct uq_ring      cq;                             /* cmd ring */
     struct uq_ring      rq;                             /* rsp ring */
     struct rqpkt        pak[RQ_NPKTS];                  /* packet queue */
+    DKSTAT              dkst[RQ_NUMDR];                 /* drive statistics */
     } MSC;
 
 DEVICE rq_dev, rqb_dev, rqc_dev,rqd_dev;
@@ -844,6 +846,8 @@ t_stat rq_show_type (FILE *st, UNIT *uptr, int32 val, void *desc);
 t_stat rq_show_wlk (FILE *st, UNIT *uptr, int32 val, void *desc);
 t_stat rq_show_ctrl (FILE *st, UNIT *uptr, int32 val, void *desc);
 t_stat rq_show_unitq (FILE *st, UNIT *uptr, int32 val, void *desc);
+t_stat rq_show_stats (FILE *st, UNIT *uptr, int32 val, void *desc);
+t_stat rq_clr_stats (UNIT *uptr, int32 val, char *cptr, void *desc);
 
 t_bool rq_step4 (MSC *cp);
 t_bool rq_mscp (MSC *cp, int32 pkt, t_bool q);
@@ -938,6 +942,8 @@ REG rq_reg[] = {
     { DRDATA (I4TIME, rq_itime4, 24), PV_LEFT + REG_NZ },
     { DRDATA (QTIME, rq_qtime, 24), PV_LEFT + REG_NZ },
     { DRDATA (XTIME, rq_xtime, 24), PV_LEFT + REG_NZ },
+    { DRDATA (TMODEL, rq_dktm.model, 2), REG_HRO },
+    { DRDATA (TFIXED, rq_dktm.fixed, 24), REG_HRO },
     { XRDATA (PKTS, rq_ctx.pak, DEV_RDX, 16, 0, RQ_NPKTS * (RQ_PKT_SIZE_W + 1), sizeof (int16), sizeof (int16)) },
     { URDATA (CPKT, rq_unit[0].cpkt, 10, 5, 0, RQ_NUMDR, 0) },
     { URDATA (PKTQ, rq_unit[0].pktq, 10, 5, 0, RQ_NUMDR, 0) },
@@ -1033,6 +1039,10 @@ MTAB rq_mod[] = {
 #endif
     { MTAB_XTD|MTAB_VDV, 0, "VECTOR", NULL,
       NULL, &show_vec, NULL },
+    { MTAB_XTD|MTAB_VDV, 0, "TIMING", "TIMING",
+      &dk_set_timing, &dk_show_timing, (void *) &rq_dktm },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "STATS", "CLRSTATS",
+      &rq_clr_stats, &rq_show_stats, NULL },
     { 0 }
     };
 
@@ -1259,6 +1269,8 @@ static MSC *rq_ctxmap[RQ_NUMCT] = {
     &rq_ctx, &rqb_ctx, &rqc_ctx, &rqd_ctx
     };
 
+#define RQ_DKST(cp,u)   (&(cp)->dkst[(u) - rq_devmap[(u)->cnum]->units])
+
 /* I/O dispatch routines, I/O addresses 17772150 - 17772152
 
    base + 0     IP      read/write
@@ -1873,7 +1885,8 @@ if (uptr = rq_getucb (cp, lu)) {                        /* unit exist? */
         cp->pak[pkt].d[RW_WBCH] = cp->pak[pkt].d[RW_BCH];
         cp->pak[pkt].d[RW_WBLL] = cp->pak[pkt].d[RW_LBNL];
         cp->pak[pkt].d[RW_WBLH] = cp->pak[pkt].d[RW_LBNH];
-        sim_activate (uptr, rq_xtime);                  /* activate */
+        sim_activate (uptr, dk_delay (&rq_dktm,         /* activate */
+            RQ_DKST (cp, uptr), rq_xtime));
         return OK;                                      /* done */
         }
     }
@@ -1967,8 +1980,10 @@ if (cmd == OP_ERS) {                                    /* erase? */
     for (i = 0; i < wwc; i++)                           /* clr buf */
         rqxb[i] = 0;
     err = sim_fseek (uptr->fileref, da, SEEK_SET);      /* set pos */
-    if (!err)
+    if (!err) {
+        dk_xfer (RQ_DKST (cp, uptr), TRUE, da, wwc * sizeof (int16));
         sim_fwrite (rqxb, sizeof (int16), wwc, uptr->fileref);
+        }
     err = ferror (uptr->fileref);                       /* end if erase */
     }
 
@@ -1979,8 +1994,10 @@ else if (cmd == OP_WR) {                                /* write? */
         for (i = (abc >> 1); i < wwc; i++)
             rqxb[i] = 0;
         err = sim_fseek (uptr->fileref, da, SEEK_SET);
-        if (!err)
+        if (!err) {
+            dk_xfer (RQ_DKST (cp, uptr), TRUE, da, wwc * sizeof (int16));
             sim_fwrite (rqxb, sizeof (int16), wwc, uptr->fileref);
+            }
         err = ferror (uptr->fileref);
         }
     if (t) {                                            /* nxm? */
@@ -1995,6 +2012,7 @@ else if (cmd == OP_WR) {                                /* write? */
 else {
     err = sim_fseek (uptr->fileref, da, SEEK_SET);      /* set pos */
     if (!err) {
+        dk_xfer (RQ_DKST (cp, uptr), FALSE, da, tbc & ~1);
         i = sim_fread (rqxb, sizeof (int16), tbc >> 1, uptr->fileref);
         for ( ; i < (tbc >> 1); i++)                    /* fill */
             rqxb[i] = 0;
@@ -2042,7 +2060,7 @@ PUTP32 (pkt, RW_WBAL, ba);                              /* update pkt */
 PUTP32 (pkt, RW_WBCL, bc);
 PUTP32 (pkt, RW_WBLL, bl);
 if (bc)                                                 /* more? resched */
-    sim_activate (uptr, rq_xtime);
+    sim_activate (uptr, dk_delay (&rq_dktm, RQ_DKST (cp, uptr), rq_xtime));
 else rq_rw_end (cp, uptr, 0, ST_SUC);                   /* done! */
 return SCPE_OK;
 }
@@ -2845,6 +2863,18 @@ else fprintf (st, "Unit %d queues are empty\n", u);
 return SCPE_OK;
 }
 
+/* Show/clear drive statistics, kept per controller */
+
+t_stat rq_show_stats (FILE *st, UNIT *uptr, int32 val, void *desc)
+{
+return dk_show_stats (st, uptr, val, (void *) rq_ctxmap[uptr->cnum]->dkst);
+}
+
+t_stat rq_clr_stats (UNIT *uptr, int32 val, char *cptr, void *desc)
+{
+return dk_clr_stats (uptr, val, cptr, (void *) rq_ctxmap[uptr->cnum]->dkst);
+}
+
 t_stat rq_show_ctrl (FILE *st, UNIT *uptr, int32 val, void *desc)
 {
 MSC *cp = rq_ctxmap[uptr->cnum];
@@ -53,7 +53,10 @@
    side having read/write access, the other read-only. Actions are
    implemented by setting signals with an atomic compare-and-swap.
    The signals may be polled with non-atomic operations but must be
-   verified with an atomic compare-and-swap.
+   verified with an atomic compare-and-swap. After setting a signal,
+   the sender rings the receiver's doorbell; the receiver only checks
+   its signals when the doorbell has changed, and blocks on the doorbell
+   instead of sleeping when the PDP11 is idle.
 
    21-Jul-18    RMS         Fixed missing size multiplier in reset (Mark Pizzolato)
 */
@@ -92,6 +95,7 @@ int32 uca_buf = 0;                                      /* DR11C #1 input buffer
 int32 ucb_csr = 0;
 int32 ucb_buf = 0;
 int32 uc15_poll = 3;                                    /* polling interval */
+int32 uc15_ring = 0;                                    /* doorbell last seen */
 SHMEM *uc15_shmem = NULL;                               /* shared state identifier */
 int32 *uc15_shstate = NULL;                             /* shared state base */
 SHMEM *pdp15_shmem = NULL;                              /* PDP15 mem identifier */
@@ -109,6 +113,7 @@ t_stat uc15_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
 t_stat uc15_dep (t_value val, t_addr addr, UNIT *uptr, int32 sw);
 t_stat uc15_attach (UNIT *uptr, char *cptr);
 t_stat uc15_detach (UNIT *uptr);
+t_bool uc15_idle_wait (uint32 msec);
 
 void uc15_set_memsize (void);
 int32 uc15_get_uca_buf (void);
@@ -250,6 +255,7 @@ case 2:                                                 /* input buffer */
      ucb_csr &= ~UCBC_NTCB;                             /* clear TCBP rdy */
      CLR_INT (UCB);                                     /* clear int */
      UC15_ATOMIC_CAS (UC15_TCBP_RD, 0, 1);              /* send ACK */
+     UC15_RING (UC15_RING15);
      if (DEBUG_PRS (uca_dev)) {
         uint32 apiv, apil, fnc, tsk, pa;
         t_bool spl;
@@ -308,6 +314,7 @@ t_stat uc15_api_req (int32 lvl, int32 vec)
 {
 UC15_SHARED_WR (UC15_API_VEC + (lvl * UC15_API_VEC_MUL), vec);
 UC15_ATOMIC_CAS (UC15_API_REQ + (lvl * UC15_API_VEC_MUL), 0, 1);
+UC15_RING (UC15_RING15);                                /* signal PDP15 */
 if (DEBUG_PRS (uca_dev))
     fprintf (sim_deb, ">>UC15: API request sent, API = %o/%d\n",
                 vec, lvl);
@@ -320,6 +327,12 @@ t_stat uc15_svc (UNIT *uptr)
 {
 uint32 t;
 
+t = UC15_SHARED_RD (UC15_RING11);                       /* doorbell rung? */
+if (t == (uint32) uc15_ring) {                          /* no, nothing to do */
+    sim_activate (uptr, uc15_poll);
+    return SCPE_OK;
+    }
+uc15_ring = t;
 t = UC15_SHARED_RD (UC15_TCBP_WR);                      /* TCBP written? */
 if ((t != 0) && UC15_ATOMIC_CAS (UC15_TCBP_WR, 1, 0)) { /* for real? */
     ucb_csr |= UCBC_NTCB;                               /* set new TCB flag */
@@ -335,6 +348,13 @@ sim_activate (uptr, uc15_poll);                         /* next poll */
 return SCPE_OK;
 }
 
+/* Idle routine - wait for the PDP15 to ring */
+
+t_bool uc15_idle_wait (uint32 msec)
+{
+return UC15_RING_WAIT (UC15_RING11, uc15_ring, msec);
+}
+
 /* Routine to assemble/update uca_buf
 
   Note that the PDP-15 and PDP-11 have opposite interpretations of
@@ -409,6 +429,8 @@ if (pdp15_shmem == NULL) {                              /* allocate shared memor
     pdp15_mem = (int32 *) basead;
     }
 uc15_set_memsize ();
+uc15_ring = UC15_SHARED_RD (UC15_RING11) - 1;           /* force first poll */
+sim_idle_doorbell (dptr->units, &uc15_idle_wait);
 sim_activate (dptr->units, uc15_poll);                  /* start polling */
 return SCPE_OK;
 }
@@ -445,6 +467,7 @@ t_stat uc15_detach (UNIT *uptr)
 {
 if ((sim_switches & SIM_SW_SHUT) == 0)                  /* only if shutdown */
     return SCPE_NOFNC;
+sim_idle_doorbell (NULL, NULL);
 sim_shmem_close (uc15_shmem);                           /* release shared state */
 sim_shmem_close (pdp15_shmem);                          /* release shared mem */
 return SCPE_OK;
@@ -130,6 +130,7 @@ extern int32    tmxr_poll, clk_tps;
 #endif
 
 #define VH_LINES_ALLOC (16)
+#define VH_DMA_CHUNK    (256)   /* bytes fetched per DMA read */
 
 #define UNIT_V_MODEDHU  (UNIT_V_UF + 0)
 #define UNIT_V_FASTDMA  (UNIT_V_UF + 1)
@@ -1138,18 +1139,30 @@ static void doDMA ( int32   vh,
         pa = lp->tbuf1;
         pa |= (lp->tbuf2 & TB2_M_TBUFFAD) << 16;
         status = chan << CSR_V_TX_LINE;
+        /* fetch the buffer a chunk at a time rather than byte by byte */
         while (lp->tbuffct) {
-            uint8   buf;
-            if (Map_ReadB (pa, 1, &buf)) {
+            uint8   buf[VH_DMA_CHUNK];
+            int32   cnt, got, i;
+            cnt = lp->tbuffct;
+            if (cnt > VH_DMA_CHUNK)
+                cnt = VH_DMA_CHUNK;
+            if (cnt > (int32) ((1 << 22) - pa))     /* don't cross 22b wrap */
+                cnt = (1 << 22) - pa;
+            got = cnt - Map_ReadB (pa, cnt, buf);
+            for (i = 0; i < got; i++) {
+                if (vh_putc (vh, lp, chan, buf[i]) != SCPE_OK)
+                    break;
+            }
+            /* pa = (pa + i) & PAMASK; */
+            pa = (pa + i) & ((1 << 22) - 1);
+            lp->tbuffct -= i;
+            if (i < got)                            /* line stalled */
+                break;
+            if (got < cnt) {                        /* nxm */
                 status |= CSR_TX_DMA_ERR;
                 lp->tbuffct = 0;
                 break;
             }
-            if (vh_putc (vh, lp, chan, buf) != SCPE_OK)
-                break;
-            /* pa = (pa + 1) & PAMASK; */
-            pa = (pa + 1) & ((1 << 22) - 1);
-            lp->tbuffct--;
         }
         lp->tbuf1 = pa & 0177777;
         lp->tbuf2 = (lp->tbuf2 & ~TB2_M_TBUFFAD) |
@@ -280,6 +280,11 @@ t_stat xq_set_sanity (UNIT* uptr, int32 val, char* cptr, void* desc);
 t_stat xq_show_poll (FILE* st, UNIT* uptr, int32 val, void* desc);
 t_stat xq_set_poll (UNIT* uptr, int32 val, char* cptr, void* desc);
 t_stat xq_process_xbdl(CTLR* xq);
+int32 xq_bdl_read(struct xq_bdl_win* win, uint32 ba, int32 len, uint16* buf);
+int32 xq_bdl_write(struct xq_bdl_win* win, uint32 ba, int32 len, uint16* buf);
+int32 xq_bdl_sync(struct xq_bdl_win* win, uint32 ba, int32 len);
+int32 xq_bdl_drop(struct xq_bdl_win* win);
+int32 xq_ring_read(uint32 ra, int i, int count, int size, void* ring, t_bool* valid);
 t_stat xq_dispatch_xbdl(CTLR* xq);
 t_stat xq_process_turbo_rbdl(CTLR* xq);
 t_stat xq_process_turbo_xbdl(CTLR* xq);
@@ -840,6 +845,110 @@ t_stat xq_nxm_error(CTLR* xq)
   return SCPE_OK;
 }
 
+/*
+** descriptor window routines
+
+   Within one pass over a receive or transmit list the host cannot run, so
+   a window of descriptors can be read ahead with a single DMA and the
+   flag and status words written back together.  Buffer DMA that overlaps
+   the window writes it back and discards it first, so the order of the
+   memory updates seen by the host is unchanged.
+*/
+void xq_bdl_init(struct xq_bdl_win* win)
+{
+  win->ba = 0;
+  win->len = 0;
+  win->dlo = win->dhi = 0;
+}
+
+/* write back and discard the window */
+int32 xq_bdl_drop(struct xq_bdl_win* win)
+{
+  int32 wstatus = 0;
+
+  if (win->dhi > win->dlo)
+    wstatus = Map_WriteW(win->ba + win->dlo, win->dhi - win->dlo, &win->w[win->dlo >> 1]);
+  win->len = 0;
+  win->dlo = win->dhi = 0;
+  return wstatus;
+}
+
+/* write back and discard the window if a buffer transfer overlaps it */
+int32 xq_bdl_sync(struct xq_bdl_win* win, uint32 ba, int32 len)
+{
+  if ((win->len > 0) && (ba < win->ba + win->len) && (ba + len > win->ba))
+    return xq_bdl_drop(win);
+  return 0;
+}
+
+/* read descriptor words, prefetching a new window on a miss; the
+   prefetch stays within the map page of ba, where a bus error would
+   already have been raised by the requested words themselves */
+int32 xq_bdl_read(struct xq_bdl_win* win, uint32 ba, int32 len, uint16* buf)
+{
+  if ((ba < win->ba) || (ba + len > win->ba + win->len)) {
+    int32 wstatus = xq_bdl_drop(win);
+    int32 wlen = XQ_BDL_PAGE - (ba & (XQ_BDL_PAGE - 1));
+    if (wstatus) return wstatus;
+    if (wlen < len) wlen = len;
+    if (wlen > (int32)sizeof(win->w)) wlen = sizeof(win->w);
+    win->ba = ba;
+    win->len = wlen - Map_ReadW(ba, wlen, win->w);
+    if (win->len < len) {               /* requested words not all there */
+      win->len = 0;
+      return len;
+    }
+  }
+  memcpy(buf, &win->w[(ba - win->ba) >> 1], len);
+  return 0;
+}
+
+/* write descriptor words into the window, or to memory if outside it */
+int32 xq_bdl_write(struct xq_bdl_win* win, uint32 ba, int32 len, uint16* buf)
+{
+  int32 off = ba - win->ba;
+  int32 wstatus;
+
+  if ((ba < win->ba) || (ba + len > win->ba + win->len)) {
+    wstatus = xq_bdl_sync(win, ba, len);
+    if (wstatus) return wstatus;
+    return Map_WriteW(ba, len, buf);
+  }
+  memcpy(&win->w[off >> 1], buf, len);
+  if (win->dhi == win->dlo) {
+    win->dlo = off;
+    win->dhi = off + len;
+  } else {
+    if (off < win->dlo) win->dlo = off;
+    if (off + len > win->dhi) win->dhi = off + len;
+  }
+  return 0;
+}
+
+/* read DELQA-T ring descriptors from i to the end of the map page holding
+   descriptor i (at least descriptor i itself), marking them valid */
+int32 xq_ring_read(uint32 ra, int i, int count, int size, void* ring, t_bool* valid)
+{
+  uint32 ba = ra + i * size;
+  int n = (XQ_BDL_PAGE - (ba & (XQ_BDL_PAGE - 1))) / size;
+  int32 status;
+
+  if (n < 1) n = 1;
+  if (n > count - i) n = count - i;
+  status = Map_ReadW(ba, n * size, (uint16*)((uint8*)ring + i * size));
+  if (status) return status;
+  while (n--)
+    valid[i++] = TRUE;
+  return 0;
+}
+
+/* write back the window and report a non existent memory error */
+t_stat xq_bdl_error(CTLR* xq, struct xq_bdl_win* win)
+{
+  xq_bdl_drop(win);
+  return xq_nxm_error(xq);
+}
+
 /*
 ** write callback
 */
@@ -940,23 +1049,27 @@ t_stat xq_process_rbdl(CTLR* xq)
   uint32 address;
   ETH_ITEM* item;
   uint8* rbuf;
+  struct xq_bdl_win win;
 
   if (xq->var->mode == XQ_T_DELQA_PLUS)
     return xq_process_turbo_rbdl(xq);
 
   sim_debug(DBG_TRC, xq->dev, "xq_process_rdbl\n");
 
+  xq_bdl_init(&win);
+
   /* process buffer descriptors */
   while(1) {
 
     /* get receive bdl from memory */
+    rstatus = xq_bdl_read (&win, xq->var->rbdl_ba, 8, &xq->var->rbdl_buf[0]);
     xq->var->rbdl_buf[0] = 0xFFFF;
-    wstatus = Map_WriteW(xq->var->rbdl_ba,     2, &xq->var->rbdl_buf[0]);
-    rstatus = Map_ReadW (xq->var->rbdl_ba + 2, 6, &xq->var->rbdl_buf[1]);
-    if (rstatus || wstatus) return xq_nxm_error(xq);
+    wstatus = xq_bdl_write(&win, xq->var->rbdl_ba, 2, &xq->var->rbdl_buf[0]);
+    if (rstatus || wstatus) return xq_bdl_error(xq, &win);
 
     /* invalid buffer? */
     if (~xq->var->rbdl_buf[1] & XQ_DSC_V) {
+      if (xq_bdl_drop(&win)) return xq_nxm_error(xq);
       xq_csr_set_clr(xq, XQ_CSR_RL, 0);
       return SCPE_OK;
     }
@@ -971,8 +1084,8 @@ t_stat xq_process_rbdl(CTLR* xq)
     if (!xq->var->ReadQ.count) break;
 
     /* get status words */
-    rstatus = Map_ReadW(xq->var->rbdl_ba + 8, 4, &xq->var->rbdl_buf[4]);
-    if (rstatus) return xq_nxm_error(xq);
+    rstatus = xq_bdl_read(&win, xq->var->rbdl_ba + 8, 4, &xq->var->rbdl_buf[4]);
+    if (rstatus) return xq_bdl_error(xq, &win);
 
     /* get host memory address */
     address = ((xq->var->rbdl_buf[1] & 0x3F) << 16) | xq->var->rbdl_buf[2];
@@ -1019,8 +1132,10 @@ t_stat xq_process_rbdl(CTLR* xq)
     item->packet.used += rbl;
     
     /* send data to host */
-    wstatus = Map_WriteB(address, rbl, rbuf);
-    if (wstatus) return xq_nxm_error(xq);
+    wstatus = xq_bdl_sync(&win, address, rbl);
+    if (!wstatus)
+      wstatus = Map_WriteB(address, rbl, rbuf);
+    if (wstatus) return xq_bdl_error(xq, &win);
 
     /* set receive size into RBL - RBL<10:8> maps into Status1<10:8>,
        RBL<7:0> maps into Status2<7:0>, and Status2<15:8> (copy) */
@@ -1052,8 +1167,8 @@ t_stat xq_process_rbdl(CTLR* xq)
     }
 
     /* update read status words*/
-    wstatus = Map_WriteW(xq->var->rbdl_ba + 8, 4, &xq->var->rbdl_buf[4]);
-    if (wstatus) return xq_nxm_error(xq);
+    wstatus = xq_bdl_write(&win, xq->var->rbdl_ba + 8, 4, &xq->var->rbdl_buf[4]);
+    if (wstatus) return xq_bdl_error(xq, &win);
 
     /* remove packet from queue */
     if (item->packet.used >= item->packet.len)
@@ -1067,6 +1182,8 @@ t_stat xq_process_rbdl(CTLR* xq)
 
  } /* while */
 
+  /* write back descriptor status */
+  if (xq_bdl_drop(&win)) return xq_nxm_error(xq);
   return SCPE_OK;
 }
 
@@ -1259,23 +1376,27 @@ t_stat xq_process_xbdl(CTLR* xq)
   int32 rstatus, wstatus;
   uint32 address;
   t_stat status;
+  struct xq_bdl_win win;
 
   sim_debug(DBG_TRC, xq->dev, "xq_process_xbdl()\n");
 
   /* clear write buffer */
   xq->var->write_buffer.len = 0;
 
+  xq_bdl_init(&win);
+
   /* process buffer descriptors until not valid */
   while (1) {
 
     /* Get transmit bdl from memory */
-    rstatus = Map_ReadW (xq->var->xbdl_ba,    12, &xq->var->xbdl_buf[0]);
+    rstatus = xq_bdl_read (&win, xq->var->xbdl_ba, 12, &xq->var->xbdl_buf[0]);
     xq->var->xbdl_buf[0] = 0xFFFF;
-    wstatus = Map_WriteW(xq->var->xbdl_ba,     2, &xq->var->xbdl_buf[0]);
-    if (rstatus || wstatus) return xq_nxm_error(xq);
+    wstatus = xq_bdl_write(&win, xq->var->xbdl_ba,  2, &xq->var->xbdl_buf[0]);
+    if (rstatus || wstatus) return xq_bdl_error(xq, &win);
 
     /* invalid buffer? */
     if (~xq->var->xbdl_buf[1] & XQ_DSC_V) {
+      if (xq_bdl_drop(&win)) return xq_nxm_error(xq);
       xq_csr_set_clr(xq, XQ_CSR_XL, 0);
       sim_debug(DBG_WRN, xq->dev, "XBDL List empty\n");
       return SCPE_OK;
@@ -1300,8 +1421,10 @@ t_stat xq_process_xbdl(CTLR* xq)
     /* add to transmit buffer, making sure it's not too big */
     if ((xq->var->write_buffer.len + b_length) > sizeof(xq->var->write_buffer.msg))
       b_length = (uint16)(sizeof(xq->var->write_buffer.msg) - xq->var->write_buffer.len);
-    rstatus = Map_ReadB(address, b_length, &xq->var->write_buffer.msg[xq->var->write_buffer.len]);
-    if (rstatus) return xq_nxm_error(xq);
+    rstatus = xq_bdl_sync(&win, address, b_length);
+    if (!rstatus)
+      rstatus = Map_ReadB(address, b_length, &xq->var->write_buffer.msg[xq->var->write_buffer.len]);
+    if (rstatus) return xq_bdl_error(xq, &win);
     xq->var->write_buffer.len += b_length;
 
     /* end of message? */
@@ -1319,8 +1442,8 @@ t_stat xq_process_xbdl(CTLR* xq)
         }
 
         /* update write status */
-        wstatus = Map_WriteW(xq->var->xbdl_ba + 8, 4, (uint16*) write_success);
-        if (wstatus) return xq_nxm_error(xq);
+        wstatus = xq_bdl_write(&win, xq->var->xbdl_ba + 8, 4, (uint16*) write_success);
+        if (wstatus) return xq_bdl_error(xq, &win);
 
         /* clear write buffer */
         xq->var->write_buffer.len = 0;
@@ -1332,11 +1455,15 @@ t_stat xq_process_xbdl(CTLR* xq)
         xq_csr_set_clr(xq, XQ_CSR_XI, 0);
 
         /* now trigger "read" of setup or loopback packet */
-        if (~xq->var->csr & XQ_CSR_RL)
+        if (~xq->var->csr & XQ_CSR_RL) {
+          if (xq_bdl_drop(&win)) return xq_nxm_error(xq);
           status = xq_process_rbdl(xq);
+        }
 
       } else { /* not loopback */
 
+        /* the write callback and receive service update memory directly */
+        if (xq_bdl_drop(&win)) return xq_nxm_error(xq);
         status = eth_write(xq->var->etherface, &xq->var->write_buffer, xq->var->wcallback);
         if (status != SCPE_OK)           /* not implemented or unattached */
           xq_write_callback(xq, 1);      /* fake failure */
@@ -1352,8 +1479,8 @@ t_stat xq_process_xbdl(CTLR* xq)
 
       sim_debug(DBG_WRN, xq->dev, "XBDL processing implicit chain buffer segment\n");
       /* update bdl status words */
-      wstatus = Map_WriteW(xq->var->xbdl_ba + 8, 4, (uint16*) implicit_chain_status);
-      if(wstatus) return xq_nxm_error(xq);
+      wstatus = xq_bdl_write(&win, xq->var->xbdl_ba + 8, 4, (uint16*) implicit_chain_status);
+      if(wstatus) return xq_bdl_error(xq, &win);
     }
 
     /* set to next bdl (implicit chain) */
@@ -1430,12 +1557,17 @@ t_stat xq_process_turbo_rbdl(CTLR* xq)
   t_stat status;
   int descriptors_consumed = 0;
   uint32 rdra = (xq->var->init.rdra_h << 16) | xq->var->init.rdra_l;
+  t_bool valid[XQ_TURBO_RC_BCNT];
 
   sim_debug(DBG_TRC, xq->dev, "xq_process_turbo_rbdl()\n");
 
   if ((xq->var->srr & XQ_SRR_RESP) != XQ_SRR_STRT)
     return SCPE_OK;
 
+  /* Read the ring a map page at a time; the driver cannot change it while
+     we run, and descriptor updates below go to both memory and rring[] */
+  memset(valid, 0, sizeof(valid));
+
   /* Process descriptors in the receive ring while the're available and we have packets */
   do {
     uint32 address;
@@ -1450,9 +1582,11 @@ t_stat xq_process_turbo_rbdl(CTLR* xq)
     i = xq->var->rbindx;
 
     /* Get receive descriptor from memory */
-    status = Map_ReadW (rdra+i*sizeof(xq->var->rring[i]), sizeof(xq->var->rring[i]), (uint16 *)&xq->var->rring[i]);
-    if (status != SCPE_OK)
-        return xq_nxm_error(xq);
+    if (!valid[i]) {
+      status = xq_ring_read (rdra, i, XQ_TURBO_RC_BCNT, sizeof(xq->var->rring[i]), xq->var->rring, valid);
+      if (status != SCPE_OK)
+          return xq_nxm_error(xq);
+    }
 
     /* Done if Buffer not Owned */
     if (xq->var->rring[i].rmd3 & XQ_TMD3_OWN)
@@ -1505,6 +1639,8 @@ t_stat xq_process_turbo_rbdl(CTLR* xq)
     status = Map_WriteB(address, rbl, rbuf);
     if (status != SCPE_OK)
       return xq_nxm_error(xq);
+    if ((address < rdra + sizeof(xq->var->rring)) && (address + rbl > rdra))
+      memset(valid, 0, sizeof(valid));    /* buffer overlaps ring, reread */
 
     /* set receive size into RBL - RBL<10:8> maps into Status1<10:8>,
        RBL<7:0> maps into Status2<7:0>, and Status2<15:8> (copy) */
@@ -1523,7 +1659,8 @@ t_stat xq_process_turbo_rbdl(CTLR* xq)
       xq->var->ReadQ.loss = 0;          /* reset loss counter */
     }
 
-    Map_ReadW (rdra+(uint32)(((char *)(&xq->var->rring[xq->var->rbindx].rmd3))-((char *)&xq->var->rring)), sizeof(xq->var->rring[xq->var->rbindx].rmd3), (uint16 *)&xq->var->rring[xq->var->rbindx].rmd3);
+    if (!valid[xq->var->rbindx])
+      Map_ReadW (rdra+(uint32)(((char *)(&xq->var->rring[xq->var->rbindx].rmd3))-((char *)&xq->var->rring)), sizeof(xq->var->rring[xq->var->rbindx].rmd3), (uint16 *)&xq->var->rring[xq->var->rbindx].rmd3);
     if (xq->var->rring[xq->var->rbindx].rmd3 & XQ_RMD3_OWN)
       xq->var->rring[i].rmd2 |= XQ_RMD2_EOR;
 
@@ -1557,12 +1694,16 @@ t_stat xq_process_turbo_xbdl(CTLR* xq)
   t_stat status;
   int descriptors_consumed  = 0;
   uint32 tdra = (xq->var->init.tdra_h << 16) | xq->var->init.tdra_l;
+  t_bool valid[XQ_TURBO_XM_BCNT];
 
   sim_debug(DBG_TRC, xq->dev, "xq_process_turbo_xbdl()\n");
 
   if ((xq->var->srr & XQ_SRR_RESP) != XQ_SRR_STRT)
     return SCPE_OK;
 
+  /* Read the ring a map page at a time (see xq_process_turbo_rbdl) */
+  memset(valid, 0, sizeof(valid));
+
   /* clear transmit buffer */
   xq->var->write_buffer.len = 0;
 
@@ -1574,9 +1715,11 @@ t_stat xq_process_turbo_xbdl(CTLR* xq)
     i = xq->var->tbindx;
 
     /* Get transmit descriptor from memory */
-    status = Map_ReadW (tdra+i*sizeof(xq->var->xring[i]), sizeof(xq->var->xring[i]), (uint16 *)&xq->var->xring[i]);
-    if (status != SCPE_OK)
-      return xq_nxm_error(xq);
+    if (!valid[i]) {
+      status = xq_ring_read (tdra, i, XQ_TURBO_XM_BCNT, sizeof(xq->var->xring[i]), xq->var->xring, valid);
+      if (status != SCPE_OK)
+        return xq_nxm_error(xq);
+    }
 
     if (xq->var->xring[i].tmd3 & XQ_TMD3_OWN)
         break;
@@ -1629,7 +1772,8 @@ t_stat xq_process_turbo_xbdl(CTLR* xq)
       xq->var->xring[i].tmd2 = XQ_TMD2_RON | XQ_TMD2_TON;
     }
 
-    Map_ReadW (tdra+(uint32)(((char *)(&xq->var->xring[xq->var->tbindx].tmd3))-((char *)&xq->var->xring)), sizeof(xq->var->xring[xq->var->tbindx].tmd3), (uint16 *)&xq->var->xring[xq->var->tbindx].tmd3);
+    if (!valid[xq->var->tbindx])
+      Map_ReadW (tdra+(uint32)(((char *)(&xq->var->xring[xq->var->tbindx].tmd3))-((char *)&xq->var->xring)), sizeof(xq->var->xring[xq->var->tbindx].tmd3), (uint16 *)&xq->var->xring[xq->var->tbindx].tmd3);
     if (xq->var->xring[xq->var->tbindx].tmd3 & XQ_TMD3_OWN)
       xq->var->xring[i].tmd2 |= XQ_TMD2_EOR;
 
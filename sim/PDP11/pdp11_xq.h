@@ -250,6 +250,22 @@ struct xq_meb {                                         /* MEB block */
   uint8   siz_hi;
 };
 
+/* DEQNA - DELQA Normal Mode descriptor window - a run of buffer descriptors
+   read with one DMA; descriptor writes are collected in the window and
+   written back with one DMA.  A window only lives for one pass over a list.
+   Reads ahead stop at the end of the Qbus map page holding the descriptor,
+   so they never reach a page the controller would not otherwise touch. */
+#define XQ_BDL_WIN  8                                   /* descriptors per window */
+#define XQ_BDL_PAGE 512                                 /* Qbus map page size */
+
+struct xq_bdl_win {
+  uint32  ba;                                           /* bus address of w[0] */
+  int32   len;                                          /* bytes valid */
+  int32   dlo;                                          /* first dirty byte */
+  int32   dhi;                                          /* last dirty byte + 1 */
+  uint16  w[XQ_BDL_WIN * 6];                            /* descriptor words */
+};
+
 struct xq_device {
                                                         /*+ initialized values - DO NOT MOVE */
   ETH_PCALLBACK     rcallback;                          /* read callback routine */
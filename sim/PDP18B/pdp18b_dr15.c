@@ -55,7 +55,10 @@
    side having read/write access, the other read-only. Actions are
    implemented by setting signals with an atomic compare-and-swap.
    The signals may be polled with non-atomic operations but must be
-   verified with an atomic compare-and-swap.
+   verified with an atomic compare-and-swap. After setting a signal,
+   the sender rings the receiver's doorbell; the receiver only checks
+   its signals when the doorbell has changed, and blocks on the doorbell
+   instead of sleeping when the PDP15 is idle.
 
    Debug hooks - when DEBUG is turned on, the simulator will print
    information relating to PIREX operation.
@@ -77,6 +80,7 @@ int32 dr15_tcb_ack = 0;                                 /* TCBP write ack */
 int32 dr15_ie = 0;                                      /* int enable */
 uint32 dr15_int_req = 0;                                /* int req 0-3 */
 int32 dr15_poll = 3;                                    /* polling interval */
+int32 dr15_ring = 0;                                    /* doorbell last seen */
 SHMEM *uc15_shmem = NULL;                               /* shared state identifier */
 int32 *uc15_shstate = NULL;                             /* shared state base */
 SHMEM *pdp15_shmem = NULL;                              /* PDP15 mem identifier */
@@ -91,6 +95,7 @@ t_stat dr15_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
 t_stat dr15_dep (t_value val, t_addr addr, UNIT *uptr, int32 sw);
 t_stat dr15_attach (UNIT *uptr, char *cptr);
 t_stat dr15_detach (UNIT *uptr);
+t_bool dr15_idle_wait (uint32 msec);
 
 t_stat uc15_new_api (int32 val);                         /* callouts */
 t_stat uc15_tcbp_wr (int32 val);
@@ -199,6 +204,7 @@ t_stat uc15_new_api (int32 req)
 {
 UC15_SHARED_WR (UC15_API_SUMM, req);                    /* new value */
 UC15_ATOMIC_CAS (UC15_API_UPD, 0, 1);                   /* signal UC15 */
+UC15_RING (UC15_RING11);
 return SCPE_OK;
 }
 
@@ -206,6 +212,7 @@ t_stat uc15_tcbp_wr (int32 tcbp)
 {
 UC15_SHARED_WR (UC15_TCBP, tcbp);                       /* new value */
 UC15_ATOMIC_CAS (UC15_TCBP_WR, 0, 1);                   /* signal UC15 */
+UC15_RING (UC15_RING11);
 if (DEBUG_PRS (dr15_dev)) {
     uint32 apiv, apil, fnc, tsk;
     t_bool spl;
@@ -230,6 +237,12 @@ t_stat dr15_svc (UNIT *uptr)
 int32 i, t;
 uint32 old_int_req = dr15_int_req;
 
+t = UC15_SHARED_RD (UC15_RING15);                       /* doorbell rung? */
+if (t == dr15_ring) {                                   /* no, nothing to do */
+    sim_activate (uptr, dr15_poll);
+    return SCPE_OK;
+    }
+dr15_ring = t;
 t = UC15_SHARED_RD (UC15_TCBP_RD);                      /* TCBP read? */
 if ((t != 0) && UC15_ATOMIC_CAS (UC15_TCBP_RD, 1, 0))   /* for real? clear */
     dr15_tcb_ack = 1;                                   /* set ack */
@@ -252,6 +265,13 @@ sim_activate (uptr, dr15_poll);                         /* next poll */
 return SCPE_OK;
 }
 
+/* Idle routine - wait for the UC15 to ring */
+
+t_bool dr15_idle_wait (uint32 msec)
+{
+return UC15_RING_WAIT (UC15_RING15, dr15_ring, msec);
+}
+
 /* Reset routine
 
    Aside from performing a device reset, this routine sets up shared
@@ -274,6 +294,7 @@ for (i = 0; i < 4; i++) {                               /* clear intr and vector
     api_vec[i][INT_V_DR] = 0;
     }
 sim_cancel (dptr->units);
+sim_idle_doorbell (NULL, NULL);
 if ((dptr->flags & DEV_DIS) != 0)                       /* disabled? */
     return SCPE_OK;
 
@@ -283,7 +304,8 @@ if (uc15_shmem == NULL) {                               /* allocate shared state
         return r;
     uc15_shstate = (int32 *) basead;
     for (i = 0; i < UC15_STATE_SIZE; i++) {             /* zero out shared state region */
-        UC15_SHARED_WR (i, 0);
+        if ((i != UC15_RING11) && (i != UC15_RING15))   /* except doorbells */
+            UC15_SHARED_WR (i, 0);
         }
     }
 if (pdp15_shmem == NULL) {                              /* allocate shared memory */
@@ -295,6 +317,8 @@ if (pdp15_shmem == NULL) {                              /* allocate shared memor
     }
 UC15_SHARED_WR (UC15_PDP15MEM, cpu_unit.capac << 1);    /* write mem size to shared state */
 uc15_new_api (dr15_int_req);                            /* inform UC15 of new API (and mem) */
+dr15_ring = UC15_SHARED_RD (UC15_RING15) - 1;           /* force first poll */
+sim_idle_doorbell (dptr->units, &dr15_idle_wait);
 sim_activate (dptr->units, dr15_poll);                  /* start polling */
 return SCPE_OK;
 }
@@ -335,6 +359,7 @@ t_stat dr15_detach (UNIT *uptr)
 {
 if ((sim_switches & SIM_SW_SHUT) == 0)                  /* only if shutdown */
     return SCPE_NOFNC;
+sim_idle_doorbell (NULL, NULL);
 sim_shmem_close (uc15_shmem);                           /* release shared state */
 sim_shmem_close (pdp15_shmem);                          /* release shared mem */
 return SCPE_OK;
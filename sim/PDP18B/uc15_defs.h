@@ -34,6 +34,12 @@
    000-255      PDP-15 read/write, PDP-11 read only, data
    255-511      PDP-11 read/write, PDP-15 read only, data
    768-1023     Event signals (locks), read/write
+
+   Each side also has a doorbell in the event signal quadrant. A signal
+   is raised by setting it and then ringing the other side's doorbell.
+   The poll routines only look at the signals when their doorbell has
+   rung, and an idle simulator waits on its doorbell rather than polling.
+   The doorbells are counters and are never cleared.
 */
 
 #define PDP15_MAXMEM            0400000             /* PDP15 max mem, words */
@@ -49,11 +55,15 @@
 #define UC15_TCBP_RD            01040               /* TCBP read signal */
 #define UC15_API_UPD            01100               /* API summ update */
 #define UC15_API_REQ            01200               /* +1 for API req[4] */
+#define UC15_RING11             01300               /* PDP11 doorbell */
+#define UC15_RING15             01340               /* PDP15 doorbell */
 
 #define UC15_SHARED_RD(p)       (*(uc15_shstate + (p)))
 #define UC15_SHARED_WR(p,d)     *(uc15_shstate + (p)) = (d)
 
 #define UC15_ATOMIC_CAS(p,o,n)  sim_shmem_atomic_cas ((uc15_shstate + (p)), o, n)
 #define UC15_ATOMIC_ADD(p,a)    sim_shmem_atomic_add ((uc15_shstate + (p)), (a))
+#define UC15_RING(p)            sim_shmem_doorbell_ring (uc15_shstate + (p))
+#define UC15_RING_WAIT(p,v,ms)  sim_shmem_doorbell_wait ((uc15_shstate + (p)), (v), (ms))
 
 #endif
@@ -188,7 +188,21 @@
       Thus, only writes outside the current field (indirect writes) need
       be checked against actual memory size.
 
-   3. Adding I/O devices.  These modules must be modified:
+   4. Translation cache.  With SET CPU TCACHE, straight line runs of
+      memory reference and operate instructions are translated into
+      pre-decoded blocks, keyed by IF'PC.  Memory reference addresses
+      (and whether an indirect pointer autoindexes) are computed once,
+      and each operate microprogram is collapsed into a single handler:
+      group 1 becomes an AND mask, an XOR mask, an increment, and a
+      rotate; group 2 becomes a skip map indexed by L, AC == 0, and AC<0>.
+      A block ends at the first JMS, JMP, IOT, HLT, OSR, EAE, or undefined
+      rotate, and is only entered when breakpoints and history are off and
+      no interrupt can be taken before the block ends.  Each translated
+      word is compared against memory before it is executed, so writes by
+      the program itself or by DMA invalidate a block the next time it
+      runs.  The cache is discarded on each entry to the simulator.
+
+   5. Adding I/O devices.  These modules must be modified:
 
         pdp8_defs.h     add device number and interrupt definitions
         pdp8_sys.c      add sim_devices table entry
@@ -203,8 +217,31 @@
 #define UNIT_NOEAE      (1 << UNIT_V_NOEAE)
 #define UNIT_V_MSIZE    (UNIT_V_UF + 1)                 /* dummy mask */
 #define UNIT_MSIZE      (1 << UNIT_V_MSIZE)
+#define UNIT_V_TC       (UNIT_V_UF + 2)                 /* trans cache enab */
+#define UNIT_TC         (1 << UNIT_V_TC)
 #define OP_KSF          06031                           /* for idle */
 
+#define TC_SIZE         4096                            /* blocks, must be 2**n */
+#define TC_MASK         (TC_SIZE - 1)
+#define TC_HASH(x)      (((x) ^ ((x) >> 12)) & TC_MASK)
+#define TC_INV          0xFFFFFFFF                      /* invalid tag */
+#define TC_MAXOP        16                              /* max ops/block */
+#define TC_DIR          0                               /* direct */
+#define TC_IND          1                               /* indirect */
+#define TC_AUTO         2                               /* indirect, autoindex */
+#define TC_AND          0                               /* AND + mode */
+#define TC_TAD          3                               /* TAD + mode */
+#define TC_ISZ          6                               /* ISZ + mode */
+#define TC_DCA          9                               /* DCA + mode */
+#define TC_OPR1         12                              /* group 1, no rotate */
+#define TC_BSW          13                              /* group 1 + BSW */
+#define TC_RAL          14                              /* group 1 + RAL */
+#define TC_RTL          15                              /* group 1 + RTL */
+#define TC_RAR          16                              /* group 1 + RAR */
+#define TC_RTR          17                              /* group 1 + RTR */
+#define TC_OPR2         18                              /* group 2 */
+#define TC_OPR3         19                              /* group 3, no EAE */
+
 #define HIST_PC         0x40000000
 #define HIST_MIN        64
 #define HIST_MAX        65536
@@ -218,6 +255,22 @@ typedef struct {
     int16               mq;
     } InstHistory;
 
+typedef struct {
+    uint16              ir;                             /* instruction */
+    uint8               typ;                            /* micro-op type */
+    uint8               skp;                            /* group 2 skip map */
+    uint16              ea;                             /* addr, ptr addr */
+    uint16              andm;                           /* operate AND mask */
+    uint16              xorm;                           /* operate XOR mask */
+    uint16              inc;                            /* operate IAC */
+    } TCOP;
+
+typedef struct {
+    uint32              addr;                           /* IF'PC tag */
+    int32               nop;                            /* number of ops */
+    TCOP                op[TC_MAXOP];                   /* micro-ops */
+    } TCBLK;
+
 uint16 M[MAXMEMSIZE] = { 0 };                           /* main memory */
 int32 saved_LAC = 0;                                    /* saved L'AC */
 int32 saved_MQ = 0;                                     /* saved MQ */
@@ -246,6 +299,7 @@ int32 stop_inst = 0;                                    /* trap on ill inst */
 int32 (*dev_tab[DEV_MAX])(int32 IR, int32 dat);         /* device dispatch */
 int32 hst_p = 0;                                        /* history pointer */
 int32 hst_lnt = 0;                                      /* history length */
+TCBLK *tc_blk = NULL;                                   /* translation cache */
 InstHistory *hst = NULL;                                /* instruction history */
 
 t_stat cpu_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
@@ -255,6 +309,7 @@ t_stat cpu_set_size (UNIT *uptr, int32 val, char *cptr, void *desc);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, void *desc);
 t_bool build_dev_tab (void);
+void tc_build (TCBLK *bp, uint32 addr);
 
 /* CPU data structures
 
@@ -299,6 +354,8 @@ REG cpu_reg[] = {
 MTAB cpu_mod[] = {
     { UNIT_NOEAE, UNIT_NOEAE, "no EAE", "NOEAE", NULL },
     { UNIT_NOEAE, 0, "EAE", "EAE", NULL },
+    { UNIT_TC, UNIT_TC, "translation cache", "TCACHE", NULL },
+    { UNIT_TC, 0, NULL, "NOTCACHE", NULL },
     { MTAB_XTD|MTAB_VDV, 0, "IDLE", "IDLE", &sim_set_idle, &sim_show_idle },
     { MTAB_XTD|MTAB_VDV, 0, NULL, "NOIDLE", &sim_clr_idle, NULL },
     { UNIT_MSIZE, 4096, NULL, "4K", &cpu_set_size },
@@ -327,6 +384,7 @@ t_stat sim_instr (void)
 int32 IR, MB, IF, DF, LAC, MQ;
 uint32 PC, MA;
 int32 device, pulse, temp, iot_data;
+t_bool tc_enb;
 t_stat reason;
 
 /* Restore register state */
@@ -340,6 +398,16 @@ LAC = saved_LAC & 017777;
 MQ = saved_MQ & 07777;
 int_req = INT_UPDATE;
 reason = 0;
+tc_enb = (cpu_unit.flags & UNIT_TC) &&                  /* trans cache on, */
+    (sim_brk_summ == 0) && (hst_lnt == 0);              /* no bkpt, hist? */
+if (tc_enb) {
+    if (tc_blk == NULL)
+        tc_blk = (TCBLK *) calloc (TC_SIZE, sizeof (TCBLK));
+    if (tc_blk == NULL)
+        return SCPE_MEM;
+    for (temp = 0; temp < TC_SIZE; temp++)              /* discard blocks */
+        tc_blk[temp].addr = TC_INV;
+    }
 
 /* Main instruction fetch/decode loop */
 
@@ -365,6 +433,146 @@ while (reason == 0) {                                   /* loop until halted */
         PC = 1;                                         /* fetch next from 1 */
         }
 
+/* Translation cache.  No interrupt can be taken while a block runs:
+   its instructions only set the ION delay flag, which the test below
+   includes, and device state changes only in sim_process_event.
+*/
+
+    if (tc_enb &&                                       /* trans cache on, */
+        ((int_req | INT_NO_ION_PENDING) <= INT_PENDING)) { /* no intr? */
+        TCBLK *bp;
+        TCOP *op, *end;
+        t_bool skip;
+
+        MA = IF | PC;
+        bp = &tc_blk[TC_HASH (MA)];
+        if (bp->addr != MA)                             /* miss? translate */
+            tc_build (bp, MA);
+        skip = FALSE;
+        for (op = bp->op, end = op + bp->nop; !skip && (op < end); op++) {
+            if (M[IF | PC] != op->ir) {                 /* modified? */
+                bp->addr = TC_INV;                      /* retranslate */
+                break;
+                }
+            if ((op != bp->op) && (sim_interval <= 0))  /* event due? */
+                break;
+            PC = (PC + 1) & 07777;
+            sim_interval = sim_interval - 1;
+
+            switch (op->typ) {
+
+            case TC_AND+TC_DIR:
+                LAC = LAC & (M[op->ea] | 010000);
+                break;
+            case TC_AND+TC_IND:
+                MA = DF | M[op->ea];
+                LAC = LAC & (M[MA] | 010000);
+                break;
+            case TC_AND+TC_AUTO:
+                MA = DF | (M[op->ea] = (M[op->ea] + 1) & 07777);
+                LAC = LAC & (M[MA] | 010000);
+                break;
+
+            case TC_TAD+TC_DIR:
+                LAC = (LAC + M[op->ea]) & 017777;
+                break;
+            case TC_TAD+TC_IND:
+                MA = DF | M[op->ea];
+                LAC = (LAC + M[MA]) & 017777;
+                break;
+            case TC_TAD+TC_AUTO:
+                MA = DF | (M[op->ea] = (M[op->ea] + 1) & 07777);
+                LAC = (LAC + M[MA]) & 017777;
+                break;
+
+            case TC_ISZ+TC_DIR:
+                M[op->ea] = MB = (M[op->ea] + 1) & 07777;
+                if (MB == 0) {
+                    PC = (PC + 1) & 07777;
+                    skip = TRUE;
+                    }
+                break;
+            case TC_ISZ+TC_IND:
+            case TC_ISZ+TC_AUTO:
+                if (op->typ == TC_ISZ+TC_IND)
+                    MA = DF | M[op->ea];
+                else MA = DF | (M[op->ea] = (M[op->ea] + 1) & 07777);
+                MB = (M[MA] + 1) & 07777;
+                if (MEM_ADDR_OK (MA))
+                    M[MA] = MB;
+                if (MB == 0) {
+                    PC = (PC + 1) & 07777;
+                    skip = TRUE;
+                    }
+                break;
+
+            case TC_DCA+TC_DIR:
+                M[op->ea] = LAC & 07777;
+                LAC = LAC & 010000;
+                break;
+            case TC_DCA+TC_IND:
+            case TC_DCA+TC_AUTO:
+                if (op->typ == TC_DCA+TC_IND)
+                    MA = DF | M[op->ea];
+                else MA = DF | (M[op->ea] = (M[op->ea] + 1) & 07777);
+                if (MEM_ADDR_OK (MA))
+                    M[MA] = LAC & 07777;
+                LAC = LAC & 010000;
+                break;
+
+            case TC_OPR1:
+                LAC = (((LAC & op->andm) ^ op->xorm) + op->inc) & 017777;
+                break;
+            case TC_BSW:
+                LAC = (((LAC & op->andm) ^ op->xorm) + op->inc) & 017777;
+                LAC = (LAC & 010000) | ((LAC >> 6) & 077) | ((LAC & 077) << 6);
+                break;
+            case TC_RAL:
+                LAC = (((LAC & op->andm) ^ op->xorm) + op->inc) & 017777;
+                LAC = ((LAC << 1) | (LAC >> 12)) & 017777;
+                break;
+            case TC_RTL:
+                LAC = (((LAC & op->andm) ^ op->xorm) + op->inc) & 017777;
+                LAC = ((LAC << 2) | (LAC >> 11)) & 017777;
+                break;
+            case TC_RAR:
+                LAC = (((LAC & op->andm) ^ op->xorm) + op->inc) & 017777;
+                LAC = ((LAC >> 1) | (LAC << 12)) & 017777;
+                break;
+            case TC_RTR:
+                LAC = (((LAC & op->andm) ^ op->xorm) + op->inc) & 017777;
+                LAC = ((LAC >> 2) | (LAC << 11)) & 017777;
+                break;
+
+            case TC_OPR2:
+                if ((op->skp >> ((LAC >> 12) | (((LAC & 07777) == 0) << 1) |
+                    ((LAC >> 9) & 4))) & 1) {           /* skip on L, AC=0, AC<0 */
+                    PC = (PC + 1) & 07777;
+                    skip = TRUE;
+                    }
+                LAC = LAC & op->andm;                   /* CLA */
+                break;
+
+            case TC_OPR3:
+                temp = MQ;
+                LAC = LAC & op->andm;                   /* CLA */
+                if (op->ir & 0020) {                    /* MQL */
+                    MQ = LAC & 07777;
+                    LAC = LAC & 010000;
+                    }
+                if (op->ir & 0100)                      /* MQA */
+                    LAC = LAC | temp;
+                if (emode == 0)                         /* mode A? clr gtf */
+                    gtf = 0;
+                break;
+                }                                       /* end switch op */
+            }                                           /* end for */
+        if (op != bp->op) {                             /* any executed? */
+            int_req = int_req | INT_NO_ION_PENDING;     /* clear ION delay */
+            continue;
+            }
+        }
+
     MA = IF | PC;                                       /* form PC */
     if (sim_brk_summ && 
         sim_brk_test (MA, (1u << SIM_BKPT_V_SPC) | SWMASK ('E'))) { /* breakpoint? */
@@ -1372,6 +1580,75 @@ pcq_r->qptr = pcq_p;                                    /* update pc q ptr */
 return reason;
 }                                                       /* end sim_instr */
 
+/* Translate a block
+
+   Straight line memory reference and operate instructions starting at
+   IF'PC are pre-decoded into micro-ops; translation stops at anything
+   that changes the flow of control (other than a skip), touches I/O,
+   or stops the processor.  A block with no micro-ops makes the CPU use
+   the normal decode path for that address.
+*/
+
+void tc_build (TCBLK *bp, uint32 addr)
+{
+uint32 fld = addr & 070000;
+uint32 pc = addr & 07777;
+int32 ir, n, i, l, zero, neg, sk;
+TCOP *op;
+
+bp->addr = addr;
+for (n = 0; n < TC_MAXOP; n++) {
+    op = &bp->op[n];
+    op->ir = ir = M[fld | pc];
+    if (ir < 06000) {                                   /* mem ref? */
+        if (ir >= 04000)                                /* JMS, JMP */
+            break;
+        if (ir & 0200)                                  /* curr page */
+            op->ea = fld | (pc & 07600) | (ir & 0177);
+        else op->ea = fld | (ir & 0177);                /* page zero */
+        op->typ = (uint8) ((ir >> 9) * 3);              /* opcode */
+        if (ir & 0400)                                  /* indirect? */
+            op->typ = op->typ + (((op->ea & 07770) != 00010)? TC_IND: TC_AUTO);
+        }
+    else if (ir < 07000)                                /* IOT */
+        break;
+    else if (ir < 07400) {                              /* OPR group 1 */
+        i = (ir >> 1) & 07;                             /* rotate */
+        if (i >= 6)                                     /* undefined? */
+            break;
+        op->typ = (uint8) (TC_OPR1 + i);
+        op->andm = ((ir & 0200)? 0: 07777) | ((ir & 0100)? 0: 010000);
+        op->xorm = ((ir & 0040)? 07777: 0) | ((ir & 0020)? 010000: 0);
+        op->inc = ir & 01;
+        }
+    else if ((ir & 01) == 0) {                          /* OPR group 2 */
+        if (ir & 06)                                    /* OSR, HLT? */
+            break;
+        op->typ = TC_OPR2;
+        op->andm = (ir & 0200)? 010000: 017777;
+        op->skp = 0;
+        for (i = 0; i < 8; i++) {                       /* i = L, AC=0, AC<0> */
+            l = i & 1;
+            zero = (i >> 1) & 1;
+            neg = (i >> 2) & 1;
+            sk = ((ir & 0100) && neg) || ((ir & 0040) && zero) ||
+                ((ir & 0020) && l);
+            if ((ir & 0010)? !sk: sk)                   /* reverse sense? */
+                op->skp = op->skp | (1 << i);
+            }
+        }
+    else {                                              /* OPR group 3 */
+        if (ir & 0056)                                  /* EAE, SWAB, SWBA? */
+            break;
+        op->typ = TC_OPR3;
+        op->andm = (ir & 0200)? 010000: 017777;
+        }
+    pc = (pc + 1) & 07777;
+    }
+bp->nop = n;
+return;
+}
+
 /* Reset routine */
 
 t_stat cpu_reset (DEVICE *dptr)
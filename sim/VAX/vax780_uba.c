@@ -177,6 +177,7 @@ uint32 uba_aitime = 250;                                /* adapter init time */
 uint32 uba_uitime = 12250;                              /* Unibus init time */
 int32 autcon_enb = 1;                                   /* autoconfig enable */
 
+extern uint32 *M;
 extern int32 trpirq;
 extern int32 autcon_enb;
 extern jmp_buf save_env;
@@ -606,6 +607,10 @@ return vec;
    Map_ReadW    -       fetch word buffer from memory
    Map_WriteB   -       store byte buffer into memory
    Map_WriteW   -       store word buffer into memory
+
+   Transfers are done a page at a time, so that the data path registers
+   are updated as each page completes.  On little endian hosts, the byte
+   order of M matches the Unibus, so each page is copied with memcpy.
 */
 
 int32 Map_ReadB (uint32 ba, int32 bc, uint8 *buf)
@@ -622,7 +627,11 @@ for (i = 0; i < bc; i = i + pbc) {                      /* loop by pages */
         pbc = bc - i;
     if (DEBUG_PRI (uba_dev, UBA_DEB_XFR))
         fprintf (sim_deb, ">>UBA: 8b read, ma = %X, bc = %X\n", ma, pbc);
-    if ((ma | pbc) & 3) {                               /* aligned LW? */
+    if (sim_end) {                                      /* little endian? */
+        memcpy (buf, ((uint8 *) M) + ma, pbc);          /* copy page */
+        buf = buf + pbc;
+        }
+    else if ((ma | pbc) & 3) {                          /* aligned LW? */
         for (j = 0; j < pbc; ma++, j++) {               /* no, do by bytes */
             *buf++ = ReadB (ma);
             }
@@ -645,6 +654,7 @@ int32 Map_ReadW (uint32 ba, int32 bc, uint16 *buf)
 {
 int32 i, j, pbc;
 uint32 ma, dat;
+uint16 *buf0 = buf;
 
 ba = ba & UBADDRMASK;                                   /* mask UB addr */
 bc = bc & ~01;
@@ -656,7 +666,9 @@ for (i = 0; i < bc; i = i + pbc) {                      /* loop by pages */
         pbc = bc - i;
     if (DEBUG_PRI (uba_dev, UBA_DEB_XFR))
         fprintf (sim_deb, ">>UBA: 16b read, ma = %X, bc = %X\n", ma, pbc);
-    if ((ma | pbc) & 1) {                               /* aligned word? */
+    if (sim_end)                                        /* little endian? */
+        memcpy (((uint8 *) buf0) + i, ((uint8 *) M) + ma, pbc);
+    else if ((ma | pbc) & 1) {                          /* aligned word? */
         for (j = 0; j < pbc; ma++, j++) {               /* no, do by bytes */
             if ((i + j) & 1) {                          /* odd byte? */
                 *buf = (*buf & BMASK) | (ReadB (ma) << 8);
@@ -696,7 +708,11 @@ for (i = 0; i < bc; i = i + pbc) {                      /* loop by pages */
         pbc = bc - i;
     if (DEBUG_PRI (uba_dev, UBA_DEB_XFR))
         fprintf (sim_deb, ">>UBA: 8b write, ma = %X, bc = %X\n", ma, pbc);
-    if ((ma | pbc) & 3) {                               /* aligned LW? */
+    if (sim_end) {                                      /* little endian? */
+        memcpy (((uint8 *) M) + ma, buf, pbc);          /* copy page */
+        buf = buf + pbc;
+        }
+    else if ((ma | pbc) & 3) {                          /* aligned LW? */
         for (j = 0; j < pbc; ma++, j++) {               /* no, do by bytes */
             WriteB (ma, *buf);
             buf++;
@@ -720,6 +736,7 @@ int32 Map_WriteW (uint32 ba, int32 bc, uint16 *buf)
 {
 int32 i, j, pbc;
 uint32 ma, dat;
+uint16 *buf0 = buf;
 
 ba = ba & UBADDRMASK;                                   /* mask UB addr */
 bc = bc & ~01;
@@ -731,7 +748,9 @@ for (i = 0; i < bc; i = i + pbc) {                      /* loop by pages */
         pbc = bc - i;
     if (DEBUG_PRI (uba_dev, UBA_DEB_XFR))
         fprintf (sim_deb, ">>UBA: 16b write, ma = %X, bc = %X\n", ma, pbc);
-    if ((ma | pbc) & 1) {                               /* aligned word? */
+    if (sim_end)                                        /* little endian? */
+        memcpy (((uint8 *) M) + ma, ((uint8 *) buf0) + i, pbc);
+    else if ((ma | pbc) & 1) {                          /* aligned word? */
         for (j = 0; j < pbc; ma++, j++) {               /* no, bytes */
             if ((i + j) & 1) {
                 WriteB (ma, (*buf >> 8) & BMASK);
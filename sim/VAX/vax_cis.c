@@ -50,7 +50,14 @@
    CIS instructions can run for a very long time, so they are interruptible
    and restartable.  In the simulator, string instructions (and EDITPC) are
    interruptible by faults, but decimal instructions run to completion.
-   The code is unoptimized.
+
+   Decimal strings are held as BCD in a DSTR and added and subtracted a
+   longword (eight digits) at a time.  Multiply, divide, and the long
+   conversions first convert their operands to binary, if every digit is
+   valid and the result is sure to fit in a DBIN; otherwise they fall back
+   to digit by digit arithmetic on the DSTR.  Packed strings, and the
+   destination of the EDITPC move and fill operators, are accessed
+   directly in memory (see MapStr) if they lie within one page.
 */
 
 #include "vax_defs.h"
@@ -77,6 +84,26 @@ typedef struct {
 static DSTR Dstr_zero = { 0, {0, 0, 0, 0} };
 static DSTR Dstr_one = { 0, {0x10, 0, 0, 0} };
 
+/* Binary form of a decimal string
+
+   DBIN is the widest unsigned integer available; DBIN_MAXD is the
+   number of decimal digits it is sure to hold.  A DSTR with only valid
+   digits, and no more than DBIN_MAXD of them, converts exactly.
+*/
+
+#if defined (__SIZEOF_INT128__) && !defined (DONT_USE_INT128)
+typedef unsigned __int128 DBIN;
+#define DBIN_MAXD       31                              /* all of a DSTR */
+#else
+typedef t_uint64 DBIN;
+#define DBIN_MAXD       19
+#endif
+
+#define D_P7            10000000                        /* powers of ten */
+#define D_P8            100000000
+#define D_P15           (((t_uint64) D_P7) * D_P8)
+#define D_BADDIG(x)     (((x) & (((x) << 1) | ((x) << 2)) & 0x88888888) != 0)
+
 extern int32 R[16];
 extern int32 PSL;
 extern int32 trpirq;
@@ -85,6 +112,8 @@ extern int32 fault_PC;
 extern int32 ibcnt, ppc;
 extern jmp_buf save_env;
 
+extern uint8 *MapStr (uint32 va, int32 acc, int32 *lnt);
+
 int32 ReadDstr (int32 lnt, int32 addr, DSTR *dec, int32 acc);
 int32 WriteDstr (int32 lnt, int32 addr, DSTR *dec, int32 v, int32 acc);
 int32 SetCCDstr (int32 lnt, DSTR *src, int32 pslv);
@@ -99,10 +128,14 @@ uint32 NibbleRshift (DSTR *dsrc, int32 sc, uint32 cin);
 int32 WordLshift (DSTR *dsrc, int32 sc);
 void WordRshift (DSTR *dsrc, int32 sc);
 void CreateTable (DSTR *dsrc, DSTR mtable[10]);
+t_bool ValidDstr (DSTR *dsrc);
+DBIN BinDstr (DSTR *dsrc);
+void DstrBin (DBIN val, DSTR *dst);
 int32 do_crc_4b (int32 crc, int32 tbl, int32 acc);
 int32 edit_read_src (int32 inc, int32 acc);
 void edit_adv_src (int32 inc);
 int32 edit_read_sign (int32 acc);
+uint8 *edit_map_dst (int32 lnt, int32 acc);
 
 extern int32 eval_int (void);
 
@@ -114,7 +147,10 @@ int32 i, j, c, t, pop, rpt, V;
 int32 match, fill, sign, shift;
 int32 ldivd, ldivr;
 int32 lenl, lenp;
+int32 l1, l2;
 uint32 nc, d, result;
+uint8 *dp;
+DBIN bin;
 t_stat r;
 DSTR accum, src1, src2, dst;
 DSTR mptable[10];
@@ -522,20 +558,27 @@ switch (opc) {                                          /* case on opcode */
             (op[2] > 31) || (op[4] > 31))
             RSVD_OPND_FAULT;
         dst = Dstr_zero;                                /* clear result */
-        if (ReadDstr (op[0], op[1], &src1, acc) &&      /* read src1, src2 */
-            ReadDstr (op[2], op[3], &src2, acc)) {      /* if both > 0 */
+        if ((l1 = ReadDstr (op[0], op[1], &src1, acc)) && /* read src1, src2 */
+            (l2 = ReadDstr (op[2], op[3], &src2, acc))) { /* if both > 0 */
             dst.sign = src1.sign ^ src2.sign;           /* sign of result */
-            accum = Dstr_zero;                          /* clear accum */
-            NibbleRshift (&src1, 1, 0);                 /* shift out sign */
-            CreateTable (&src1, mptable);               /* create *1, *2, ... */
-            for (i = 1; i < (DSTRLNT * 8); i++) {       /* 31 iterations */
-                d = (src2.val[i / 8] >> ((i % 8) * 4)) & 0xF;
-                if (d > 0)                              /* add in digit*mpcnd */
-                    AddDstr (&mptable[d], &accum, &accum, 0);
-                nc = NibbleRshift (&accum, 1, 0);       /* ac right 4 */
-                NibbleRshift (&dst, 1, nc);             /* result right 4 */
+            if (ValidDstr (&src1) && ValidDstr (&src2) && /* product fits? */
+                ((LntDstr (&src1, l1) + LntDstr (&src2, l2)) <= DBIN_MAXD)) {
+                DstrBin (BinDstr (&src1) * BinDstr (&src2), &dst);
+                V = 0;                                  /* can't ovflo */
+                }
+            else {                                      /* digit by digit */
+                accum = Dstr_zero;                      /* clear accum */
+                NibbleRshift (&src1, 1, 0);             /* shift out sign */
+                CreateTable (&src1, mptable);           /* create *1, *2, ... */
+                for (i = 1; i < (DSTRLNT * 8); i++) {   /* 31 iterations */
+                    d = (src2.val[i / 8] >> ((i % 8) * 4)) & 0xF;
+                    if ((d > 0) && (d < 10))            /* add in digit*mpcnd */
+                        AddDstr (&mptable[d], &accum, &accum, 0);
+                    nc = NibbleRshift (&accum, 1, 0);   /* ac right 4 */
+                    NibbleRshift (&dst, 1, nc);         /* result right 4 */
+                    }
+                V = TestDstr (&accum) != 0;             /* if ovflo, set V */
                 }
-            V = TestDstr (&accum) != 0;                 /* if ovflo, set V */
             }
         else V = 0;                                     /* result = 0 */
         cc = WriteDstr (op[4], op[5], &dst, V, acc);    /* store result */
@@ -580,24 +623,29 @@ switch (opc) {                                          /* case on opcode */
         ldivd = ReadDstr (op[2], op[3], &src2, acc);    /* get dividend */
         ldivd = LntDstr (&src2, ldivd);                 /* get exact length */
         dst = Dstr_zero;                                /* clear dest */
-        NibbleRshift (&src1, 1, 0);                     /* right justify ops */
-        NibbleRshift (&src2, 1, 0);
         if ((t = ldivd - ldivr) >= 0) {                 /* any divide to do? */
             dst.sign = src1.sign ^ src2.sign;           /* calculate sign */
-            WordLshift (&src1, t / 8);                  /* align divr to divd */
-            NibbleLshift (&src1, t % 8, 0);
-            CreateTable (&src1, mptable);               /* create *1, *2, ... */
-            for (i = 0; i <= t; i++) {                  /* divide loop */
-                for (d = 9; d > 0; d--) {               /* find digit */
-                    if (CmpDstr (&src2, &mptable[d]) >= 0) {
-                        SubDstr (&mptable[d], &src2, &src2);
-                        dst.val[0] = dst.val[0] | d;
-                        break;
-                        }                               /* end if */
-                    }                                   /* end for */
-                NibbleLshift (&src2, 1, 0);             /* shift dividend */
-                NibbleLshift (&dst, 1, 0);              /* shift quotient */
-                }                                       /* end divide loop */
+            if (ValidDstr (&src1) && ValidDstr (&src2) && /* dvd fits? */
+                (ldivd <= DBIN_MAXD))
+                DstrBin (BinDstr (&src2) / BinDstr (&src1), &dst);
+            else {                                      /* digit by digit */
+                NibbleRshift (&src1, 1, 0);             /* right justify ops */
+                NibbleRshift (&src2, 1, 0);
+                WordLshift (&src1, t / 8);              /* align divr to divd */
+                NibbleLshift (&src1, t % 8, 0);
+                CreateTable (&src1, mptable);           /* create *1, *2, ... */
+                for (i = 0; i <= t; i++) {              /* divide loop */
+                    for (d = 9; d > 0; d--) {           /* find digit */
+                        if (CmpDstr (&src2, &mptable[d]) >= 0) {
+                            SubDstr (&mptable[d], &src2, &src2);
+                            dst.val[0] = dst.val[0] | d;
+                            break;
+                            }                           /* end if */
+                        }                               /* end for */
+                    NibbleLshift (&src2, 1, 0);         /* shift dividend */
+                    NibbleLshift (&dst, 1, 0);          /* shift quotient */
+                    }                                   /* end divide loop */
+                }
             }                                           /* end if */
         cc = WriteDstr (op[4], op[5], &dst, 0, acc);    /* store result */
         R[0] = 0;
@@ -721,18 +769,25 @@ switch (opc) {                                          /* case on opcode */
     case CVTPL:
         if ((PSL & PSL_FPD) || (op[0] > 31))
             RSVD_OPND_FAULT;
-        ReadDstr (op[0], op[1], &src1, acc);            /* get source */
+        l1 = ReadDstr (op[0], op[1], &src1, acc);       /* get source */
         V = result = 0;                                 /* clear V, result */
-        for (i = (DSTRLNT * 8) - 1; i > 0; i--) {       /* loop thru digits */
-            d = (src1.val[i / 8] >> ((i % 8) * 4)) & 0xF;
-            if (d || result || V) {                     /* skip initial 0's */
-                if (result >= MAXDVAL)
-                    V = 1;
-                result = ((result * 10) + d) & LMASK;
-                if (result < d)
-                    V = 1;
-                }                                       /* end if */
-            }                                           /* end for */
+        if (ValidDstr (&src1) && (LntDstr (&src1, l1) <= DBIN_MAXD)) {
+            bin = BinDstr (&src1);                      /* convert in binary */
+            result = ((uint32) bin) & LMASK;
+            V = (bin > LMASK);
+            }
+        else {                                          /* digit by digit */
+            for (i = (DSTRLNT * 8) - 1; i > 0; i--) {   /* loop thru digits */
+                d = (src1.val[i / 8] >> ((i % 8) * 4)) & 0xF;
+                if (d || result || V) {                 /* skip initial 0's */
+                    if (result >= MAXDVAL)
+                        V = 1;
+                    result = ((result * 10) + d) & LMASK;
+                    if (result < d)
+                        V = 1;
+                    }                                   /* end if */
+                }                                       /* end for */
+            }
         if (src1.sign)                                  /* negative? */
             result = (~result + 1) & LMASK;
         if (src1.sign ^ ((result & LSIGN) != 0))        /* test for overflow */
@@ -776,11 +831,7 @@ switch (opc) {                                          /* case on opcode */
             dst.sign = 1;
             result = (~result + 1) & LMASK;
             }
-        for (i = 1; (i < (DSTRLNT * 8)) && result; i++) {
-            d = result % 10;
-            result = result / 10;
-            dst.val[i / 8] = dst.val[i / 8] | (d << ((i % 8) * 4));
-            }
+        DstrBin (result, &dst);                         /* convert to BCD */
         cc = WriteDstr (op[1], op[2], &dst, 0, acc);    /* write result */
         R[0] = 0;
         R[1] = 0;
@@ -1140,8 +1191,13 @@ switch (opc) {                                          /* case on opcode */
                 break;
 
             case EO_FILL:                               /* fill */
-                for (i = 0; i < rpt; i++)               /* fill string */
-                    Write ((R[5] + i) & LMASK, fill, L_BYTE, WA);
+                dp = edit_map_dst (rpt, acc);           /* dst in one page? */
+                if (dp != NULL)
+                    memset (dp, fill, rpt);
+                else {
+                    for (i = 0; i < rpt; i++)           /* fill string */
+                        Write ((R[5] + i) & LMASK, fill, L_BYTE, WA);
+                    }
                 R[5] = (R[5] + rpt) & LMASK;            /* now fault safe */
                 break;
 
@@ -1151,7 +1207,11 @@ switch (opc) {                                          /* case on opcode */
                     if (d)                              /* test for non-zero */
                         cc = (cc | CC_C) & ~CC_Z;
                     c = (cc & CC_C)? (d | 0x30): fill;  /* test for signif */
-                    Write ((R[5] + i) & LMASK, c, L_BYTE, WA);
+                    if (i == 0)                         /* map dst after */
+                        dp = edit_map_dst (rpt, acc);   /* 1st src read */
+                    if (dp != NULL)
+                        dp[i] = (uint8) c;
+                    else Write ((R[5] + i) & LMASK, c, L_BYTE, WA);
                     }                                   /* end for */
                 edit_adv_src (rpt);                     /* advance src */
                 R[5] = (R[5] + rpt) & LMASK;            /* advance dst */
@@ -1160,13 +1220,19 @@ switch (opc) {                                          /* case on opcode */
             case EO_FLOAT:
                 for (i = j = 0; i < rpt; i++, j++) {    /* for repeat */
                     d = edit_read_src (i, acc);         /* get nibble */
+                    if (i == 0)                         /* map dst after */
+                        dp = edit_map_dst (rpt + 1, acc); /* 1st src read */
                     if (d && !(cc & CC_C)) {            /* nz, signif clear? */
-                        Write ((R[5] + j) & LMASK, sign, L_BYTE, WA);
+                        if (dp != NULL)
+                            dp[j] = (uint8) sign;
+                        else Write ((R[5] + j) & LMASK, sign, L_BYTE, WA);
                         cc = (cc | CC_C) & ~CC_Z;       /* set signif */
                         j++;                            /* extra dst char */
                         }                               /* end if */
                     c = (cc & CC_C)? (d | 0x30): fill;  /* test for signif */
-                    Write ((R[5] + j) & LMASK, c, L_BYTE, WA);
+                    if (dp != NULL)
+                        dp[j] = (uint8) c;
+                    else Write ((R[5] + j) & LMASK, c, L_BYTE, WA);
                     }                                   /* end for */
                 edit_adv_src (rpt);                     /* advance src */
                 R[5] = (R[5] + j) & LMASK;              /* advance dst */
@@ -1217,11 +1283,17 @@ return cc;
 int32 ReadDstr (int32 lnt, int32 adr, DSTR *src, int32 acc)
 {
 int32 c, i, end, t = 0;
+uint8 *sp;
 
 *src = Dstr_zero;                                       /* clear result */
 end = lnt / 2;                                          /* last byte */
+sp = MapStr ((adr + end) & LMASK, RA, &c);              /* map last byte */
+if ((sp != NULL) && (VA_GETOFF (adr + end) < end))      /* not in one page? */
+    sp = NULL;
 for (i = 0; i <= end; i++) {                            /* loop thru string */
-    c = Read ((adr + end - i) & LMASK, L_BYTE, RA);     /* get byte */
+    if (sp != NULL)                                     /* get byte */
+        c = sp[-i];
+    else c = Read ((adr + end - i) & LMASK, L_BYTE, RA);
     if (i == 0) {                                       /* sign char? */
         t = c & 0xF;                                    /* save sign */
         c = c & 0xF0;                                   /* erase sign */
@@ -1268,14 +1340,20 @@ return TestDstr (src);                                  /* clean -0 */
 int32 WriteDstr (int32 lnt, int32 adr, DSTR *dst, int32 pslv, int32 acc)
 {
 int32 c, i, cc, end;
+uint8 *dp;
 
 end = lnt / 2;                                          /* end of string */
 ProbeDstr (end, adr, WA);                               /* test writeability */
 cc = SetCCDstr (lnt, dst, pslv);                        /* set cond codes */
 dst->val[0] = dst->val[0] | 0xC | dst->sign;            /* set sign */
+dp = MapStr ((adr + end) & LMASK, WA, &c);              /* map last byte */
+if ((dp != NULL) && (VA_GETOFF (adr + end) < end))      /* not in one page? */
+    dp = NULL;
 for (i = 0; i <= end; i++) {                            /* store string */
     c = (dst->val[i / 4] >> ((i % 4) * 8)) & 0xFF;
-    Write ((adr + end - i) & LMASK, c, L_BYTE, WA);
+    if (dp != NULL)
+        dp[-i] = (uint8) c;
+    else Write ((adr + end - i) & LMASK, c, L_BYTE, WA);
     }                                                   /* end for */
 return cc;
 }
@@ -1495,6 +1573,93 @@ for (i = 2; i < 10; i++)
 return;
 }
 
+/* Test decimal string for valid digits
+
+   Arguments:
+        dsrc    =       decimal string structure
+   Output       =       TRUE if every digit is 0-9
+*/
+
+t_bool ValidDstr (DSTR *dsrc)
+{
+int32 i;
+
+for (i = 0; i < DSTRLNT; i++) {
+    if (D_BADDIG (dsrc->val[i]))
+        return FALSE;
+    }
+return TRUE;
+}
+
+/* Convert decimal string to binary
+
+   Arguments:
+        dsrc    =       decimal string structure
+   Output       =       magnitude in binary
+
+   The digits must be valid and must fit in a DBIN.  Each longword is
+   converted by summing adjacent digits, then pairs, then quads.
+*/
+
+static uint32 bcd_to_bin (uint32 x)
+{
+x = (x & 0x0F0F0F0F) + (((x >> 4) & 0x0F0F0F0F) * 10);
+x = (x & 0x00FF00FF) + (((x >> 8) & 0x00FF00FF) * 100);
+return (x & 0xFFFF) + ((x >> 16) * 10000);
+}
+
+DBIN BinDstr (DSTR *dsrc)
+{
+DBIN val;
+
+val = bcd_to_bin (dsrc->val[3]);
+val = (val * D_P8) + bcd_to_bin (dsrc->val[2]);
+val = (val * D_P8) + bcd_to_bin (dsrc->val[1]);
+return (val * D_P7) + bcd_to_bin (dsrc->val[0] >> 4);
+}
+
+/* Convert binary to decimal string
+
+   Arguments:
+        val     =       magnitude in binary, < 10^31
+        dst     =       decimal string structure
+
+   The digits are replaced; the sign is not changed.  The value is split
+   at 10^15 (in 64b arithmetic, if it is small enough), and then into
+   longwords of eight (or, for the low longword, seven) digits.
+*/
+
+static uint32 bin_to_bcd (uint32 x)
+{
+uint32 r;
+int32 i;
+
+for (i = 0, r = 0; x != 0; i = i + 4) {                 /* x < 10^8 */
+    r = r | ((x % 10) << i);
+    x = x / 10;
+    }
+return r;
+}
+
+void DstrBin (DBIN val, DSTR *dst)
+{
+t_uint64 lo, hi;
+
+if (val == (t_uint64) val) {                            /* fits in 64b? */
+    lo = ((t_uint64) val) % D_P15;
+    hi = ((t_uint64) val) / D_P15;
+    }
+else {
+    lo = (t_uint64) (val % D_P15);
+    hi = (t_uint64) (val / D_P15);
+    }
+dst->val[0] = bin_to_bcd ((uint32) (lo % D_P7)) << 4;
+dst->val[1] = bin_to_bcd ((uint32) (lo / D_P7));
+dst->val[2] = bin_to_bcd ((uint32) (hi % D_P8));
+dst->val[3] = bin_to_bcd ((uint32) (hi / D_P8));
+return;
+}
+
 /* Word shift right
 
    Arguments:
@@ -1655,6 +1820,18 @@ R[2] = ED_PUTSIGN (R[2], sign);                         /* now fault safe */
 return sign;
 }
 
+/* Map the next lnt bytes of the destination, if they are memory within
+   one page; the access faults just as a write of the first byte would */
+
+uint8 *edit_map_dst (int32 lnt, int32 acc)
+{
+uint8 *dp;
+int32 dl;
+
+dp = MapStr (R[5], WA, &dl);
+return ((dp != NULL) && (dl >= lnt))? dp: NULL;
+}
+
 #else
 
 extern int32 R[16];
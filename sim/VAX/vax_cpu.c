@@ -187,6 +187,7 @@
 /* Definitions */
 
 #include "vax_defs.h"
+#include "sim_shmem.h"
 
 #define OP_MEM          -1
 #define UNIT_V_CONH     (UNIT_V_UF + 0)                 /* halt to console */
@@ -201,6 +202,10 @@
 
 #define OPND_SIZE       16
 #define INST_SIZE       52
+#define IC_SIZE         4096                            /* decode cache size */
+#define IC_MAXVAL       12                              /* max I-stream values */
+#define IC_MAXLW        4                               /* max I-stream lw's */
+#define IC_HASH(x)      (((x) ^ ((x) >> 12)) & (IC_SIZE - 1))
 #define op0             opnd[0]
 #define op1             opnd[1]
 #define op2             opnd[2]
@@ -217,19 +222,19 @@
 #define CHECK_FOR_AP    if (rn >= nAP) \
                             RSVD_ADDR_FAULT
 #define WRITE_B(r)      if (spec > (GRN | nPC)) \
-                            Write (va, r, L_BYTE, WA); \
+                            WriteF (va, r, L_BYTE, WA); \
                         else R[rn] = (R[rn] & ~BMASK) | ((r) & BMASK)
 #define WRITE_W(r)      if (spec > (GRN | nPC)) \
-                            Write (va, r, L_WORD, WA); \
+                            WriteF (va, r, L_WORD, WA); \
                         else R[rn] = (R[rn] & ~WMASK) | ((r) & WMASK)
 #define WRITE_L(r)      if (spec > (GRN | nPC)) \
-                            Write (va, r, L_LONG, WA); \
+                            WriteF (va, r, L_LONG, WA); \
                         else R[rn] = (r)
 #define WRITE_Q(rl,rh)  if (spec > (GRN | nPC)) { \
                         if ((Test (va + 7, WA, &mstat) >= 0) || \
                             (Test (va, WA, &mstat) < 0)) \
-                            Write (va, rl, L_LONG, WA); \
-                            Write (va + 4, rh, L_LONG, WA); \
+                            WriteF (va, rl, L_LONG, WA); \
+                            WriteF (va + 4, rh, L_LONG, WA); \
                             } \
                         else { \
                             if (rn >= nSP) \
@@ -250,6 +255,7 @@ typedef struct {
     } InstHistory;
 
 uint32 *M = NULL;                                       /* memory */
+SIMRAM *M_ram = NULL;                                   /* memory allocation */
 int32 R[16];                                            /* registers */
 int32 STK[5];                                           /* stack pointers */
 int32 PSL;                                              /* PSL */
@@ -314,10 +320,52 @@ const uint32 align[4] = {
  0xFFFFFFFF, 0x00FFFFFF, 0x0000FFFF, 0x000000FF
  };
 
+/* Decoded instruction cache
+
+   Each entry holds the values fetched from the instruction stream by the
+   decode of one instruction (opcode, specifier bytes, displacements and
+   immediates), keyed by the physical address of the instruction.  On a
+   hit, the decoder takes its I-stream values from the entry instead of
+   going through the prefetch buffer.  The entry also holds a copy of the
+   longwords containing the instruction; a hit is only taken if memory
+   still matches, so writes from any source (CPU, DMA, console) are seen
+   without having to track them.  Instructions that cross a page, are
+   longer than IC_MAXVAL values, or are not in memory are not cached.
+*/
+
+typedef struct {
+    int32               tag;                            /* phys PC, -1 = inv */
+    int32               nval;                           /* # I-stream values */
+    int32               nlw;                            /* # I-stream lw's */
+    int32               val[IC_MAXVAL];                 /* I-stream values */
+    uint32              lw[IC_MAXLW];                   /* memory contents */
+    } ICENT;
+
+ICENT ic_tab[IC_SIZE];                                  /* decode cache */
+ICENT *ic_rep = NULL;                                   /* entry being replayed */
+ICENT *ic_rec = NULL;                                   /* entry being recorded */
+int32 ic_idx = 0;                                       /* replay index */
+int32 ic_pa = 0;                                        /* phys PC of entry */
+int32 ic_pc = 0;                                        /* virt PC of entry */
+
+/* The TB fast path (ReadF, WriteF) is only worthwhile if it is inlined
+   into the specifier decode; GCC will not do that for ~100 call sites
+   without being told to. */
+
+#if defined (__GNUC__)
+#define TB_INLINE       inline __attribute__ ((always_inline))
+#else
+#define TB_INLINE
+#endif
+
 /* External and forward references */
 
 extern t_stat build_dib_tab (void);
 extern UNIT rom_unit, nvr_unit;
+extern TLBENT stlb[VA_TBMAX], ptlb[VA_TBMAX];
+extern uint32 tlb_wshift, tlb_smask;
+extern uint32 tlb_sgen, tlb_pgen;
+extern t_uint64 tlb_hit;
 extern int32 op_ashq (int32 *opnd, int32 *rh, int32 *flg);
 extern int32 op_emul (int32 mpy, int32 mpc, int32 *rh);
 extern int32 op_ediv (int32 *opnd, int32 *rh, int32 *flg);
@@ -400,6 +448,11 @@ t_stat cpu_set_idle (UNIT *uptr, int32 val, char *cptr, void *desc);
 t_stat cpu_show_idle (FILE *st, UNIT *uptr, int32 val, void *desc);
 int32 cpu_get_vsw (int32 sw);
 SIM_INLINE int32 get_istr (int32 lnt, int32 acc);
+static TB_INLINE int32 ReadF (uint32 va, int32 lnt, int32 acc);
+static TB_INLINE void WriteF (uint32 va, int32 val, int32 lnt, int32 acc);
+void ic_start (void);
+void ic_end (void);
+void ic_flush (void);
 int32 ReadOcta (int32 va, int32 *opnd, int32 j, int32 acc);
 t_bool cpu_show_opnd (FILE *st, InstHistory *h, int32 line);
 void cpu_idle (void);
@@ -472,6 +525,8 @@ REG cpu_reg[] = {
 MTAB cpu_mod[] = {
     { UNIT_CONH, 0, "HALT to SIMH", "SIMHALT", NULL },
     { UNIT_CONH, UNIT_CONH, "HALT to console", "CONHALT", NULL },
+    { UNIT_HOSTFP, 0, NULL, "NOHOSTFP", NULL },
+    { UNIT_HOSTFP, UNIT_HOSTFP, "host FP", "HOSTFP", NULL },
     { MTAB_XTD|MTAB_VDV, 0, "IDLE", "IDLE", &cpu_set_idle, &cpu_show_idle },
     { MTAB_XTD|MTAB_VDV, 0, NULL, "NOIDLE", &sim_clr_idle, NULL },
     { UNIT_MSIZE, (1u << 23), NULL, "8M", &cpu_set_size },
@@ -538,6 +593,7 @@ if (abortval > 0) {                                     /* sim stop? */
     }
 else if (abortval < 0) {                                /* mm or rsrv or int */
     int32 i, delta;
+    ic_rep = ic_rec = NULL;                             /* abandon decode */
     if ((PSL & PSL_FPD) == 0) {                         /* FPD? no recovery */
         for (i = 0; i < recqptr; i++) {                 /* unwind inst */
             int32 rrn, rlnt;
@@ -695,6 +751,8 @@ for ( ;; ) {
         }
 
     sim_interval = sim_interval - 1;                    /* count instr */
+    if ((PSL & PSL_FPD) == 0)                           /* check decode cache */
+        ic_start ();
     GET_ISTR (opc, L_BYTE);                             /* get opcode */
     if (opc == 0xFD) {                                  /* 2 byte op? */
         GET_ISTR (opc, L_BYTE);                         /* get second byte */
@@ -839,7 +897,7 @@ for ( ;; ) {
                 recq[recqptr++] = RQ_REC (disp, rn);
             case RGD|RB: case RGD|RW: case RGD|RL: case RGD|RF:
                 CHECK_FOR_PC;
-                opnd[j++] = Read (va = R[rn], DR_LNT (disp), RA);
+                opnd[j++] = ReadF (va = R[rn], DR_LNT (disp), RA);
                 break;
 
             case ADC|RQ: case ADC|RD: case ADC|RG:
@@ -847,8 +905,8 @@ for ( ;; ) {
                 recq[recqptr++] = RQ_REC (disp, rn);
             case RGD|RQ: case RGD|RD: case RGD|RG:
                 CHECK_FOR_PC;
-                opnd[j++] = Read (va = R[rn], L_LONG, RA);
-                opnd[j++] = Read (R[rn] + 4, L_LONG, RA);
+                opnd[j++] = ReadF (va = R[rn], L_LONG, RA);
+                opnd[j++] = ReadF (R[rn] + 4, L_LONG, RA);
                 break;
 
             case ADC|RO: case ADC|RH:
@@ -864,7 +922,7 @@ for ( ;; ) {
                 recq[recqptr++] = RQ_REC (disp, rn);
             case RGD|MB: case RGD|MW: case RGD|ML:
                 CHECK_FOR_PC;
-                opnd[j++] = Read (va = R[rn], DR_LNT (disp), WA);
+                opnd[j++] = ReadF (va = R[rn], DR_LNT (disp), WA);
                 break;
 
             case ADC|MQ:
@@ -872,8 +930,8 @@ for ( ;; ) {
                 recq[recqptr++] = RQ_REC (disp, rn);
             case RGD|MQ:
                 CHECK_FOR_PC;
-                opnd[j++] = Read (va = R[rn], L_LONG, WA);
-                opnd[j++] = Read (R[rn] + 4, L_LONG, WA);
+                opnd[j++] = ReadF (va = R[rn], L_LONG, WA);
+                opnd[j++] = ReadF (R[rn] + 4, L_LONG, WA);
                 break;
 
             case ADC|MO:
@@ -906,7 +964,7 @@ for ( ;; ) {
                     GET_ISTR (opnd[j++], DR_LNT (disp));
                     }
                 else {
-                    opnd[j++] = Read (R[rn], DR_LNT (disp), RA);
+                    opnd[j++] = ReadF (R[rn], DR_LNT (disp), RA);
                     R[rn] = R[rn] + DR_LNT (disp);
                     recq[recqptr++] = RQ_REC (disp, rn);
                     }
@@ -919,8 +977,8 @@ for ( ;; ) {
                     GET_ISTR (opnd[j++], L_LONG);
                     }
                 else {
-                    opnd[j++] = Read (va, L_LONG, RA);
-                    opnd[j++] = Read (va + 4, L_LONG, RA);  
+                    opnd[j++] = ReadF (va, L_LONG, RA);
+                    opnd[j++] = ReadF (va + 4, L_LONG, RA);  
                     R[rn] = R[rn] + 8;
                     recq[recqptr++] = RQ_REC (disp, rn);
                     }
@@ -947,7 +1005,7 @@ for ( ;; ) {
                     GET_ISTR (opnd[j++], DR_LNT (disp));
                     }
                 else {
-                    opnd[j++] = Read (R[rn], DR_LNT (disp), WA);
+                    opnd[j++] = ReadF (R[rn], DR_LNT (disp), WA);
                     R[rn] = R[rn] + DR_LNT (disp);
                     recq[recqptr++] = RQ_REC (disp, rn);
                     }
@@ -960,8 +1018,8 @@ for ( ;; ) {
                     GET_ISTR (opnd[j++], L_LONG);
                     }
                 else {
-                    opnd[j++] = Read (va, L_LONG, WA);
-                    opnd[j++] = Read (va + 4, L_LONG, WA);  
+                    opnd[j++] = ReadF (va, L_LONG, WA);
+                    opnd[j++] = ReadF (va + 4, L_LONG, WA);  
                     R[rn] = R[rn] + 8;
                     recq[recqptr++] = RQ_REC (disp, rn);
                     }
@@ -992,7 +1050,7 @@ for ( ;; ) {
                     GET_ISTR (va = opnd[j++], L_LONG);
                     }
                 else {
-                    va = opnd[j++] = Read (R[rn], L_LONG, RA);
+                    va = opnd[j++] = ReadF (R[rn], L_LONG, RA);
                     R[rn] = R[rn] + 4;
                     recq[recqptr++] = RQ_REC (AID|RL, rn);
                     }
@@ -1003,11 +1061,11 @@ for ( ;; ) {
                     GET_ISTR (va, L_LONG);
                     }
                 else {
-                    va = Read (R[rn], L_LONG, RA);
+                    va = ReadF (R[rn], L_LONG, RA);
                     R[rn] = R[rn] + 4;
                     recq[recqptr++] = RQ_REC (AID|RL, rn);
                     }
-                opnd[j++] = Read (va, DR_LNT (disp), RA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), RA);
                 break;
 
             case AID|RQ: case AID|RD: case AID|RG:
@@ -1015,12 +1073,12 @@ for ( ;; ) {
                     GET_ISTR (va, L_LONG);
                     }
                 else {
-                    va = Read (R[rn], L_LONG, RA);
+                    va = ReadF (R[rn], L_LONG, RA);
                     R[rn] = R[rn] + 4;
                     recq[recqptr++] = RQ_REC (AID|RL, rn);
                     }
-                opnd[j++] = Read (va, L_LONG, RA);
-                opnd[j++] = Read (va + 4, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, RA);
+                opnd[j++] = ReadF (va + 4, L_LONG, RA);
                 break;
 
             case AID|RO: case AID|RH:
@@ -1028,7 +1086,7 @@ for ( ;; ) {
                     GET_ISTR (va, L_LONG);
                     }
                 else {
-                    va = Read (R[rn], L_LONG, RA);
+                    va = ReadF (R[rn], L_LONG, RA);
                     R[rn] = R[rn] + 4;
                     recq[recqptr++] = RQ_REC (AID|RL, rn);
                     }
@@ -1040,11 +1098,11 @@ for ( ;; ) {
                     GET_ISTR (va, L_LONG);
                     }
                 else {
-                    va = Read (R[rn], L_LONG, RA);
+                    va = ReadF (R[rn], L_LONG, RA);
                     R[rn] = R[rn] + 4;
                     recq[recqptr++] = RQ_REC (AID|RL, rn);
                     }
-                opnd[j++] = Read (va, DR_LNT (disp), WA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), WA);
                 break;
 
             case AID|MQ:
@@ -1052,12 +1110,12 @@ for ( ;; ) {
                     GET_ISTR (va, L_LONG);
                     }
                 else {
-                    va = Read (R[rn], L_LONG, RA);
+                    va = ReadF (R[rn], L_LONG, RA);
                     R[rn] = R[rn] + 4;
                     recq[recqptr++] = RQ_REC (AID|RL, rn);
                     }
-                opnd[j++] = Read (va, L_LONG, WA);
-                opnd[j++] = Read (va + 4, L_LONG, WA);
+                opnd[j++] = ReadF (va, L_LONG, WA);
+                opnd[j++] = ReadF (va + 4, L_LONG, WA);
                 break;
 
             case AID|MO:
@@ -1065,7 +1123,7 @@ for ( ;; ) {
                     GET_ISTR (va, L_LONG);
                     }
                 else {
-                    va = Read (R[rn], L_LONG, RA);
+                    va = ReadF (R[rn], L_LONG, RA);
                     R[rn] = R[rn] + 4;
                     recq[recqptr++] = RQ_REC (AID|RL, rn);
                     }
@@ -1085,14 +1143,14 @@ for ( ;; ) {
             case BDP|RB: case BDP|RW: case BDP|RL: case BDP|RF:
                 GET_ISTR (temp, L_BYTE);
                 va = R[rn] + SXTB (temp);
-                opnd[j++] = Read (va, DR_LNT (disp), RA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), RA);
                 break;
 
             case BDP|RQ: case BDP|RD: case BDP|RG:
                 GET_ISTR (temp, L_BYTE);        
                 va = R[rn] + SXTB (temp);
-                opnd[j++] = Read (va, L_LONG, RA);
-                opnd[j++] = Read (va + 4, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, RA);
+                opnd[j++] = ReadF (va + 4, L_LONG, RA);
                 break;
 
             case BDP|RO: case BDP|RH:
@@ -1104,14 +1162,14 @@ for ( ;; ) {
             case BDP|MB: case BDP|MW: case BDP|ML:
                 GET_ISTR (temp, L_BYTE);
                 va = R[rn] + SXTB (temp);
-                opnd[j++] = Read (va, DR_LNT (disp), WA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), WA);
                 break;
 
             case BDP|MQ:
                 GET_ISTR (temp, L_BYTE);        
                 va = R[rn] + SXTB (temp);
-                opnd[j++] = Read (va, L_LONG, WA);
-                opnd[j++] = Read (va + 4, L_LONG, WA);
+                opnd[j++] = ReadF (va, L_LONG, WA);
+                opnd[j++] = ReadF (va + 4, L_LONG, WA);
                 break;
 
             case BDP|MO:
@@ -1128,50 +1186,50 @@ for ( ;; ) {
             case BDD|AB: case BDD|AW: case BDD|AL: case BDD|AQ: case BDD|AO:
                 GET_ISTR (temp, L_BYTE);
                 iad = R[rn] + SXTB (temp);
-                va = opnd[j++] = Read (iad, L_LONG, RA);
+                va = opnd[j++] = ReadF (iad, L_LONG, RA);
                 break;
 
             case BDD|RB: case BDD|RW: case BDD|RL: case BDD|RF:
                 GET_ISTR (temp, L_BYTE);        
                 iad = R[rn] + SXTB (temp);
-                va = Read (iad, L_LONG, RA);    
-                opnd[j++] = Read (va, DR_LNT (disp), RA);
+                va = ReadF (iad, L_LONG, RA);    
+                opnd[j++] = ReadF (va, DR_LNT (disp), RA);
                 break;
 
             case BDD|RQ: case BDD|RD: case BDD|RG:
                 GET_ISTR (temp, L_BYTE);
                 iad = R[rn] + SXTB (temp);
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, L_LONG, RA);
-                opnd[j++] = Read (va + 4, L_LONG, RA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, RA);
+                opnd[j++] = ReadF (va + 4, L_LONG, RA);
                 break;  
 
             case BDD|RO: case BDD|RH:
                 GET_ISTR (temp, L_BYTE);
                 iad = R[rn] + SXTB (temp);
-                va = Read (iad, L_LONG, RA);
+                va = ReadF (iad, L_LONG, RA);
                 j = ReadOcta (va, opnd, j, RA);
                 break;  
 
             case BDD|MB: case BDD|MW: case BDD|ML:
                 GET_ISTR (temp, L_BYTE);        
                 iad = R[rn] + SXTB (temp);
-                va = Read (iad, L_LONG, RA);    
-                opnd[j++] = Read (va, DR_LNT (disp), WA);
+                va = ReadF (iad, L_LONG, RA);    
+                opnd[j++] = ReadF (va, DR_LNT (disp), WA);
                 break;
 
             case BDD|MQ:
                 GET_ISTR (temp, L_BYTE);
                 iad = R[rn] + SXTB (temp);
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, L_LONG, WA);
-                opnd[j++] = Read (va + 4, L_LONG, WA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, WA);
+                opnd[j++] = ReadF (va + 4, L_LONG, WA);
                 break;  
 
             case BDD|MO:
                 GET_ISTR (temp, L_BYTE);
                 iad = R[rn] + SXTB (temp);
-                va = Read (iad, L_LONG, RA);
+                va = ReadF (iad, L_LONG, RA);
                 j = ReadOcta (va, opnd, j, WA);
                 break;  
 
@@ -1188,14 +1246,14 @@ for ( ;; ) {
             case WDP|RB: case WDP|RW: case WDP|RL: case WDP|RF:
                 GET_ISTR (temp, L_WORD);
                 va = R[rn] + SXTW (temp);
-                opnd[j++] = Read (va, DR_LNT (disp), RA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), RA);
                 break;
 
             case WDP|RQ: case WDP|RD: case WDP|RG:
                 GET_ISTR (temp, L_WORD);
                 va = R[rn] + SXTW (temp);
-                opnd[j++] = Read (va, L_LONG, RA);
-                opnd[j++] = Read (va + 4, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, RA);
+                opnd[j++] = ReadF (va + 4, L_LONG, RA);
                 break;
 
             case WDP|RO: case WDP|RH:
@@ -1207,14 +1265,14 @@ for ( ;; ) {
             case WDP|MB: case WDP|MW: case WDP|ML:
                 GET_ISTR (temp, L_WORD);
                 va = R[rn] + SXTW (temp);
-                opnd[j++] = Read (va, DR_LNT (disp), WA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), WA);
                 break;
 
             case WDP|MQ:
                 GET_ISTR (temp, L_WORD);
                 va = R[rn] + SXTW (temp);
-                opnd[j++] = Read (va, L_LONG, WA);
-                opnd[j++] = Read (va + 4, L_LONG, WA);
+                opnd[j++] = ReadF (va, L_LONG, WA);
+                opnd[j++] = ReadF (va + 4, L_LONG, WA);
                 break;
 
             case WDP|MO:
@@ -1231,50 +1289,50 @@ for ( ;; ) {
             case WDD|AB: case WDD|AW: case WDD|AL: case WDD|AQ: case WDD|AO:
                 GET_ISTR (temp, L_WORD);
                 iad = R[rn] + SXTW (temp);
-                va = opnd[j++] = Read (iad, L_LONG, RA);
+                va = opnd[j++] = ReadF (iad, L_LONG, RA);
                 break;
 
             case WDD|RB: case WDD|RW: case WDD|RL: case WDD|RF:
                 GET_ISTR (temp, L_WORD);
                 iad = R[rn] + SXTW (temp);
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, DR_LNT (disp), RA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), RA);
                 break;
 
             case WDD|RQ: case WDD|RD: case WDD|RG:
                 GET_ISTR (temp, L_WORD);        
                 iad = R[rn] + SXTW (temp);
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, L_LONG, RA);
-                opnd[j++] = Read (va + 4, L_LONG, RA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, RA);
+                opnd[j++] = ReadF (va + 4, L_LONG, RA);
                 break;
 
             case WDD|RO: case WDD|RH:
                 GET_ISTR (temp, L_WORD);        
                 iad = R[rn] + SXTW (temp);
-                va = Read (iad, L_LONG, RA);
+                va = ReadF (iad, L_LONG, RA);
                 j = ReadOcta (va, opnd, j, RA);
                 break;
 
             case WDD|MB: case WDD|MW: case WDD|ML:
                 GET_ISTR (temp, L_WORD);
                 iad = R[rn] + SXTW (temp);
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, DR_LNT (disp), WA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), WA);
                 break;
 
             case WDD|MQ:
                 GET_ISTR (temp, L_WORD);        
                 iad = R[rn] + SXTW (temp);
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, L_LONG, WA);
-                opnd[j++] = Read (va + 4, L_LONG, WA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, WA);
+                opnd[j++] = ReadF (va + 4, L_LONG, WA);
                 break;
 
             case WDD|MO:
                 GET_ISTR (temp, L_WORD);        
                 iad = R[rn] + SXTW (temp);
-                va = Read (iad, L_LONG, RA);
+                va = ReadF (iad, L_LONG, RA);
                 j = ReadOcta (va, opnd, j, WA);
                 break;
 
@@ -1291,14 +1349,14 @@ for ( ;; ) {
             case LDP|RB: case LDP|RW: case LDP|RL: case LDP|RF:
                 GET_ISTR (temp, L_LONG);
                 va = R[rn] + temp;
-                opnd[j++] = Read (va, DR_LNT (disp), RA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), RA);
                 break;
 
             case LDP|RQ: case LDP|RD: case LDP|RG:
                 GET_ISTR (temp, L_LONG);
                 va = R[rn] + temp;
-                opnd[j++] = Read (va, L_LONG, RA);
-                opnd[j++] = Read (va + 4, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, RA);
+                opnd[j++] = ReadF (va + 4, L_LONG, RA);
                 break;
 
             case LDP|RO: case LDP|RH:
@@ -1310,14 +1368,14 @@ for ( ;; ) {
             case LDP|MB: case LDP|MW: case LDP|ML:
                 GET_ISTR (temp, L_LONG);
                 va = R[rn] + temp;
-                opnd[j++] = Read (va, DR_LNT (disp), WA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), WA);
                 break;
 
             case LDP|MQ:
                 GET_ISTR (temp, L_LONG);
                 va = R[rn] + temp;
-                opnd[j++] = Read (va, L_LONG, WA);
-                opnd[j++] = Read (va + 4, L_LONG, WA);
+                opnd[j++] = ReadF (va, L_LONG, WA);
+                opnd[j++] = ReadF (va + 4, L_LONG, WA);
                 break;
 
             case LDP|MO:
@@ -1334,50 +1392,50 @@ for ( ;; ) {
             case LDD|AB: case LDD|AW: case LDD|AL: case LDD|AQ: case LDD|AO:
                 GET_ISTR (temp, L_LONG);
                 iad = R[rn] + temp;
-                va = opnd[j++] = Read (iad, L_LONG, RA);
+                va = opnd[j++] = ReadF (iad, L_LONG, RA);
                 break;
 
             case LDD|RB: case LDD|RW: case LDD|RL: case LDD|RF:
                 GET_ISTR (temp, L_LONG);
                 iad = R[rn] + temp;
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, DR_LNT (disp), RA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), RA);
                 break;
 
             case LDD|RQ: case LDD|RD: case LDD|RG:
                 GET_ISTR (temp, L_LONG);
                 iad = R[rn] + temp;
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, L_LONG, RA);
-                opnd[j++] = Read (va + 4, L_LONG, RA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, RA);
+                opnd[j++] = ReadF (va + 4, L_LONG, RA);
                 break;
 
             case LDD|RO: case LDD|RH:
                 GET_ISTR (temp, L_LONG);
                 iad = R[rn] + temp;
-                va = Read (iad, L_LONG, RA);
+                va = ReadF (iad, L_LONG, RA);
                 j = ReadOcta (va, opnd, j, RA);
                 break;
 
             case LDD|MB: case LDD|MW: case LDD|ML:
                 GET_ISTR (temp, L_LONG);
                 iad = R[rn] + temp;
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, DR_LNT (disp), WA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, DR_LNT (disp), WA);
                 break;
 
             case LDD|MQ:
                 GET_ISTR (temp, L_LONG);
                 iad = R[rn] + temp;
-                va = Read (iad, L_LONG, RA);
-                opnd[j++] = Read (va, L_LONG, WA);
-                opnd[j++] = Read (va + 4, L_LONG, WA);
+                va = ReadF (iad, L_LONG, RA);
+                opnd[j++] = ReadF (va, L_LONG, WA);
+                opnd[j++] = ReadF (va + 4, L_LONG, WA);
                 break;
 
             case LDD|MO:
                 GET_ISTR (temp, L_LONG);
                 iad = R[rn] + temp;
-                va = Read (iad, L_LONG, RA);
+                va = ReadF (iad, L_LONG, RA);
                 j = ReadOcta (va, opnd, j, WA);
                 break;
 
@@ -1419,7 +1477,7 @@ for ( ;; ) {
                         GET_ISTR (temp, L_LONG);
                         }
                     else {
-                        temp = Read (R[rn], L_LONG, RA);
+                        temp = ReadF (R[rn], L_LONG, RA);
                         R[rn] = R[rn] + 4;
                         recq[recqptr++] = RQ_REC (AID|RL, rn);
                         }
@@ -1433,7 +1491,7 @@ for ( ;; ) {
 
                 case BDD:
                     GET_ISTR (temp, L_BYTE);
-                    index = index + Read (R[rn] + SXTB (temp), L_LONG, RA);
+                    index = index + ReadF (R[rn] + SXTB (temp), L_LONG, RA);
                     break;
 
                 case WDP:
@@ -1443,7 +1501,7 @@ for ( ;; ) {
 
                 case WDD:
                     GET_ISTR (temp, L_WORD);
-                    index = index + Read (R[rn] + SXTW (temp), L_LONG, RA);
+                    index = index + ReadF (R[rn] + SXTW (temp), L_LONG, RA);
                     break;
 
                 case LDP:
@@ -1453,7 +1511,7 @@ for ( ;; ) {
 
                 case LDD:
                     GET_ISTR (temp, L_LONG);
-                    index = index + Read (R[rn] + temp, L_LONG, RA);
+                    index = index + ReadF (R[rn] + temp, L_LONG, RA);
                     break;
 
                 default:
@@ -1469,12 +1527,12 @@ for ( ;; ) {
                     break;
 
                 case RB: case RW: case RL: case RF:
-                    opnd[j++] = Read (va = index, DR_LNT (disp), RA);
+                    opnd[j++] = ReadF (va = index, DR_LNT (disp), RA);
                     break;
 
                 case RQ: case RD: case RG:
-                    opnd[j++] = Read (va = index, L_LONG, RA);
-                    opnd[j++] = Read (index + 4, L_LONG, RA);
+                    opnd[j++] = ReadF (va = index, L_LONG, RA);
+                    opnd[j++] = ReadF (index + 4, L_LONG, RA);
                     break;
 
                 case RO: case RH:
@@ -1482,12 +1540,12 @@ for ( ;; ) {
                     break;
 
                 case MB: case MW: case ML:
-                    opnd[j++] = Read (va = index, DR_LNT (disp), WA);
+                    opnd[j++] = ReadF (va = index, DR_LNT (disp), WA);
                     break;
 
                 case MQ:
-                    opnd[j++] = Read (va = index, L_LONG, WA);
-                    opnd[j++] = Read (index + 4, L_LONG, WA);
+                    opnd[j++] = ReadF (va = index, L_LONG, WA);
+                    opnd[j++] = ReadF (index + 4, L_LONG, WA);
                     break;
 
                 case MO:
@@ -1505,6 +1563,8 @@ for ( ;; ) {
                 break;
                 }                                       /* end case spec */
             }                                           /* end for */
+        if (ic_rep || ic_rec)                           /* decode cache used? */
+            ic_end ();
         }                                               /* end if not FPD */
 
 /* Optionally record instruction history */
@@ -1644,7 +1704,7 @@ for ( ;; ) {
 */
 
     case PUSHL: case PUSHAB: case PUSHAW: case PUSHAL: case PUSHAQ:
-        Write (SP - 4, op0, L_LONG, WA);                /* push operand */
+        WriteF (SP - 4, op0, L_LONG, WA);               /* push operand */
         SP = SP - 4;                                    /* decr stack ptr */
         CC_IIZP_L (op0);                                /* set cc's */
         break;
@@ -2156,13 +2216,13 @@ for ( ;; ) {
         break;
 
     case BSBB:
-        Write (SP - 4, PC, L_LONG, WA);                 /* push PC on stk */
+        WriteF (SP - 4, PC, L_LONG, WA);                /* push PC on stk */
         SP = SP - 4;                                    /* decr stk ptr */
         BRANCHB (brdisp);                               /* branch  */
         break;
 
     case BSBW:
-        Write (SP - 4, PC, L_LONG, WA);                 /* push PC on stk */
+        WriteF (SP - 4, PC, L_LONG, WA);                /* push PC on stk */
         SP = SP - 4;                                    /* decr stk ptr */
         BRANCHW (brdisp);                               /* branch */
         break;
@@ -2239,7 +2299,7 @@ for ( ;; ) {
 */
 
     case JSB:
-        Write (SP - 4, PC, L_LONG, WA);                 /* push PC on stk */
+        WriteF (SP - 4, PC, L_LONG, WA);                /* push PC on stk */
         SP = SP - 4;                                    /* decr stk ptr */
 
     case JMP:
@@ -2247,7 +2307,7 @@ for ( ;; ) {
         break;
 
     case RSB:
-        temp = Read (SP, L_LONG, RA);                   /* get top of stk */
+        temp = ReadF (SP, L_LONG, RA);                  /* get top of stk */
         SP = SP + 4;                                    /* incr stk ptr */
         JUMP (temp);
         break;
@@ -3057,6 +3117,65 @@ for ( ;; ) {
 ABORT (STOP_UNKNOWN);
 }                                                       /* end sim_instr */
 
+/* Operand read and write, TB fast path
+
+   Operand references that are naturally aligned (and therefore within
+   a page), hit in the TB with the required access, and map main memory
+   are done directly on M through the entry's host page pointer.  Only
+   the most recently used way of the set is checked.  The access bits
+   and the modify bit in the TB pte already reflect the access mode and
+   read/write kind, so no other checks are needed.
+   Everything else - mapping off, TB misses, faults, I/O space, and
+   unaligned references - goes through Read and Write in vax_mmu.c.
+*/
+
+static TB_INLINE int32 ReadF (uint32 va, int32 lnt, int32 acc)
+{
+int32 vpn = VA_GETVPN (va);
+TLBENT *tlbp = ((va & VA_S0)? stlb: ptlb) + TLB_SET (vpn);
+int32 tag = vpn | ((va & VA_S0)? tlb_sgen: tlb_pgen);
+uint32 dat;
+
+if (mapen && (tlbp->tag == tag) && (tlbp->pte & acc) && tlbp->hp &&
+    ((va & (lnt - 1)) == 0)) {
+    tlb_hit++;
+    dat = tlbp->hp[VA_GETOFF (va) >> 2];
+    if (lnt >= L_LONG)                                  /* long, quad? */
+        return dat;
+    if (lnt == L_WORD)                                  /* word? */
+        return ((dat >> ((va & 2)? 16: 0)) & WMASK);
+    return ((dat >> ((va & 3) << 3)) & BMASK);          /* byte */
+    }
+return Read (va, lnt, acc);
+}
+
+static TB_INLINE void WriteF (uint32 va, int32 val, int32 lnt, int32 acc)
+{
+int32 vpn = VA_GETVPN (va);
+TLBENT *tlbp = ((va & VA_S0)? stlb: ptlb) + TLB_SET (vpn);
+int32 tag = vpn | ((va & VA_S0)? tlb_sgen: tlb_pgen);
+uint32 *mp;
+int32 sc;
+
+if (mapen && (tlbp->tag == tag) && (tlbp->pte & acc) &&
+    (tlbp->pte & TLB_M) && tlbp->hp && ((va & (lnt - 1)) == 0)) {
+    tlb_hit++;
+    mp = tlbp->hp + (VA_GETOFF (va) >> 2);
+    if (lnt >= L_LONG)                                  /* long, quad? */
+        *mp = val;
+    else if (lnt == L_WORD)                             /* word? */
+        *mp = (va & 2)? (*mp & 0xFFFF) | (val << 16):
+            (*mp & ~0xFFFF) | val;
+    else {                                              /* byte */
+        sc = (va & 3) << 3;
+        *mp = (*mp & ~(0xFF << sc)) | (val << sc);
+        }
+    return;
+    }
+Write (va, val, lnt, acc);
+return;
+}
+
 /* Prefetch buffer routine
 
    Prefetch buffer state
@@ -3081,6 +3200,10 @@ SIM_INLINE int32 get_istr (int32 lnt, int32 acc)
 int32 bo = PC & 3;
 int32 sc, val, t;
 
+if (ic_rep) {                                           /* decode cache hit? */
+    PC = PC + lnt;                                      /* incr PC */
+    return ic_rep->val[ic_idx++];                       /* next value */
+    }
 while ((bo + lnt) > ibcnt) {                            /* until enuf bytes */
     if ((ppc < 0) || (VA_GETOFF (ppc) == 0)) {          /* PPC inv, xpg? */
         ppc = Test ((PC + ibcnt) & ~03, RD, &t);        /* xlate PC */
@@ -3110,9 +3233,104 @@ if ((bo + lnt) >= 4) {                                  /* retire ibufl? */
     ibufl = ibufh;
     ibcnt = ibcnt - 4;
     }
+if (ic_rec) {                                           /* recording decode? */
+    if (ic_rec->nval < IC_MAXVAL)
+        ic_rec->val[ic_rec->nval++] = val;
+    else ic_rec = NULL;                                 /* too long, give up */
+    }
 return val;
 }
 
+/* Decode cache routines
+
+   ic_start is called before the opcode is fetched.  It finds the physical
+   PC, from the prefetch buffer if that is still valid, or by translating
+   PC.  If the cache entry for the physical PC matches memory, it is
+   replayed; otherwise the entry is rebuilt from this decode.
+
+   The physical address of the longword containing PC is ppc - ibcnt,
+   provided no translation happened between fetching that longword and
+   ppc, i.e., ppc (or, with eight bytes buffered, ppc - 4) is not on a
+   page boundary.
+
+   ic_end is called after the last specifier has been decoded.  After a
+   replay, the prefetch buffer is restarted at the new PC; after a
+   recording, the entry is validated if the instruction can be cached.
+*/
+
+void ic_start (void)
+{
+int32 pa, t, i;
+ICENT *ic;
+
+ic_rep = ic_rec = NULL;
+if ((ppc >= 0) &&                                       /* prefetch valid? */
+    ((ibcnt == 4) ||
+     ((ibcnt == 0) && (VA_GETOFF (ppc) != 0)) ||
+     ((ibcnt == 8) && (VA_GETOFF (ppc - 4) != 0))))
+    pa = ppc - ibcnt + (PC & 3);
+else {
+    pa = Test (PC, RD, &t);                             /* xlate PC */
+    if (pa < 0)                                         /* let decode fault */
+        return;
+    }
+if (!ADDR_IS_MEM (pa))                                  /* not memory? */
+    return;
+ic = &ic_tab[IC_HASH (pa)];
+ic_pa = pa;
+ic_pc = PC;
+if (ic->tag == pa) {                                    /* tag match? */
+    for (i = 0; i < ic->nlw; i++) {                     /* memory unchanged? */
+        if (M[(pa >> 2) + i] != ic->lw[i])
+            break;
+        }
+    if (i == ic->nlw) {                                 /* hit */
+        ic_rep = ic;
+        ic_idx = 0;
+        return;
+        }
+    }
+ic->tag = -1;                                           /* rebuild entry */
+ic->nval = 0;
+ic_rec = ic;
+return;
+}
+
+void ic_end (void)
+{
+int32 lnt = PC - ic_pc;
+int32 i, nlw;
+
+if (ic_rep) {                                           /* replayed? */
+    ibcnt = 0;                                          /* restart prefetch */
+    ppc = (ic_pa + lnt) & ~03;
+    ic_rep = NULL;
+    return;
+    }
+nlw = ((ic_pa & 3) + lnt + 3) >> 2;                     /* lw's spanned */
+if (((VA_GETOFF (ic_pa) + lnt) <= VA_PAGSIZE) &&        /* within page? */
+    (nlw <= IC_MAXLW)) {
+    for (i = 0; i < nlw; i++)                           /* save memory */
+        ic_rec->lw[i] = M[(ic_pa >> 2) + i];
+    ic_rec->nlw = nlw;
+    ic_rec->tag = ic_pa;                                /* validate */
+    }
+ic_rec = NULL;
+return;
+}
+
+/* Flush decode cache */
+
+void ic_flush (void)
+{
+int32 i;
+
+for (i = 0; i < IC_SIZE; i++)
+    ic_tab[i].tag = -1;
+ic_rep = ic_rec = NULL;
+return;
+}
+
 /* Read octaword specifier */
 
 int32 ReadOcta (int32 va, int32 *opnd, int32 j, int32 acc)
@@ -3136,6 +3354,8 @@ return;
 
 t_stat cpu_reset (DEVICE *dptr)
 {
+void *mp;
+
 hlt_pin = 0;
 mem_err = 0;
 crd_err = 0;
@@ -3144,15 +3364,16 @@ SISR = 0;
 ASTLVL = 4;
 mapen = 0;
 FLUSH_ISTR;                                             /* init I-stream */
+ic_flush ();                                            /* init decode cache */
 if (M == NULL) {                                        /* first time init? */
     sim_brk_types = sim_brk_dflt = SWMASK ('E');
     pcq_r = find_reg ("PCQ", NULL, dptr);
     if (pcq_r == NULL)
         return SCPE_IERR;
     pcq_r->qptr = 0;
-    M = (uint32 *) calloc (((uint32) MEMSIZE) >> 2, sizeof (uint32));
-    if (M == NULL)
+    if (sim_ram_alloc ((size_t) MEMSIZE, MAXMEMSIZE_X, &M_ram, &mp) != SCPE_OK)
         return SCPE_MEM;
+    M = (uint32 *) mp;
     }
 return build_dib_tab ();
 }
@@ -3208,8 +3429,8 @@ return SCPE_NXM;
 t_stat cpu_set_size (UNIT *uptr, int32 val, char *cptr, void *desc)
 {
 int32 mc = 0;
-uint32 i, clim, uval = (uint32)val;
-uint32 *nM = NULL;
+uint32 i, uval = (uint32)val;
+void *mp;
 
 if ((val <= 0) || (val > MAXMEMSIZE_X))
     return SCPE_ARG;
@@ -3217,14 +3438,9 @@ for (i = val; i < MEMSIZE; i = i + 4)
     mc = mc | M[i >> 2];
 if ((mc != 0) && !get_yn ("Really truncate memory [N]?", FALSE))
     return SCPE_OK;
-nM = (uint32 *) calloc (uval >> 2, sizeof (uint32));
-if (nM == NULL)
+if (sim_ram_resize (M_ram, uval, &mp) != SCPE_OK)       /* resize in place */
     return SCPE_MEM;
-clim = (uint32)((uval < MEMSIZE)? uval: MEMSIZE);
-for (i = 0; i < clim; i = i + 4)
-    nM[i >> 2] = M[i >> 2];
-free (M);
-M = nM;
+M = (uint32 *) mp;
 MEMSIZE = uval; 
 reset_all (0);
 return SCPE_OK;
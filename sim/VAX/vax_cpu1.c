@@ -108,6 +108,7 @@ extern int32 ibcnt, ppc;
 extern DEVICE cpu_dev;
 
 extern int32 Test (uint32 va, int32 acc, int32 *status);
+extern uint8 *MapStr (uint32 va, int32 acc, int32 *lnt);
 extern void set_map_reg (void);
 extern void zap_tb (int stb);
 extern void zap_tb_ent (uint32 va);
@@ -802,6 +803,15 @@ return 0;                                               /* q can't be empty */
 #define MVC_M_STATE     3
 #define MVC_V_CC        2
 
+/* The string instructions first process as much of their operands as
+   possible a page at a time, directly on M (see MapStr); the byte and
+   longword loops then finish whatever is left (I/O space, big endian
+   hosts, and the final mismatch or match in the scans).  The registers
+   are updated after each page, so a fault on the next page leaves the
+   instruction in a correct first part done state. */
+
+#define MIN(x,y)        (((x) < (y))? (x): (y))
+
 /* MOVC3, MOVC5
 
    if PSL<fpd> = 0 and MOVC3,
@@ -829,6 +839,8 @@ int32 op_movc (int32 *opnd, int32 movc5, int32 acc)
 {
 int32 i, cc, fill, wd;
 int32 j, lnt, mlnt[3];
+int32 sl, dl;
+uint8 *sp, *dp;
 static const int32 looplnt[3] = { L_BYTE, L_LONG, L_BYTE };
 
 if (PSL & PSL_FPD) {                                    /* FPD set? */
@@ -880,6 +892,17 @@ else {
 switch (R[5] & MVC_M_STATE) {                           /* case on state */
 
     case MVC_FRWD:                                      /* move forward */
+        while (R[2] > 0) {                              /* bulk, by page */
+            if (((sp = MapStr (R[1], RA, &sl)) == NULL) ||
+                ((dp = MapStr (R[3], WA, &dl)) == NULL))
+                break;
+            lnt = MIN (MIN (sl, dl), R[2]);             /* to 1st page end */
+            memmove (dp, sp, lnt);
+            R[1] = R[1] + lnt;                          /* inc src addr */
+            R[3] = R[3] + lnt;                          /* inc dst addr */
+            R[2] = R[2] - lnt;                          /* dec move lnt */
+            sim_interval = sim_interval - ((lnt + 3) >> 2);
+            }
         mlnt[0] = (4 - R[3]) & 3;                       /* length to align */
         if (mlnt[0] > R[2])                             /* cant exceed total */
             mlnt[0] = R[2];
@@ -898,6 +921,19 @@ switch (R[5] & MVC_M_STATE) {                           /* case on state */
         goto FILL;                                      /* check for fill */
 
     case MVC_BACK:                                      /* move backward */
+        while (R[2] > 0) {                              /* bulk, by page */
+            if (((sp = MapStr (R[1] - 1, RA, &sl)) == NULL) ||
+                ((dp = MapStr (R[3] - 1, WA, &dl)) == NULL))
+                break;
+            sl = VA_GETOFF (R[1] - 1) + 1;              /* to page start */
+            dl = VA_GETOFF (R[3] - 1) + 1;
+            lnt = MIN (MIN (sl, dl), R[2]);
+            memmove (dp + 1 - lnt, sp + 1 - lnt, lnt);
+            R[1] = R[1] - lnt;                          /* dec src addr */
+            R[3] = R[3] - lnt;                          /* dec dst addr */
+            R[2] = R[2] - lnt;                          /* dec move lnt */
+            sim_interval = sim_interval - ((lnt + 3) >> 2);
+            }
         mlnt[0] = R[3] & 03;                            /* length to align */
         if (mlnt[0] > R[2])                             /* cant exceed total */
             mlnt[0] = R[2];
@@ -921,6 +957,15 @@ switch (R[5] & MVC_M_STATE) {                           /* case on state */
         if (R[4] <= 0)                                  /* any fill? */
             break;
         R[5] = R[5] | MVC_FILL;                         /* set state */
+        while (R[4] > 0) {                              /* bulk, by page */
+            if ((dp = MapStr (R[3], WA, &dl)) == NULL)
+                break;
+            lnt = MIN (dl, R[4]);
+            memset (dp, fill & BMASK, lnt);
+            R[3] = R[3] + lnt;                          /* inc dst addr */
+            R[4] = R[4] - lnt;                          /* dec fill lnt */
+            sim_interval = sim_interval - ((lnt + 3) >> 2);
+            }
         mlnt[0] = (4 - R[3]) & 3;                       /* length to align */
         if (mlnt[0] > R[4])                             /* cant exceed total */
             mlnt[0] = R[4];
@@ -974,6 +1019,8 @@ return cc;
 int32 op_cmpc (int32 *opnd, int32 cmpc5, int32 acc)
 {
 int32 cc, s1, s2, fill;
+int32 lnt, l1, l2;
+uint8 *s1p, *s2p;
 
 if (PSL & PSL_FPD) {                                    /* FPD set? */
     SETPC (fault_PC + STR_GETDPC (R[0]));               /* reset PC */
@@ -995,6 +1042,26 @@ else {
     PSL = PSL | PSL_FPD;
     }
 R[2] = R[2] & STR_LNMASK;                               /* mask src2len */
+while ((R[0] & STR_LNMASK) && R[2]) {                   /* bulk, by page */
+    if (((s1p = MapStr (R[1], RA, &l1)) == NULL) ||
+        ((s2p = MapStr (R[3], RA, &l2)) == NULL))
+        break;
+    l1 = MIN (l1, R[0] & STR_LNMASK);
+    l2 = MIN (l2, R[2]);
+    lnt = MIN (l1, l2);
+    if (memcmp (s1p, s2p, lnt) != 0) {                  /* mismatch? */
+        for (l1 = 0; s1p[l1] == s2p[l1]; l1++) ;        /* find it */
+        lnt = l1;                                       /* skip equal part */
+        l2 = -1;                                        /* flag mismatch */
+        }
+    R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - lnt) & STR_LNMASK);
+    R[1] = R[1] + lnt;
+    R[2] = R[2] - lnt;
+    R[3] = R[3] + lnt;
+    sim_interval = sim_interval - lnt;
+    if (l2 < 0)                                         /* byte loop does */
+        break;                                          /* the mismatch */
+    }
 for (s1 = s2 = 0; ((R[0] | R[2]) & STR_LNMASK) != 0; sim_interval--) {
     if (R[0] & STR_LNMASK)                              /* src1? read */
         s1 = Read (R[1], L_BYTE, RA);
@@ -1034,6 +1101,8 @@ return cc;
 int32 op_locskp (int32 *opnd, int32 skpc, int32 acc)
 {
 int32 c, match;
+int32 i, lnt;
+uint8 *sp, *ep;
 
 if (PSL & PSL_FPD) {                                    /* FPD set? */
     SETPC (fault_PC + STR_GETDPC (R[0]));               /* reset PC */
@@ -1045,6 +1114,23 @@ else {
     R[1] = opnd[2];                                     /* src addr */
     PSL = PSL | PSL_FPD;
     }
+while ((R[0] & STR_LNMASK) != 0) {                      /* bulk, by page */
+    if ((sp = MapStr (R[1], RA, &lnt)) == NULL)
+        break;
+    lnt = MIN (lnt, R[0] & STR_LNMASK);
+    if (skpc) {                                         /* SKPC? */
+        for (i = 0; (i < lnt) && (sp[i] == match); i++) ;
+        }
+    else {                                              /* LOCC */
+        ep = (uint8 *) memchr (sp, match, lnt);
+        i = ep? (int32) (ep - sp): lnt;
+        }
+    R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - i) & STR_LNMASK);
+    R[1] = R[1] + i;                                    /* incr src1adr */
+    sim_interval = sim_interval - i;
+    if (i < lnt)                                        /* found? */
+        break;
+    }
 for ( ; (R[0] & STR_LNMASK) != 0; sim_interval-- ) {    /* loop thru string */
     c = Read (R[1], L_BYTE, RA);                        /* get src byte */
     if ((c == match) ^ skpc)                            /* match & locc? */
@@ -1074,6 +1160,8 @@ return (R[0]? 0: CC_Z);                                 /* set cc's */
 int32 op_scnspn (int32 *opnd, int32 spanc, int32 acc)
 {
 int32 c, t, mask;
+int32 i, lnt, tl;
+uint8 *sp, *tp;
 
 if (PSL & PSL_FPD) {                                    /* FPD set? */
     SETPC (fault_PC + STR_GETDPC (R[0]));               /* reset PC */
@@ -1086,6 +1174,19 @@ else {
     R[0] = STR_PACK (mask, opnd[0]);                    /* srclen + FPD data */
     PSL = PSL | PSL_FPD;
     }
+while (((R[0] & STR_LNMASK) != 0) &&                    /* bulk, by page, */
+    ((VA_GETOFF (R[3]) + 256) <= VA_PAGSIZE)) {         /* if table in 1 page */
+    if (((sp = MapStr (R[1], RA, &lnt)) == NULL) ||
+        ((tp = MapStr (R[3], RA, &tl)) == NULL))
+        break;
+    lnt = MIN (lnt, R[0] & STR_LNMASK);
+    for (i = 0; (i < lnt) && ((((tp[sp[i]] & mask) != 0) ^ spanc) == 0); i++) ;
+    R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - i) & STR_LNMASK);
+    R[1] = R[1] + i;
+    sim_interval = sim_interval - i;
+    if (i < lnt)                                        /* found? */
+        break;
+    }
 for ( ; (R[0] & STR_LNMASK) != 0; sim_interval-- ) {    /* loop thru string */
     c = Read (R[1], L_BYTE, RA);                        /* get byte */
     t = Read (R[3] + c, L_BYTE, RA);                    /* get table ent */
@@ -95,6 +95,11 @@
 #define RQ_GETRN(x)     ((x) & RQ_RN)
 #define RQ_GETLNT(x)    (((x) >> RQ_V_LNT) & RQ_M_LNT)
 
+/* CPU unit flags shared with the instruction modules */
+
+#define UNIT_V_HOSTFP   (UNIT_V_UF + 2)                 /* host FP fast path */
+#define UNIT_HOSTFP     (1u << UNIT_V_HOSTFP)
+
 /* Address space */
 
 #define VAMASK          0xFFFFFFFF                      /* virt addr mask */
@@ -227,11 +232,12 @@
 #define VA_S0           (1u << 31)                      /* S0 space */
 #define VA_P1           (1u << 30)                      /* P1 space */
 #define VA_N_TBI        12                              /* TB index size */
-#define VA_TBSIZE       (1u << VA_N_TBI)                /* TB size */
-#define VA_M_TBI        ((1u << VA_N_TBI) - 1)          /* TB index mask */
+#define VA_TBSIZE       (1u << VA_N_TBI)                /* default TB size */
+#define VA_TBMIN        16                              /* min TB size */
+#define VA_TBMAX        (1u << 16)                      /* max TB size */
+#define VA_TBWMAX       16                              /* max TB ways */
 #define VA_GETOFF(x)    ((x) & VA_M_OFF)
 #define VA_GETVPN(x)    (((x) >> VA_V_VPN) & VA_M_VPN)
-#define VA_GETTBI(x)    ((x) & VA_M_TBI)
 
 /* PTE */
 
@@ -256,6 +262,17 @@
 #define TLB_N_PFN       (PAWIDTH - VA_N_OFF)            /* ppfn size */
 #define TLB_M_PFN       ((1u << TLB_N_PFN) - 1)         /* ppfn mask */
 #define TLB_PFN         (TLB_M_PFN << VA_V_VPN)
+#define TLB_V_GEN       VA_N_VPN                        /* tag generation */
+#define TLB_M_GEN       0x1FF
+#define TLB_GEN_INC     (1u << TLB_V_GEN)
+#define TLB_GEN_MAX     (TLB_M_GEN << TLB_V_GEN)
+#define TLB_SET(v)      (((v) & tlb_smask) << tlb_wshift)   /* set base */
+
+typedef struct {
+    int32       tag;                                    /* tag */
+    int32       pte;                                    /* pte */
+    uint32      *hp;                                    /* host page ptr, */
+    } TLBENT;                                           /* NULL if not mem */
 
 /* Traps and interrupt requests */
 
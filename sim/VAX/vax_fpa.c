@@ -59,6 +59,7 @@
 
 #include "vax_defs.h"
 #include <setjmp.h>
+#include <float.h>
 
 extern int32 R[16];
 extern int32 PSL;
@@ -621,9 +622,224 @@ if (r->exp <= 0) {                                      /* underflow? */
 return r->sign | (r->exp << G_V_EXP) | UF_GETGHI (r->frac);
 }
 
+/* Host floating point fast path
+
+   With SET CPU HOSTFP, F and G floating add, subtract, multiply, and
+   divide are done in host IEEE double precision, on hosts that evaluate
+   double expressions in double (FLT_EVAL_METHOD 0).  The results are bit
+   for bit those of the routines above:
+
+   - F operands are exact in double.  F products are exact; F sums are
+     exact or too far from an F rounding point for the double rounding
+     to matter; and the F round bit of a quotient of 24b fractions cannot
+     be disturbed by rounding it to 53b.  So rounding the double result
+     to F, half away from zero as the VAX does, gives the VAX result.
+   - G has the precision of double, and IEEE round to nearest even
+     differs from VAX rounding only on exact ties.  A tie in a sum is
+     detected from the exact error of the sum (TwoSum) and rounded away
+     from zero; a possible tie in a product is detected from the low
+     bits of the integer product and left to the software routines;
+     quotients cannot produce ties.
+
+   Everything else - reserved operands, zero divisors, G operands or
+   results in the IEEE denormal range, overflow and underflow - returns
+   FALSE, and the caller uses the software routines, which also take
+   the faults.  D floating has 56b fractions and is always done in
+   software.
+*/
+
+#if defined (FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+
+typedef union {
+    double              d;
+    t_uint64            i;
+    } HFP;
+
+#define HF_SIGN         0x8000000000000000              /* sign */
+#define HF_V_EXP        52                              /* exponent */
+#define HF_M_EXP        0x7FF
+#define HF_BIAS         1023
+#define HF_FRAC         0x000FFFFFFFFFFFFF              /* fraction */
+#define HF_HB           0x0010000000000000              /* hidden bit */
+#define HF_GETEXP(x)    ((int32) (((x) >> HF_V_EXP) & HF_M_EXP))
+#define HF_V_F          (HF_V_EXP - 23)                 /* F lsb */
+#define HF_FRND         (((t_uint64) 1) << (HF_V_F - 1)) /* F round */
+#define HF_FOFF         (FD_BIAS + 1 - HF_BIAS)         /* F exp - host exp */
+#define HF_GOFF         (G_BIAS + 1 - HF_BIAS)          /* G exp - host exp */
+
+#define HFP_ADD         0                               /* s2 + s1 */
+#define HFP_SUB         1                               /* s2 - s1 */
+#define HFP_MUL         2                               /* s2 * s1 */
+#define HFP_DIV         3                               /* s2 / s1 */
+
+#define HFP_F(op,s1,s2,r) \
+                        ((cpu_unit.flags & UNIT_HOSTFP) && hfp_opf (op, s1, s2, r))
+#define HFP_G(op,o,rh,r) \
+                        ((cpu_unit.flags & UNIT_HOSTFP) && hfp_opg (op, o, rh, r))
+
+extern UNIT cpu_unit;
+
+static t_bool hfp_unpackf (int32 hi, HFP *r)
+{
+int32 exp = FD_GETEXP (hi);
+
+if (exp == 0) {                                         /* exp = 0? */
+    if (hi & FPSIGN)                                    /* if -, rsvd op */
+        return FALSE;
+    r->d = 0.0;                                         /* else 0 */
+    return TRUE;
+    }
+r->i = ((hi & FPSIGN)? HF_SIGN: 0) |
+    (((t_uint64) (exp - HF_FOFF)) << HF_V_EXP) |
+    (((t_uint64) (hi & FD_FRACW)) << (HF_V_F + 16)) |
+    (((t_uint64) ((hi >> 16) & WMASK)) << HF_V_F);
+return TRUE;
+}
+
+static t_bool hfp_packf (HFP *r, int32 *res)
+{
+t_uint64 mag = r->i & ~HF_SIGN;
+int32 exp;
+uint32 frac;
+
+if (mag == 0) {                                         /* result 0? */
+    *res = 0;
+    return TRUE;
+    }
+mag = (mag + HF_FRND) & ~(HF_FRND + HF_FRND - 1);       /* round, truncate */
+exp = HF_GETEXP (mag) + HF_FOFF;
+if ((exp <= 0) || (exp > (int32) FD_M_EXP))             /* unfl or ovfl? */
+    return FALSE;
+frac = (uint32) (mag >> HF_V_F);
+*res = ((r->i & HF_SIGN)? FPSIGN: 0) | (exp << FD_V_EXP) |
+    ((frac >> 16) & FD_FRACW) | ((frac & WMASK) << 16);
+return TRUE;
+}
+
+static t_bool hfp_unpackg (int32 hi, int32 lo, HFP *r)
+{
+int32 exp = G_GETEXP (hi);
+
+if (exp == 0) {                                         /* exp = 0? */
+    if (hi & FPSIGN)                                    /* if -, rsvd op */
+        return FALSE;
+    r->d = 0.0;                                         /* else 0 */
+    return TRUE;
+    }
+if (exp <= HF_GOFF)                                     /* host denormal? */
+    return FALSE;
+r->i = UNSCRAM (hi, lo) - (((t_uint64) HF_GOFF) << HF_V_EXP);
+return TRUE;
+}
+
+static t_bool hfp_packg (HFP *r, int32 *rh, int32 *res)
+{
+t_uint64 g;
+int32 exp = HF_GETEXP (r->i);
+
+if ((r->i & ~HF_SIGN) == 0) {                           /* result 0? */
+    *rh = 0;
+    return (*res = 0, TRUE);
+    }
+if ((exp == 0) || ((exp + HF_GOFF) > (int32) G_M_EXP))  /* unfl or ovfl? */
+    return FALSE;
+g = r->i + (((t_uint64) HF_GOFF) << HF_V_EXP);          /* rebias */
+*rh = (int32) (((g >> 16) & WMASK) | ((g << 16) & 0xFFFF0000));
+*res = (int32) (((g >> 48) & WMASK) | ((g >> 16) & 0xFFFF0000));
+return TRUE;
+}
+
+static t_bool hfp_opf (int32 op, int32 s1, int32 s2, int32 *res)
+{
+HFP a, b, r;
+
+if (!hfp_unpackf (s1, &a) || !hfp_unpackf (s2, &b))    /* rsvd operand? */
+    return FALSE;
+switch (op) {
+
+    case HFP_ADD:
+        r.d = b.d + a.d;
+        break;
+
+    case HFP_SUB:
+        r.d = b.d - a.d;
+        break;
+
+    case HFP_MUL:
+        r.d = b.d * a.d;
+        break;
+
+    case HFP_DIV:
+        if (a.d == 0.0)                                 /* divide by zero? */
+            return FALSE;
+        r.d = b.d / a.d;
+        break;
+        }
+return hfp_packf (&r, res);
+}
+
+/* G operands are opnd[0:1] = s1, opnd[2:3] = s2 */
+
+static t_bool hfp_opg (int32 op, int32 *opnd, int32 *rh, int32 *res)
+{
+HFP a, b, r, n;
+double y, bb, err;
+t_uint64 p;
+
+if (!hfp_unpackg (opnd[0], opnd[1], &a) ||              /* rsvd or denormal */
+    !hfp_unpackg (opnd[2], opnd[3], &b))                /* operand? */
+    return FALSE;
+switch (op) {
+
+    case HFP_ADD: case HFP_SUB:
+        y = (op == HFP_SUB)? -a.d: a.d;
+        r.d = b.d + y;
+        bb = r.d - b.d;                                 /* exact error */
+        err = (b.d - (r.d - bb)) + (y - bb);
+        if (err != 0.0) {                               /* inexact? */
+            n.i = r.i + 1;                              /* next larger mag */
+            if ((n.d - r.d) == (err + err))             /* tie, rounded down? */
+                r = n;                                  /* round away */
+            }
+        break;
+
+    case HFP_MUL:
+        if ((a.d == 0.0) || (b.d == 0.0)) {             /* zero operand? */
+            r.d = 0.0;
+            break;
+            }
+        r.d = b.d * a.d;
+        if (r.d == 0.0)                                 /* host underflow? */
+            return FALSE;
+        p = ((a.i & HF_FRAC) | HF_HB) * ((b.i & HF_FRAC) | HF_HB);
+        if (((p & (HF_HB - 1)) == (HF_HB >> 1)) ||      /* possible tie? */
+            ((p & ((HF_HB << 1) - 1)) == HF_HB))
+            return FALSE;
+        break;
+
+    case HFP_DIV:
+        if (a.d == 0.0)                                 /* divide by zero? */
+            return FALSE;
+        r.d = b.d / a.d;
+        if ((r.d == 0.0) && (b.d != 0.0))               /* host underflow? */
+            return FALSE;
+        break;
+        }
+return hfp_packg (&r, rh, res);
+}
+
+#else
+
+#define HFP_F(op,s1,s2,r)   FALSE
+#define HFP_G(op,o,rh,r)    FALSE
+
+#endif
+
 #else                                                   /* 32b code */
 
 #define WORDSWAP(x)     ((((x) & WMASK) << 16) | (((x) >> 16) & WMASK))
+#define HFP_F(op,s1,s2,r)   FALSE                       /* no host FP path */
+#define HFP_G(op,o,rh,r)    FALSE
 
 typedef struct {
     uint32              lo;
@@ -1397,7 +1613,10 @@ return rpackfd (&a, NULL);
 int32 op_addf (int32 *opnd, t_bool sub)
 {
 UFP a, b;
+int32 r;
 
+if (HFP_F ((sub? HFP_SUB: HFP_ADD), opnd[0], opnd[1], &r)) /* host FP? */
+    return r;
 unpackf (opnd[0], &a);                                  /* F format */
 unpackf (opnd[1], &b);
 if (sub)                                                /* sub? -s1 */
@@ -1421,7 +1640,10 @@ return rpackfd (&a, rh);
 int32 op_addg (int32 *opnd, int32 *rh, t_bool sub)
 {
 UFP a, b;
+int32 r;
 
+if (HFP_G ((sub? HFP_SUB: HFP_ADD), opnd, rh, &r))      /* host FP? */
+    return r;
 unpackg (opnd[0], opnd[1], &a);
 unpackg (opnd[2], opnd[3], &b);
 if (sub)                                                /* sub? -s1 */
@@ -1435,7 +1657,10 @@ return rpackg (&a, rh);                                 /* round and pack */
 int32 op_mulf (int32 *opnd)
 {
 UFP a, b;
+int32 r;
     
+if (HFP_F (HFP_MUL, opnd[0], opnd[1], &r))              /* host FP? */
+    return r;
 unpackf (opnd[0], &a);                                  /* F format */
 unpackf (opnd[1], &b);
 vax_fmul (&a, &b, 0, FD_BIAS, 0, 0);                    /* do multiply */
@@ -1455,7 +1680,10 @@ return rpackfd (&a, rh);                                /* round and pack */
 int32 op_mulg (int32 *opnd, int32 *rh)
 {
 UFP a, b;
+int32 r;
 
+if (HFP_G (HFP_MUL, opnd, rh, &r))                      /* host FP? */
+    return r;
 unpackg (opnd[0], opnd[1], &a);                         /* G format */
 unpackg (opnd[2], opnd[3], &b);
 vax_fmul (&a, &b, 1, G_BIAS, 0, 0);                     /* do multiply */
@@ -1467,7 +1695,10 @@ return rpackg (&a, rh);                                 /* round and pack */
 int32 op_divf (int32 *opnd)
 {
 UFP a, b;
+int32 r;
 
+if (HFP_F (HFP_DIV, opnd[0], opnd[1], &r))              /* host FP? */
+    return r;
 unpackf (opnd[0], &a);                                  /* F format */
 unpackf (opnd[1], &b);
 vax_fdiv (&a, &b, 26, FD_BIAS);                         /* do divide */
@@ -1487,7 +1718,10 @@ return rpackfd (&b, rh);                                /* round and pack */
 int32 op_divg (int32 *opnd, int32 *rh)
 {
 UFP a, b;
+int32 r;
 
+if (HFP_G (HFP_DIV, opnd, rh, &r))                      /* host FP? */
+    return r;
 unpackg (opnd[0], opnd[1], &a);                         /* G format */
 unpackg (opnd[2], opnd[3], &b);
 vax_fdiv (&a, &b, 55, G_BIAS);                          /* do divide */
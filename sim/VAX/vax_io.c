@@ -106,6 +106,7 @@
 #define CQMAP_PAG       0x000FFFFF                      /* mem page */
 
 int32 int_req[IPL_HLVL] = { 0 };                        /* intr, IPL 14-17 */
+uint32 int_sum = 0;                                     /* levels w/ req */
 int32 cq_scr = 0;                                       /* SCR */
 int32 cq_dser = 0;                                      /* DSER */
 int32 cq_mear = 0;                                      /* MEAR */
@@ -133,6 +134,7 @@ t_stat qba_ex (t_value *vptr, t_addr exta, UNIT *uptr, int32 sw);
 t_stat qba_dep (t_value val, t_addr exta, UNIT *uptr, int32 sw);
 t_bool qba_map_addr (uint32 qa, uint32 *ma);
 t_bool qba_map_addr_c (uint32 qa, uint32 *ma);
+int32 qba_map_run (uint32 qa, int32 bc, uint32 *ma);
 t_stat set_autocon (UNIT *uptr, int32 val, char *cptr, void *desc);
 t_stat show_autocon (FILE *st, UNIT *uptr, int32 val, void *desc);
 t_stat show_iospace (FILE *st, UNIT *uptr, int32 val, void *desc);
@@ -374,7 +376,25 @@ SET_IRQL;
 return;
 }
 
-/* Find highest priority outstanding interrupt */
+/* Find highest priority outstanding interrupt
+
+   Pending hardware levels are found from the summary int_sum, and
+   software levels from SISR, by locating the highest set bit, rather
+   than by scanning every level.  A summary bit whose level has been
+   emptied since (by CLR_INT or get_vector) is cleared here.
+*/
+
+static int32 int_hibit (uint32 m)
+{
+#if defined (__GNUC__)
+return 31 - __builtin_clz (m);
+#else
+int32 i;
+
+for (i = 31; (m & (1u << i)) == 0; i--) ;
+return i;
+#endif
+}
 
 int32 eval_int (void)
 {
@@ -394,21 +414,17 @@ if ((ipl < IPL_MEMERR) && mem_err)                      /* mem err int */
     return IPL_MEMERR;
 if ((ipl < IPL_CRDERR) && crd_err)                      /* crd err int */
     return IPL_CRDERR;
-for (i = IPL_HMAX; i >= IPL_HMIN; i--) {                /* chk hwre int */
-    if (i <= ipl)                                       /* at ipl? no int */
-        return 0;
-    if (int_req[i - IPL_HMIN])                          /* req != 0? int */
-        return i;
+while (int_sum) {                                       /* chk hwre int */
+    i = int_hibit (int_sum);                            /* highest level */
+    if (int_req[i])                                     /* req != 0? */
+        return ((i + IPL_HMIN) > ipl)? i + IPL_HMIN: 0; /* int if > ipl */
+    int_sum = int_sum & ~(1u << i);                     /* empty, clear */
     }
 if (ipl >= IPL_SMAX)                                    /* ipl >= sw max? */
     return 0;
 if ((t = SISR & sw_int_mask[ipl]) == 0)                 /* eligible req */
     return 0;
-for (i = IPL_SMAX; i > ipl; i--) {                      /* check swre int */
-    if ((t >> i) & 1)                                   /* req != 0? int */
-        return i;
-    }
-return 0;
+return int_hibit (t);                                   /* highest swre int */
 }
 
 /* Return vector for highest priority hardware interrupt at IPL lvl */
@@ -664,6 +680,28 @@ cq_serr (0);                                            /* inv mem */
 return FALSE;
 }
 
+/* Map a run of addresses via the translation map - for bulk transfers
+
+   Maps qa, and returns the number of bytes from qa, up to bc, that map
+   to contiguous memory; or 0 if qa cannot be mapped (with the error
+   recorded as in qba_map_addr)
+*/
+
+int32 qba_map_run (uint32 qa, int32 bc, uint32 *ma)
+{
+int32 run;
+uint32 nma;
+
+if (!qba_map_addr (qa, ma))                             /* map first page */
+    return 0;
+run = VA_PAGSIZE - VA_GETOFF (qa);                      /* rest of page */
+while ((run < bc) &&                                    /* next page contig? */
+    qba_map_addr_c (qa + run, &nma) &&
+    (nma == (*ma + run)) && ADDR_IS_MEM (nma))
+    run = run + VA_PAGSIZE;
+return ((run < bc)? run: bc);
+}
+
 /* Map an address via the translation map - console version (no status changes) */
 
 t_bool qba_map_addr_c (uint32 qa, uint32 *ma)
@@ -732,6 +770,7 @@ cq_scr = (cq_scr & CQSCR_BHL) | CQSCR_POK;
 cq_dser = cq_mear = cq_sear = cq_ipc = 0;
 for (i = 0; i < IPL_HLVL; i++)
     int_req[i] = 0;
+int_sum = 0;
 return SCPE_OK;
 }
 
@@ -741,14 +780,26 @@ return SCPE_OK;
    Map_ReadW    -       fetch word buffer from memory
    Map_WriteB   -       store byte buffer into memory
    Map_WriteW   -       store word buffer into memory
+
+   On little endian hosts, the byte order of M matches the Qbus, so
+   transfers are done with memcpy, a run of contiguously mapped pages
+   at a time.  Otherwise, memory is accessed by longwords when the
+   transfer is aligned, and by bytes or words when it is not.
 */
 
 int32 Map_ReadB (uint32 ba, int32 bc, uint8 *buf)
 {
-int32 i;
+int32 i, pbc;
 uint32 ma, dat;
 
-if ((ba | bc) & 03) {                                   /* check alignment */
+if (sim_end) {                                          /* little endian? */
+    for (i = 0; i < bc; i = i + pbc) {                  /* by runs */
+        if ((pbc = qba_map_run (ba + i, bc - i, &ma)) == 0)
+            return (bc - i);                            /* inv or NXM */
+        memcpy (buf + i, ((uint8 *) M) + ma, pbc);
+        }
+    }
+else if ((ba | bc) & 03) {                              /* check alignment */
     for (i = ma = 0; i < bc; i++, buf++) {              /* by bytes */
         if ((ma & VA_M_OFF) == 0) {                     /* need map? */
             if (!qba_map_addr (ba + i, &ma))            /* inv or NXM? */
@@ -777,12 +828,19 @@ return 0;
 
 int32 Map_ReadW (uint32 ba, int32 bc, uint16 *buf)
 {
-int32 i;
+int32 i, pbc;
 uint32 ma,dat;
 
 ba = ba & ~01;
 bc = bc & ~01;
-if ((ba | bc) & 03) {                                   /* check alignment */
+if (sim_end) {                                          /* little endian? */
+    for (i = 0; i < bc; i = i + pbc) {                  /* by runs */
+        if ((pbc = qba_map_run (ba + i, bc - i, &ma)) == 0)
+            return (bc - i);                            /* inv or NXM */
+        memcpy (((uint8 *) buf) + i, ((uint8 *) M) + ma, pbc);
+        }
+    }
+else if ((ba | bc) & 03) {                              /* check alignment */
     for (i = ma = 0; i < bc; i = i + 2, buf++) {        /* by words */
         if ((ma & VA_M_OFF) == 0) {                     /* need map? */
             if (!qba_map_addr (ba + i, &ma))            /* inv or NXM? */
@@ -809,10 +867,17 @@ return 0;
 
 int32 Map_WriteB (uint32 ba, int32 bc, uint8 *buf)
 {
-int32 i;
+int32 i, pbc;
 uint32 ma, dat;
 
-if ((ba | bc) & 03) {                                   /* check alignment */
+if (sim_end) {                                          /* little endian? */
+    for (i = 0; i < bc; i = i + pbc) {                  /* by runs */
+        if ((pbc = qba_map_run (ba + i, bc - i, &ma)) == 0)
+            return (bc - i);                            /* inv or NXM */
+        memcpy (((uint8 *) M) + ma, buf + i, pbc);
+        }
+    }
+else if ((ba | bc) & 03) {                              /* check alignment */
     for (i = ma = 0; i < bc; i++, buf++) {              /* by bytes */
         if ((ma & VA_M_OFF) == 0) {                     /* need map? */
             if (!qba_map_addr (ba + i, &ma))            /* inv or NXM? */
@@ -841,12 +906,19 @@ return 0;
 
 int32 Map_WriteW (uint32 ba, int32 bc, uint16 *buf)
 {
-int32 i;
+int32 i, pbc;
 uint32 ma, dat;
 
 ba = ba & ~01;
 bc = bc & ~01;
-if ((ba | bc) & 03) {                                   /* check alignment */
+if (sim_end) {                                          /* little endian? */
+    for (i = 0; i < bc; i = i + pbc) {                  /* by runs */
+        if ((pbc = qba_map_run (ba + i, bc - i, &ma)) == 0)
+            return (bc - i);                            /* inv or NXM */
+        memcpy (((uint8 *) M) + ma, ((uint8 *) buf) + i, pbc);
+        }
+    }
+else if ((ba | bc) & 03) {                              /* check alignment */
     for (i = ma = 0; i < bc; i = i + 2, buf++) {        /* by words */
         if ((ma & VA_M_OFF) == 0) {                     /* need map? */
             if (!qba_map_addr (ba + i, &ma))            /* inv or NXM? */
@@ -918,6 +990,10 @@ for (i = 0; (dptr = sim_devices[i]) != NULL; i++) {     /* loop thru dev */
             return r;
         }                                               /* end if enabled */
     }                                                   /* end for */
+for (i = 0, int_sum = 0; i < IPL_HLVL; i++) {           /* rebuild summary, */
+    if (int_req[i])                                     /* int_req may have */
+        int_sum = int_sum | (1u << i);                  /* been deposited */
+    }
 return SCPE_OK;
 }
 
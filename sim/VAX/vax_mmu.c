@@ -41,21 +41,27 @@
         ReadB(W)        -       read aligned physical byte (word)
         WriteB(W)       -       write aligned physical byte (word)
         Test            -       test acccess
+        MapStr          -       map virtual for string instructions
 
         zap_tb          -       clear TB
         zap_tb_ent      -       clear TB entry
         chk_tb_ent      -       check TB entry
         set_map_reg     -       set up working map registers
+
+   The translation buffers are set associative, with the number of
+   entries and ways settable at run time (SET TLB SIZE=n, WAYS=n).
+   Within a set, the most recently used entry is kept in way 0; the
+   CPU's inline operand fast path looks only there.
+
+   Tags include a generation number (one for the system TB, one for
+   the process TB).  Clearing a TB just advances its generation, which
+   makes every existing entry mismatch; the entries themselves are
+   only cleared when the generation wraps around.
 */
 
 #include "vax_defs.h"
 #include <setjmp.h>
 
-typedef struct {
-    int32       tag;                                    /* tag */
-    int32       pte;                                    /* pte */
-    } TLBENT;
-
 extern uint32 *M;
 extern int32 PSL;
 extern int32 mapen;
@@ -71,7 +77,20 @@ int32 d_p0br, d_p0lr;                                   /* dynamic copies */
 int32 d_p1br, d_p1lr;                                   /* altered per ucode */
 int32 d_sbr, d_slr;
 extern int32 mchk_va, mchk_ref;                         /* for mcheck */
-TLBENT stlb[VA_TBSIZE], ptlb[VA_TBSIZE];
+TLBENT stlb[VA_TBMAX], ptlb[VA_TBMAX];
+uint32 tlb_size = VA_TBSIZE;                            /* # entries */
+uint32 tlb_ways = 1;                                    /* # ways */
+uint32 tlb_wshift = 0;                                  /* log2 (ways) */
+uint32 tlb_smask = VA_TBSIZE - 1;                       /* set index mask */
+uint32 tlb_sgen = 0;                                    /* sys TB generation */
+uint32 tlb_pgen = 0;                                    /* proc TB generation */
+t_uint64 tlb_hit = 0;                                   /* statistics */
+t_uint64 tlb_miss = 0;
+t_uint64 tlb_flush = 0;
+static TLBENT tlb_inv = { -1, 0, NULL };                /* miss entry */
+
+#define TLB_HP(x)       (ADDR_IS_MEM ((x) & TLB_PFN)? \
+                        M + (((uint32) ((x) & TLB_PFN)) >> 2): NULL)
 static const int32 insert[4] = {
     0x00000000, 0x000000FF, 0x0000FFFF, 0x00FFFFFF
     };
@@ -101,8 +120,16 @@ static const int32 cvtacc[16] = { 0, 0,
 t_stat tlb_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
 t_stat tlb_dep (t_value val, t_addr addr, UNIT *uptr, int32 sw);
 t_stat tlb_reset (DEVICE *dptr);
+t_stat tlb_set_size (UNIT *uptr, int32 val, char *cptr, void *desc);
+t_stat tlb_show_size (FILE *st, UNIT *uptr, int32 val, void *desc);
+t_stat tlb_set_ways (UNIT *uptr, int32 val, char *cptr, void *desc);
+t_stat tlb_show_ways (FILE *st, UNIT *uptr, int32 val, void *desc);
+t_stat tlb_show_stats (FILE *st, UNIT *uptr, int32 val, void *desc);
 
 TLBENT fill (uint32 va, int32 lnt, int32 acc, int32 *stat);
+static SIM_INLINE TLBENT *tlb_find (uint32 va, int32 vpn);
+static TLBENT *tlb_insert (TLBENT *tlbp, int32 tag, int32 pte);
+static void tlb_clr (TLBENT *tlbp);
 extern int32 ReadIO (uint32 pa, int32 lnt);
 extern void WriteIO (uint32 pa, int32 val, int32 lnt);
 extern int32 ReadReg (uint32 pa, int32 lnt);
@@ -115,6 +142,7 @@ void WriteU (uint32 pa, int32 val, int32 lnt);
    tlb_dev      pager device descriptor
    tlb_unit     pager units
    pager_reg    pager register list
+   tlb_mod      pager modifier list
 */
 
 UNIT tlb_unit[] = {
@@ -126,8 +154,18 @@ REG tlb_reg[] = {
     { NULL }
     };
 
+MTAB tlb_mod[] = {
+    { MTAB_XTD|MTAB_VDV, 0, "SIZE", "SIZE",
+      &tlb_set_size, &tlb_show_size },
+    { MTAB_XTD|MTAB_VDV, 0, "WAYS", "WAYS",
+      &tlb_set_ways, &tlb_show_ways },
+    { MTAB_XTD|MTAB_VDV, 0, "STATISTICS", NULL,
+      NULL, &tlb_show_stats },
+    { 0 }
+    };
+
 DEVICE tlb_dev = {
-    "TLB", tlb_unit, tlb_reg, NULL,
+    "TLB", tlb_unit, tlb_reg, tlb_mod,
     2, 16, VA_N_TBI * 2, 1, 16, 32,
     &tlb_ex, &tlb_dep, &tlb_reset,
     NULL, NULL, NULL
@@ -164,7 +202,7 @@ DEVICE tlb_dev = {
 
 int32 Read (uint32 va, int32 lnt, int32 acc)
 {
-int32 vpn, off, tbi, pa;
+int32 vpn, off, pa;
 int32 pa1, bo, sc, wl, wh;
 TLBENT xpte;
 
@@ -172,11 +210,11 @@ mchk_va = va;
 if (mapen) {                                            /* mapping on? */
     vpn = VA_GETVPN (va);                               /* get vpn, offset */
     off = VA_GETOFF (va);
-    tbi = VA_GETTBI (vpn);
-    xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
-    if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
+    xpte = *tlb_find (va, vpn);                         /* access tlb */
+    if (((xpte.pte & acc) == 0) ||
         ((acc & TLB_WACC) && ((xpte.pte & TLB_M) == 0)))
         xpte = fill (va, lnt, acc, NULL);               /* fill if needed */
+    else tlb_hit++;
     pa = (xpte.pte & TLB_PFN) | off;                    /* get phys addr */
     }
 else pa = va & PAMASK;
@@ -189,11 +227,11 @@ if ((pa & (lnt - 1)) == 0) {                            /* aligned? */
     }
 if (mapen && ((off + lnt) > VA_PAGSIZE)) {              /* cross page? */
     vpn = VA_GETVPN (va + lnt);                         /* vpn 2nd page */
-    tbi = VA_GETTBI (vpn);
-    xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
-    if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
+    xpte = *tlb_find (va, vpn);                         /* access tlb */
+    if (((xpte.pte & acc) == 0) ||
         ((acc & TLB_WACC) && ((xpte.pte & TLB_M) == 0)))
         xpte = fill (va + lnt, lnt, acc, NULL);         /* fill if needed */
+    else tlb_hit++;
     pa1 = ((xpte.pte & TLB_PFN) | VA_GETOFF (va + 4)) & ~03;
     }
 else pa1 = ((pa + 4) & PAMASK) & ~03;                   /* not cross page */
@@ -226,7 +264,7 @@ else {
 
 void Write (uint32 va, int32 val, int32 lnt, int32 acc)
 {
-int32 vpn, off, tbi, pa;
+int32 vpn, off, pa;
 int32 pa1, bo, sc;
 TLBENT xpte;
 
@@ -234,11 +272,10 @@ mchk_va = va;
 if (mapen) {
     vpn = VA_GETVPN (va);
     off = VA_GETOFF (va);
-    tbi = VA_GETTBI (vpn);
-    xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
-    if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
-        ((xpte.pte & TLB_M) == 0))
+    xpte = *tlb_find (va, vpn);                         /* access tlb */
+    if (((xpte.pte & acc) == 0) || ((xpte.pte & TLB_M) == 0))
         xpte = fill (va, lnt, acc, NULL);
+    else tlb_hit++;
     pa = (xpte.pte & TLB_PFN) | off;
     }
 else pa = va & PAMASK;
@@ -252,11 +289,10 @@ if ((pa & (lnt - 1)) == 0) {                            /* aligned? */
     }
 if (mapen && ((off + lnt) > VA_PAGSIZE)) {
     vpn = VA_GETVPN (va + 4);
-    tbi = VA_GETTBI (vpn);
-    xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
-    if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
-        ((xpte.pte & TLB_M) == 0))
+    xpte = *tlb_find (va, vpn);                         /* access tlb */
+    if (((xpte.pte & acc) == 0) || ((xpte.pte & TLB_M) == 0))
         xpte = fill (va + lnt, lnt, acc, NULL);
+    else tlb_hit++;
     pa1 = ((xpte.pte & TLB_PFN) | VA_GETOFF (va + 4)) & ~03;
     }
 else pa1 = ((pa + 4) & PAMASK) & ~03;
@@ -279,17 +315,18 @@ return;
 
 int32 Test (uint32 va, int32 acc, int32 *status)
 {
-int32 vpn, off, tbi;
+int32 vpn, off;
 TLBENT xpte;
 
 *status = PR_OK;                                        /* assume ok */
 if (mapen) {                                            /* mapping on? */
     vpn = VA_GETVPN (va);                               /* get vpn, off */
     off = VA_GETOFF (va);
-    tbi = VA_GETTBI (vpn);
-    xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
-    if ((xpte.pte & acc) && (xpte.tag == vpn))          /* TB hit, acc ok? */ 
+    xpte = *tlb_find (va, vpn);                         /* access tlb */
+    if (xpte.pte & acc) {                               /* TB hit, acc ok? */ 
+        tlb_hit++;
         return (xpte.pte & TLB_PFN) | off;
+        }
     xpte = fill (va, L_BYTE, acc, status);              /* fill TB */
     if (*status == PR_OK)
         return (xpte.pte & TLB_PFN) | off;
@@ -298,6 +335,44 @@ if (mapen) {                                            /* mapping on? */
 return va & PAMASK;                                     /* ret phys addr */
 }
 
+/* Map virtual for string instructions
+
+   Inputs:
+        va      =       virtual address
+        acc     =       access code (KESU, read or write)
+        lnt     =       pointer to length
+   Output:
+        host pointer to the byte at va in M, with *lnt set to the
+        number of bytes from va to the end of its page; or NULL if
+        va is not in memory, or if M is not byte addressable because
+        the host is big endian.  Access errors fault as in Read and
+        Write.
+*/
+
+uint8 *MapStr (uint32 va, int32 acc, int32 *lnt)
+{
+int32 vpn, pa;
+TLBENT xpte;
+
+if (!sim_end)                                           /* big endian? */
+    return NULL;
+mchk_va = va;
+if (mapen) {                                            /* mapping on? */
+    vpn = VA_GETVPN (va);
+    xpte = *tlb_find (va, vpn);                         /* access tlb */
+    if (((xpte.pte & acc) == 0) ||
+        ((acc & TLB_WACC) && ((xpte.pte & TLB_M) == 0)))
+        xpte = fill (va, L_BYTE, acc, NULL);            /* fill if needed */
+    else tlb_hit++;
+    pa = (xpte.pte & TLB_PFN) | VA_GETOFF (va);         /* get phys addr */
+    }
+else pa = va & PAMASK;
+if (!ADDR_IS_MEM (pa))                                  /* not memory? */
+    return NULL;
+*lnt = VA_PAGSIZE - VA_GETOFF (va);                     /* bytes left in page */
+return ((uint8 *) M) + pa;
+}
+
 /* Read aligned physical (in virtual context, unless indicated)
 
    Inputs:
@@ -500,8 +575,11 @@ return;
 TLBENT fill (uint32 va, int32 lnt, int32 acc, int32 *stat)
 {
 int32 ptidx = (((uint32) va) >> 7) & ~03;
-int32 tlbpte, ptead, pte, tbi, vpn;
-static TLBENT zero_pte = { 0, 0 };
+int32 tlbpte, ptead, pte, vpn;
+TLBENT *tlbp;
+static TLBENT zero_pte = { 0, 0, NULL };
+
+tlb_miss++;
 
 if (va & VA_S0) {                                       /* system space? */
     if (ptidx >= d_slr)                                 /* system */
@@ -521,9 +599,9 @@ else {
         }
     if ((ptead & VA_S0) == 0)
         ABORT (STOP_PPTE);                              /* ppte must be sys */
-    vpn = VA_GETVPN (ptead);                            /* get vpn, tbi */
-    tbi = VA_GETTBI (vpn);
-    if (stlb[tbi].tag != vpn) {                         /* in sys tlb? */
+    vpn = VA_GETVPN (ptead);                            /* get vpn */
+    tlbp = tlb_find (ptead, vpn);
+    if (tlbp == &tlb_inv) {                             /* in sys tlb? */
         ptidx = ((uint32) ptead) >> 7;                  /* xlate like sys */
         if (ptidx >= d_slr)
             MM_ERR (PR_PLNV);
@@ -534,11 +612,11 @@ else {
 #endif
         if ((pte & PTE_V) == 0)                         /* spte TNV? */
             MM_ERR (PR_PTNV);
-        stlb[tbi].tag = vpn;                            /* set stlb tag */
-        stlb[tbi].pte = cvtacc[PTE_GETACC (pte)] |
-            ((pte << VA_N_OFF) & TLB_PFN);              /* set stlb data */
+        tlbp = tlb_insert (stlb + TLB_SET (vpn), vpn | tlb_sgen,
+            cvtacc[PTE_GETACC (pte)] |
+            ((pte << VA_N_OFF) & TLB_PFN));             /* set stlb ent */
         }
-    ptead = (stlb[tbi].pte & TLB_PFN) | VA_GETOFF (ptead);
+    ptead = (tlbp->pte & TLB_PFN) | VA_GETOFF (ptead);
     }
 pte = ReadL (ptead);                                    /* read pte */
 tlbpte = cvtacc[PTE_GETACC (pte)] |                     /* cvt access */
@@ -553,15 +631,63 @@ if (acc & TLB_WACC) {                                   /* write? */
     tlbpte = tlbpte | TLB_M;                            /* set M */
     }
 vpn = VA_GETVPN (va);
-tbi = VA_GETTBI (vpn);
-if ((va & VA_S0) == 0) {                                /* process space? */
-    ptlb[tbi].tag = vpn;                                /* store tlb ent */
-    ptlb[tbi].pte = tlbpte;
-    return ptlb[tbi];
-    }
-stlb[tbi].tag = vpn;                                    /* system space */
-stlb[tbi].pte = tlbpte;                                 /* store tlb ent */
-return stlb[tbi];
+if ((va & VA_S0) == 0)                                  /* process space? */
+    tlbp = tlb_insert (ptlb + TLB_SET (vpn), vpn | tlb_pgen, tlbpte);
+else tlbp = tlb_insert (stlb + TLB_SET (vpn), vpn | tlb_sgen, tlbpte);
+return *tlbp;
+}
+
+/* TLB lookup
+
+   Returns the entry for vpn (in the TB selected by va), after moving
+   it to way 0 of its set, or an invalid entry if it is not present.
+*/
+
+static SIM_INLINE TLBENT *tlb_find (uint32 va, int32 vpn)
+{
+TLBENT *tlbp, t;
+int32 tag;
+uint32 i;
+
+if (va & VA_S0) {
+    tlbp = stlb + TLB_SET (vpn);
+    tag = vpn | tlb_sgen;
+    }
+else {
+    tlbp = ptlb + TLB_SET (vpn);
+    tag = vpn | tlb_pgen;
+    }
+if (tlbp->tag == tag)                                   /* MRU way? */
+    return tlbp;
+for (i = 1; i < tlb_ways; i++) {                        /* search others */
+    if (tlbp[i].tag == tag) {
+        t = tlbp[i];                                    /* swap with MRU */
+        tlbp[i] = tlbp[0];
+        tlbp[0] = t;
+        return tlbp;
+        }
+    }
+return &tlb_inv;
+}
+
+/* TLB insert
+
+   Inserts an entry as way 0 of the set starting at tlbp, shifting the
+   other ways down.  An existing entry with the same tag is replaced;
+   otherwise the least recently used way is discarded.
+*/
+
+static TLBENT *tlb_insert (TLBENT *tlbp, int32 tag, int32 pte)
+{
+uint32 i;
+
+for (i = 0; (i < (tlb_ways - 1)) && (tlbp[i].tag != tag); i++) ;
+for ( ; i > 0; i--)
+    tlbp[i] = tlbp[i - 1];
+tlbp->tag = tag;
+tlbp->pte = pte;
+tlbp->hp = TLB_HP (pte);                                /* set host ptr */
+return tlbp;
 }
 
 /* Utility routines */
@@ -577,16 +703,22 @@ d_slr = (SLR << 2) + 0x1000000;                         /* VA<31> >> 7 */
 return;
 }
 
-/* Zap process (0) or whole (1) tb */
+/* Zap process (0) or whole (1) tb - advance the generation(s) */
 
 void zap_tb (int stb)
 {
-size_t i;
-
-for (i = 0; i < VA_TBSIZE; i++) {
-    ptlb[i].tag = ptlb[i].pte = -1;
-    if (stb)
-        stlb[i].tag = stlb[i].pte = -1;
+tlb_flush++;
+tlb_pgen = tlb_pgen + TLB_GEN_INC;
+if (tlb_pgen > TLB_GEN_MAX) {                           /* wrapped? */
+    tlb_clr (ptlb);                                     /* really clear */
+    tlb_pgen = 0;
+    }
+if (stb) {
+    tlb_sgen = tlb_sgen + TLB_GEN_INC;
+    if (tlb_sgen > TLB_GEN_MAX) {
+        tlb_clr (stlb);
+        tlb_sgen = 0;
+        }
     }
 return;
 }
@@ -595,11 +727,12 @@ return;
 
 void zap_tb_ent (uint32 va)
 {
-int32 tbi = VA_GETTBI (VA_GETVPN (va));
+TLBENT *tlbp = tlb_find (va, VA_GETVPN (va));
 
-if (va & VA_S0)
-    stlb[tbi].tag = stlb[tbi].pte = -1;
-else ptlb[tbi].tag = ptlb[tbi].pte = -1;
+if (tlbp != &tlb_inv) {
+    tlbp->tag = tlbp->pte = -1;
+    tlbp->hp = NULL;
+    }
 return;
 }
 
@@ -607,28 +740,40 @@ return;
 
 t_bool chk_tb_ent (uint32 va)
 {
-int32 vpn = VA_GETVPN (va);
-int32 tbi = VA_GETTBI (vpn);
-TLBENT xpte;
-
-xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];
-if (xpte.tag == vpn)
+if (tlb_find (va, VA_GETVPN (va)) != &tlb_inv)
     return TRUE;
 return FALSE;
 }
 
+/* Clear all entries of a tb */
+
+static void tlb_clr (TLBENT *tlbp)
+{
+uint32 i;
+
+for (i = 0; i < tlb_size; i++) {
+    tlbp[i].tag = tlbp[i].pte = -1;
+    tlbp[i].hp = NULL;
+    }
+return;
+}
+
 /* TLB examine */
 
 t_stat tlb_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw)
 {
 int32 tlbn = uptr - tlb_unit;
 uint32 idx = (uint32) addr >> 1;
+uint32 gen = tlbn? tlb_sgen: tlb_pgen;
+TLBENT *tlbp = tlbn? stlb: ptlb;
 
-if (idx >= VA_TBSIZE)
+if (idx >= tlb_size)
     return SCPE_NXM;
 if (addr & 1)
-    *vptr = ((uint32) (tlbn? stlb[idx].pte: ptlb[idx].pte));
-else *vptr = ((uint32) (tlbn? stlb[idx].tag: ptlb[idx].tag));
+    *vptr = ((uint32) tlbp[idx].pte);
+else if ((tlbp[idx].tag & ~VA_M_VPN) == gen)            /* current? */
+    *vptr = ((uint32) tlbp[idx].tag & VA_M_VPN);
+else *vptr = 0xFFFFFFFF;                                /* no, invalid */
 return SCPE_OK;
 }
 
@@ -638,17 +783,18 @@ t_stat tlb_dep (t_value val, t_addr addr, UNIT *uptr, int32 sw)
 {
 int32 tlbn = uptr - tlb_unit;
 uint32 idx = (uint32) addr >> 1;
+uint32 gen = tlbn? tlb_sgen: tlb_pgen;
+TLBENT *tlbp = tlbn? stlb: ptlb;
 
-if (idx >= VA_TBSIZE)
+if (idx >= tlb_size)
     return SCPE_NXM;
 if (addr & 1) {
-    if (tlbn) stlb[idx].pte = (int32) val;
-    else ptlb[idx].pte = (int32) val;
-    }
-else {
-    if (tlbn) stlb[idx].tag = (int32) val;
-    else ptlb[idx].tag = (int32) val;
+    tlbp[idx].pte = (int32) val;
+    tlbp[idx].hp = TLB_HP (tlbp[idx].pte);
     }
+else if (val > VA_M_VPN)                                /* not a vpn? */
+    tlbp[idx].tag = -1;                                 /* invalidate */
+else tlbp[idx].tag = ((int32) val) | gen;               /* current gen */
 return SCPE_OK;
 }
 
@@ -656,9 +802,75 @@ return SCPE_OK;
 
 t_stat tlb_reset (DEVICE *dptr)
 {
-size_t i;
+tlb_clr (stlb);
+tlb_clr (ptlb);
+tlb_sgen = tlb_pgen = 0;
+tlb_hit = tlb_miss = tlb_flush = 0;
+return SCPE_OK;
+}
+
+/* Set TLB geometry - size is total entries per TB, both powers of 2 */
 
-for (i = 0; i < VA_TBSIZE; i++)
-    stlb[i].tag = ptlb[i].tag = stlb[i].pte = ptlb[i].pte = -1;
+static t_stat tlb_set_geom (uint32 size, uint32 ways)
+{
+uint32 i;
+
+if ((size < VA_TBMIN) || (size > VA_TBMAX) || (size & (size - 1)) ||
+    (ways < 1) || (ways > VA_TBWMAX) || (ways & (ways - 1)) ||
+    (ways > size))
+    return SCPE_ARG;
+tlb_size = size;
+tlb_ways = ways;
+for (i = 0; (1u << i) < ways; i++) ;
+tlb_wshift = i;
+tlb_smask = (size >> i) - 1;
+tlb_unit[0].capac = tlb_unit[1].capac = size * 2;
+return tlb_reset (&tlb_dev);
+}
+
+t_stat tlb_set_size (UNIT *uptr, int32 val, char *cptr, void *desc)
+{
+uint32 size;
+t_stat r;
+
+if (cptr == NULL)
+    return SCPE_ARG;
+size = (uint32) get_uint (cptr, 10, VA_TBMAX, &r);
+if (r != SCPE_OK)
+    return SCPE_ARG;
+return tlb_set_geom (size, tlb_ways);
+}
+
+t_stat tlb_set_ways (UNIT *uptr, int32 val, char *cptr, void *desc)
+{
+uint32 ways;
+t_stat r;
+
+if (cptr == NULL)
+    return SCPE_ARG;
+ways = (uint32) get_uint (cptr, 10, VA_TBWMAX, &r);
+if (r != SCPE_OK)
+    return SCPE_ARG;
+return tlb_set_geom (tlb_size, ways);
+}
+
+/* Show TLB geometry, statistics */
+
+t_stat tlb_show_size (FILE *st, UNIT *uptr, int32 val, void *desc)
+{
+fprintf (st, "size=%d", tlb_size);
+return SCPE_OK;
+}
+
+t_stat tlb_show_ways (FILE *st, UNIT *uptr, int32 val, void *desc)
+{
+fprintf (st, "ways=%d", tlb_ways);
+return SCPE_OK;
+}
+
+t_stat tlb_show_stats (FILE *st, UNIT *uptr, int32 val, void *desc)
+{
+fprintf (st, "hits=%" LL_FMT "u, misses=%" LL_FMT "u, flushes=%" LL_FMT "u",
+    tlb_hit, tlb_miss, tlb_flush);
 return SCPE_OK;
 }
@@ -59,20 +59,48 @@ extern int32 Test (uint32 va, int32 acc, int32 *status);
 
 #define WORDSWAP(x)     ((((x) & WMASK) << 16) | (((x) >> 16) & WMASK))
 
+/* 128b unsigned integers
+
+   Fractions are held in a 128b unsigned integer, UQP.  If the compiler
+   provides unsigned __int128 (and DONT_USE_INT128 is not defined), UQP
+   is that type and most operations are single expressions; otherwise
+   UQP is a pair of 64b halves and the operations are done piecewise.
+   Either way, the rest of the module uses only the macros and qp_xxx
+   routines below.  Longword n of a UQP is bits <32n+31:32n>.
+*/
+
+#if defined (__SIZEOF_INT128__) && !defined (DONT_USE_INT128)
+
+typedef unsigned __int128 UQP;
+
+#define QP_ISZERO(x)    ((x) == 0)
+#define QP_GETL(x,n)    ((uint32) ((x) >> (32 * (n))))
+#define QP_CLRL0(x,m)   (x) = (x) & ~((UQP) ((uint32) (m)))
+#define QP_SETL0(x,m)   (x) = (x) | ((UQP) ((uint32) (m)))
+#define QP_SETNM(x)     (x) = (x) | (((UQP) 1) << UH_V_NM)
+
+#else
+
 typedef struct {
-    uint32              f0;                             /* low */
-    uint32              f1;
-    uint32              f2;
-    uint32              f3;                             /* high */
+    t_uint64            lo;                             /* low */
+    t_uint64            hi;                             /* high */
     } UQP;
 
+#define QP_ISZERO(x)    (((x).lo == 0) && ((x).hi == 0))
+#define QP_GETL(x,n)    ((uint32) ((((n) & 2)? (x).hi: (x).lo) >> (32 * ((n) & 1))))
+#define QP_CLRL0(x,m)   (x).lo = (x).lo & ~((t_uint64) ((uint32) (m)))
+#define QP_SETL0(x,m)   (x).lo = (x).lo | ((t_uint64) ((uint32) (m)))
+#define QP_SETNM(x)     (x).hi = (x).hi | (((t_uint64) 1) << (UH_V_NM - 64))
+
+#endif
+
 typedef struct {
     int32               sign;
     int32               exp;
     UQP                 frac;
     } UFPH;
 
-#define UH_NM_H         0x80000000                      /* normalized */
+#define UH_NM_H         0x80000000                      /* normalized, hi lw */
 #define UH_FRND         0x00000080                      /* F round */
 #define UH_DRND         0x00000080                      /* D round */
 #define UH_GRND         0x00000400                      /* G round */
@@ -101,14 +129,17 @@ void vax_hadd (UFPH *a, UFPH *b, uint32 mlo);
 void vax_hmul (UFPH *a, UFPH *b, uint32 mlo);
 void vax_hmod (UFPH *a, int32 *intgr, int32 *flg);
 void vax_hdiv (UFPH *a, UFPH *b);
-uint32 qp_add (UQP *a, UQP *b);
-uint32 qp_sub (UQP *a, UQP *b);
-void qp_inc (UQP *a);
-void qp_lsh (UQP *a, uint32 sc);
-void qp_rsh (UQP *a, uint32 sc);
-void qp_rsh_s (UQP *a, uint32 sc, uint32 neg);
-void qp_neg (UQP *a);
-int32 qp_cmp (UQP *a, UQP *b);
+static void qp_load (UQP *r, uint32 l3, uint32 l2, uint32 l1, uint32 l0);
+static uint32 qp_add (UQP *a, UQP *b);
+static void qp_inc (UQP *a);
+static void qp_lsh (UQP *a, uint32 sc);
+static void qp_rsh (UQP *a, uint32 sc);
+static void qp_rsh_s (UQP *a, uint32 sc, uint32 neg);
+static void qp_neg (UQP *a);
+static int32 qp_cmp (UQP *a, UQP *b);
+static int32 qp_nlz (UQP *a);
+static void qp_mulhi (UQP *a, UQP *b, UQP *r);
+static void qp_div (UQP *n, UQP *d, UQP *quo);
 void h_unpackfd (int32 hi, int32 lo, UFPH *a);
 void h_unpackg (int32 hi, int32 lo, UFPH *a);
 void h_unpackh (int32 *hflt, UFPH *a);
@@ -499,8 +530,7 @@ if (val < 0) {                                          /* negative? */
     }
 else a.sign = 0;                                        /* else sign = + */
 a.exp = 32 + H_BIAS;                                    /* initial exp */
-a.frac.f3 = val & LMASK;                                /* fraction hi */
-a.frac.f2 = a.frac.f1 = a.frac.f0 = 0;
+qp_load (&a.frac, val & LMASK, 0, 0, 0);               /* fraction hi */
 h_normh (&a);                                           /* normalize */
 return h_rpackh (&a, hf);                               /* round and pack */
 }
@@ -524,8 +554,8 @@ if (ubexp <= UH_V_NM) {                                 /* exp in range? */
     if (lnt == 03)                                      /* if CVTR, round */
         qp_inc (&a.frac);
     qp_rsh (&a.frac, 1);                                /* now justified */
-    if (a.frac.f3 || a.frac.f2 || a.frac.f1 ||
-        (a.frac.f0 > (maxv[lnt] + (a.sign? 1: 0))))
+    if (QP_GETL (a.frac, 3) || QP_GETL (a.frac, 2) || QP_GETL (a.frac, 1) ||
+        (QP_GETL (a.frac, 0) > (maxv[lnt] + (a.sign? 1: 0))))
         *flg = CC_V;
     }
 else {
@@ -534,7 +564,7 @@ else {
         return 0;
     qp_lsh (&a.frac, ubexp - UH_V_NM - 1);              /* no rnd bit */
     }
-return (a.sign? NEG (a.frac.f0): a.frac.f0);            /* return lo frac */
+return (a.sign? NEG (QP_GETL (a.frac, 0)): QP_GETL (a.frac, 0)); /* lo frac */
 }
 
 /* Floating to floating convert - F/D to H, G to H, H to F/D, H to G */
@@ -672,7 +702,7 @@ UFPH a, b;
 
 h_unpackh (&opnd[0], &a);                               /* unpack operands */
 h_unpackh (&opnd[5], &b);
-a.frac.f0 = a.frac.f0 | (opnd[4] >> 1);                 /* extend src1 */
+QP_SETL0 (a.frac, opnd[4] >> 1);                        /* extend src1 */
 vax_hmul (&a, &b, 0);                                   /* multiply */
 vax_hmod (&a, intgr, flg);                              /* sep int & frac */
 return h_rpackh (&a, hflt);                             /* round and pack frac */
@@ -687,13 +717,11 @@ void vax_hadd (UFPH *a, UFPH *b, uint32 mlo)
 int32 ediff;
 UFPH t;
 
-if ((a->frac.f3 == 0) && (a->frac.f2 == 0) &&           /* s1 = 0? */
-    (a->frac.f1 == 0) && (a->frac.f0 == 0)) {
+if (QP_ISZERO (a->frac)) {                              /* s1 = 0? */
     *a = *b;                                            /* result is s2 */
     return;
     }
-if ((b->frac.f3 == 0) && (b->frac.f2 == 0) &&           /* s2 = 0? */
-    (b->frac.f1 == 0) && (b->frac.f0 == 0))
+if (QP_ISZERO (b->frac))                                /* s2 = 0? */
     return;
 if ((a->exp < b->exp) ||                                /* |s1| < |s2|? */
     ((a->exp == b->exp) && (qp_cmp (&a->frac, &b->frac) < 0))) {
@@ -707,7 +735,7 @@ if (a->sign ^ b->sign) {                                /* eff sub? */
     if (ediff)                                          /* denormalize */
         qp_rsh_s (&b->frac, ediff, 1);
     qp_add (&a->frac, &b->frac);                        /* "add" frac */
-    a->frac.f0 = a->frac.f0 & ~mlo;                     /* mask before norm */
+    QP_CLRL0 (a->frac, mlo);                            /* mask before norm */
     h_normh (a);                                        /* normalize */
     }
 else {
@@ -715,40 +743,27 @@ else {
         qp_rsh (&b->frac, ediff);
     if (qp_add (&a->frac, &b->frac)) {                  /* add frac, carry? */
         qp_rsh (&a->frac, 1);                           /* renormalize */
-        a->frac.f3 = a->frac.f3 | UH_NM_H;              /* add norm bit */
+        QP_SETNM (a->frac);                             /* add norm bit */
         a->exp = a->exp + 1;                            /* incr exp */
         }
-    a->frac.f0 = a->frac.f0 & ~mlo;                      /* mask */
+    QP_CLRL0 (a->frac, mlo);                            /* mask */
     }
 return;
 }
 
-/* Floating multiply - 128b * 128b */
+/* Floating multiply - 128b * 128b, high 128b of product */
 
 void vax_hmul (UFPH *a, UFPH *b, uint32 mlo)
 {
-int32 i, c;
-UQP accum = { 0, 0, 0, 0 };
-
 if ((a->exp == 0) || (b->exp == 0)) {                   /* zero argument? */
-    a->frac.f0 = a->frac.f1 = 0;                        /* result is zero */
-    a->frac.f2 = a->frac.f3 = 0;
+    qp_load (&a->frac, 0, 0, 0, 0);                     /* result is zero */
     a->sign = a->exp = 0;
     return;
     }
 a->sign = a->sign ^ b->sign;                            /* sign of result */
 a->exp = a->exp + b->exp - H_BIAS;                      /* add exponents */
-for (i = 0; i < 128; i++) {                             /* quad precision */
-    if (a->frac.f0 & 1)                                 /* mplr low? add */
-        c = qp_add (&accum, &b->frac);
-    else c = 0;
-    qp_rsh (&accum, 1);                                 /* shift result */
-    if (c)                                              /* add carry out */
-        accum.f3 = accum.f3 | UH_NM_H;
-    qp_rsh (&a->frac, 1);                               /* shift mplr */
-    }
-a->frac = accum;                                        /* result */
-a->frac.f0 = a->frac.f0 & ~mlo;                         /* mask low frac */
+qp_mulhi (&a->frac, &b->frac, &a->frac);                /* multiply */
+QP_CLRL0 (a->frac, mlo);                                /* mask low frac */
 h_normh (a);                                            /* normalize */
 return;
 }
@@ -774,10 +789,10 @@ else if (a->exp <= (H_BIAS + 128)) {                    /* in range? */
     qp_rsh (&ifr, 128 - (a->exp - H_BIAS));             /* separate integer */
     if ((a->exp > (H_BIAS + 32)) ||                     /* test ovflo */
         ((a->exp == (H_BIAS + 32)) &&
-         (ifr.f0 > (a->sign? 0x80000000: 0x7FFFFFFF))))
+         (QP_GETL (ifr, 0) > (a->sign? 0x80000000: 0x7FFFFFFF))))
         *flg = CC_V;
     else *flg = 0;
-    *intgr = ifr.f0;
+    *intgr = QP_GETL (ifr, 0);
     if (a->sign)                                        /* -? comp int */
         *intgr = -*intgr;
     qp_lsh (&a->frac, a->exp - H_BIAS);                 /* excise integer */
@@ -787,13 +802,12 @@ else {
     if (a->exp < (H_BIAS + 160)) {                      /* left shift needed? */
         ifr = a->frac;
         qp_lsh (&ifr, a->exp - H_BIAS - 128);
-        *intgr = ifr.f0;
+        *intgr = QP_GETL (ifr, 0);
         }
     else *intgr = 0;                                    /* out of range */
     if (a->sign)
         *intgr = -*intgr;
-    a->frac.f0 = a->frac.f1 = 0;                        /* result 0 */
-    a->frac.f2 = a->frac.f3 = 0;
+    qp_load (&a->frac, 0, 0, 0, 0);                     /* result 0 */
     a->sign = a->exp = 0;
     *flg = CC_V;                                        /* overflow */
     }
@@ -803,213 +817,294 @@ return;
 
 /* Floating divide
 
-   Carried out to 128 bits, although fewer are required */
+   Carried out to 128 bits, although fewer are required.  The quotient
+   is that of a bitwise restoring divide of divd/2 by divr/2, which is
+   (divd/2 * 2^128) / (divr with its lsb cleared), truncated. */
 
 void vax_hdiv (UFPH *a, UFPH *b)
 {
-int32 i;
-UQP quo = { 0, 0, 0, 0 };
-
 if (a->exp == 0)                                        /* divr = 0? */
     FLT_DZRO_FAULT;
 if (b->exp == 0)                                        /* divd = 0? */
     return; 
 b->sign = b->sign ^ a->sign;                            /* result sign */
 b->exp = b->exp - a->exp + H_BIAS + 1;                  /* unbiased exp */
-qp_rsh (&a->frac, 1);                                   /* allow 1 bit left */
-qp_rsh (&b->frac, 1);
-for (i = 0; i < 128; i++) {                             /* divide loop */
-    qp_lsh (&quo, 1);                                   /* shift quo */
-    if (qp_cmp (&b->frac, &a->frac) >= 0) {             /* div step ok? */
-        qp_sub (&b->frac, &a->frac);                    /* subtract */
-        quo.f0 = quo.f0 + 1;                            /* quo bit = 1 */
-        }
-    qp_lsh (&b->frac, 1);                               /* shift divd */
-    }
-b->frac = quo;
+QP_CLRL0 (a->frac, 1);                                  /* divr/2, scaled */
+qp_rsh (&b->frac, 1);                                   /* divd/2 */
+qp_div (&b->frac, &a->frac, &b->frac);                  /* divide */
 h_normh (b);                                            /* normalize */
 return;
 }
 
 /* Quad precision integer routines */
 
-int32 qp_cmp (UQP *a, UQP *b)
+#if defined (__SIZEOF_INT128__) && !defined (DONT_USE_INT128)
+
+static void qp_load (UQP *r, uint32 l3, uint32 l2, uint32 l1, uint32 l0)
 {
-if (a->f3 < b->f3)                                      /* compare hi */
-    return -1;
-if (a->f3 > b->f3)
-    return +1;
-if (a->f2 < b->f2)                                      /* hi =, compare mid1 */
+*r = (((UQP) ((((t_uint64) l3) << 32) | l2)) << 64) |
+    ((((t_uint64) l1) << 32) | l0);
+return;
+}
+
+static int32 qp_cmp (UQP *a, UQP *b)
+{
+if (*a < *b)
     return -1;
-if (a->f2 > b->f2)
+if (*a > *b)
     return +1;
-if (a->f1 < b->f1)                                      /* mid1 =, compare mid2 */
+return 0;                                               /* all equal */
+}
+
+static uint32 qp_add (UQP *a, UQP *b)
+{
+*a = *a + *b;
+return (*a < *b);                                       /* return carry out */
+}
+
+static void qp_inc (UQP *a)
+{
+*a = *a + 1;
+return;
+}
+
+static void qp_neg (UQP *a)
+{
+*a = -*a;
+return;
+}
+
+static void qp_lsh (UQP *r, uint32 sc)
+{
+*r = (sc >= 128)? 0: *r << sc;                          /* > 127? result 0 */
+return;
+}
+
+static void qp_rsh (UQP *r, uint32 sc)
+{
+*r = (sc >= 128)? 0: *r >> sc;                          /* > 127? result 0 */
+return;
+}
+
+static void qp_rsh_s (UQP *r, uint32 sc, uint32 neg)
+{
+qp_rsh (r, sc);                                         /* do unsigned right */
+if (neg && sc)                                          /* negative? */
+    *r = *r | ((sc >= 128)? ~((UQP) 0): ~(~((UQP) 0) >> sc));
+return;
+}
+
+/* Number of leading zeroes, fraction is non-zero */
+
+static int32 qp_nlz (UQP *a)
+{
+t_uint64 hi = (t_uint64) (*a >> 64);
+
+if (hi)
+    return __builtin_clzll (hi);
+return 64 + __builtin_clzll ((t_uint64) *a);
+}
+
+/* High 128b of 128b * 128b, from four 64b * 64b partial products */
+
+static void qp_mulhi (UQP *a, UQP *b, UQP *r)
+{
+t_uint64 al = (t_uint64) *a, ah = (t_uint64) (*a >> 64);
+t_uint64 bl = (t_uint64) *b, bh = (t_uint64) (*b >> 64);
+UQP lo = ((UQP) al) * bl;
+UQP m1 = ((UQP) al) * bh;
+UQP m2 = ((UQP) ah) * bl;
+UQP mid = (lo >> 64) + ((t_uint64) m1) + ((t_uint64) m2);
+
+*r = (((UQP) ah) * bh) + (m1 >> 64) + (m2 >> 64) + (mid >> 64);
+return;
+}
+
+#else
+
+static void qp_load (UQP *r, uint32 l3, uint32 l2, uint32 l1, uint32 l0)
+{
+r->hi = (((t_uint64) l3) << 32) | l2;
+r->lo = (((t_uint64) l1) << 32) | l0;
+return;
+}
+
+static int32 qp_cmp (UQP *a, UQP *b)
+{
+if (a->hi < b->hi)                                      /* compare hi */
     return -1;
-if (a->f1 > b->f1)
+if (a->hi > b->hi)
     return +1;
-if (a->f0 < b->f0)                                      /* mid2 =, compare lo */
+if (a->lo < b->lo)                                      /* hi =, compare lo */
     return -1;
-if (a->f0 > b->f0)
+if (a->lo > b->lo)
     return +1;
 return 0;                                               /* all equal */
 }
 
-uint32 qp_add (UQP *a, UQP *b)
+static uint32 qp_add (UQP *a, UQP *b)
 {
-uint32 cry1, cry2, cry3, cry4;
-
-a->f0 = (a->f0 + b->f0) & LMASK;                        /* add lo */
-cry1 = (a->f0 < b->f0);                                 /* carry? */
-a->f1 = (a->f1 + b->f1 + cry1) & LMASK;                 /* add mid2 */
-cry2 = (a->f1 < b->f1) || (cry1 && (a->f1 == b->f1));   /* carry? */
-a->f2 = (a->f2 + b->f2 + cry2) & LMASK;                 /* add mid1 */
-cry3 = (a->f2 < b->f2) || (cry2 && (a->f2 == b->f2));   /* carry? */
-a->f3 = (a->f3 + b->f3 + cry3) & LMASK;                 /* add hi */
-cry4 = (a->f3 < b->f3) || (cry3 && (a->f3 == b->f3));   /* carry? */
-return cry4;                                            /* return carry out */
-}
+uint32 cry1, cry2;
 
-void qp_inc (UQP *a)
-{
-a->f0 = (a->f0 + 1) & LMASK;                            /* inc lo */
-if (a->f0 == 0) {                                       /* propagate carry */
-    a->f1 = (a->f1 + 1) & LMASK;
-    if (a->f1 == 0) {
-        a->f2 = (a->f2 + 1) & LMASK;
-        if (a->f2 == 0) {
-            a->f3 = (a->f3 + 1) & LMASK;
-            }
-        }
-    }
-return;
+a->lo = a->lo + b->lo;                                  /* add lo */
+cry1 = (a->lo < b->lo);                                 /* carry? */
+a->hi = a->hi + b->hi + cry1;                           /* add hi */
+cry2 = (a->hi < b->hi) || (cry1 && (a->hi == b->hi));   /* carry? */
+return cry2;                                            /* return carry out */
 }
 
-uint32 qp_sub (UQP *a, UQP *b)
+static void qp_inc (UQP *a)
 {
-uint32 brw1, brw2, brw3, brw4;
-
-brw1 = (a->f0 < b->f0);                                 /* borrow? */
-a->f0 = (a->f0 - b->f0) & LMASK;                        /* sub lo */
-brw2 = (a->f1 < b->f1) || (brw1 && (a->f1 == b->f1));   /* borrow? */
-a->f1 = (a->f1 - b->f1 - brw1) & LMASK;                 /* sub mid1 */
-brw3 = (a->f2 < b->f2) || (brw2 && (a->f2 == b->f2));   /* borrow? */
-a->f2 = (a->f2 - b->f2 - brw2) & LMASK;                 /* sub mid2 */
-brw4 = (a->f3 < b->f3) || (brw3 && (a->f3 == b->f3));   /* borrow? */
-a->f3 = (a->f3 - b->f3 - brw3) & LMASK;                 /* sub high */
-return brw4;
+a->lo = a->lo + 1;                                      /* inc lo */
+if (a->lo == 0)                                         /* propagate carry */
+    a->hi = a->hi + 1;
+return;
 }
 
-void qp_neg (UQP *a)
+static void qp_neg (UQP *a)
 {
-uint32 cryin;
-
-cryin = 1;
-a->f0 = (~a->f0 + cryin) & LMASK;
-if (a->f0 != 0)
-    cryin = 0;
-a->f1 = (~a->f1 + cryin) & LMASK;
-if (a->f1 != 0)
-    cryin = 0;
-a->f2 = (~a->f2 + cryin) & LMASK;
-if (a->f2 != 0)
-    cryin = 0;
-a->f3 = (~a->f3 + cryin) & LMASK;
+a->lo = ~a->lo + 1;
+a->hi = ~a->hi + (a->lo == 0);                          /* carry in */
 return;
 }
 
-void qp_lsh (UQP *r, uint32 sc)
+static void qp_lsh (UQP *r, uint32 sc)
 {
 if (sc >= 128)                                          /* > 127? result 0 */
-    r->f3 = r->f2 = r->f1 = r->f0 = 0;
-else if (sc >= 96) {                                    /* [96,127]? */
-    r->f3 = (r->f0 << (sc - 96)) & LMASK;
-    r->f2 = r->f1 = r->f0 = 0;
-    }
-else if (sc > 64) {                                     /* [65,95]? */
-    r->f3 = ((r->f1 << (sc - 64)) | (r->f0 >> (96 - sc))) & LMASK;
-    r->f2 = (r->f0 << (sc - 64)) & LMASK;
-    r->f1 = r->f0 = 0;
-    }
-else if (sc == 64) {                                    /* [64]? */
-    r->f3 = r->f1;
-    r->f2 = r->f0;
-    r->f1 = r->f0 = 0;
-    }
-else if (sc > 32) {                                     /* [33,63]? */
-    r->f3 = ((r->f2 << (sc - 32)) | (r->f1 >> (64 - sc))) & LMASK;
-    r->f2 = ((r->f1 << (sc - 32)) | (r->f0 >> (64 - sc))) & LMASK;
-    r->f1 = (r->f0 << (sc - 32)) & LMASK;
-    r->f0 = 0;
+    r->hi = r->lo = 0;
+else if (sc >= 64) {                                    /* [64,127]? */
+    r->hi = r->lo << (sc - 64);
+    r->lo = 0;
     }
-else if (sc == 32) {                                    /* [32]? */
-    r->f3 = r->f2;
-    r->f2 = r->f1;
-    r->f1 = r->f0;
-    r->f0 = 0;
-    }
-else if (sc != 0) {                                     /* [31,1]? */
-    r->f3 = ((r->f3 << sc) | (r->f2 >> (32 - sc))) & LMASK;
-    r->f2 = ((r->f2 << sc) | (r->f1 >> (32 - sc))) & LMASK;
-    r->f1 = ((r->f1 << sc) | (r->f0 >> (32 - sc))) & LMASK;
-    r->f0 = (r->f0 << sc) & LMASK;
+else if (sc != 0) {                                     /* [1,63]? */
+    r->hi = (r->hi << sc) | (r->lo >> (64 - sc));
+    r->lo = r->lo << sc;
     }
 return;
 }
 
-void qp_rsh (UQP *r, uint32 sc)
+static void qp_rsh (UQP *r, uint32 sc)
 {
 if (sc >= 128)                                          /* > 127? result 0 */
-    r->f3 = r->f2 = r->f1 = r->f0 = 0;
-else if (sc >= 96) {                                    /* [96,127]? */
-    r->f0 = (r->f3 >> (sc - 96)) & LMASK;
-    r->f1 = r->f2 = r->f3 = 0;
+    r->hi = r->lo = 0;
+else if (sc >= 64) {                                    /* [64,127]? */
+    r->lo = r->hi >> (sc - 64);
+    r->hi = 0;
     }
-else if (sc > 64) {                                     /* [65,95]? */
-    r->f0 = ((r->f2 >> (sc - 64)) | (r->f3 << (96 - sc))) & LMASK;
-    r->f1 = (r->f3 >> (sc - 64)) & LMASK;
-    r->f2 = r->f3 = 0;
+else if (sc != 0) {                                     /* [1,63]? */
+    r->lo = (r->lo >> sc) | (r->hi << (64 - sc));
+    r->hi = r->hi >> sc;
     }
-else if (sc == 64) {                                    /* [64]? */
-    r->f0 = r->f2;
-    r->f1 = r->f3;
-    r->f2 = r->f3 = 0;
+return;
+}
+
+static void qp_rsh_s (UQP *r, uint32 sc, uint32 neg)
+{
+UQP ones;
+
+qp_rsh (r, sc);                                         /* do unsigned right */
+if (neg && sc) {                                        /* negative? */
+    ones.hi = ones.lo = ~((t_uint64) 0);
+    if (sc < 128)                                       /* > 127? result -1 */
+        qp_lsh (&ones, 128 - sc);                       /* shift ones */
+    r->hi = r->hi | ones.hi;                            /* or into result */
+    r->lo = r->lo | ones.lo;
     }
-else if (sc > 32) {                                     /* [33,63]? */
-    r->f0 = ((r->f1 >> (sc - 32)) | (r->f2 << (64 - sc))) & LMASK;
-    r->f1 = ((r->f2 >> (sc - 32)) | (r->f3 << (64 - sc))) & LMASK;
-    r->f2 = (r->f3 >> (sc - 32)) & LMASK;
-    r->f3 = 0;
+return;
+}
+
+/* Number of leading zeroes, fraction is non-zero */
+
+static int32 qp_nlz (UQP *a)
+{
+t_uint64 t = a->hi? a->hi: a->lo;
+int32 n = a->hi? 0: 64;
+int32 sc;
+
+for (sc = 32; sc != 0; sc = sc >> 1) {                  /* binary search */
+    if ((t >> (64 - sc)) == 0) {
+        t = t << sc;
+        n = n + sc;
+        }
     }
-else if (sc == 32) {                                    /* [32]? */
-    r->f0 = r->f1;
-    r->f1 = r->f2;
-    r->f2 = r->f3;
-    r->f3 = 0;
+return n;
+}
+
+/* High 128b of 128b * 128b, by 32b digits */
+
+static void qp_mulhi (UQP *a, UQP *b, UQP *r)
+{
+uint32 x[4], y[4], w[8];
+t_uint64 t, k;
+int32 i, j;
+
+for (i = 0; i < 4; i++) {                               /* split operands */
+    x[i] = QP_GETL (*a, i);
+    y[i] = QP_GETL (*b, i);
+    w[i] = 0;
     }
-else if (sc != 0) {                                     /* [31,1]? */
-    r->f0 = ((r->f0 >> sc) | (r->f1 << (32 - sc))) & LMASK;
-    r->f1 = ((r->f1 >> sc) | (r->f2 << (32 - sc))) & LMASK;
-    r->f2 = ((r->f2 >> sc) | (r->f3 << (32 - sc))) & LMASK;
-    r->f3 = (r->f3 >> sc) & LMASK;
+for (i = 0; i < 4; i++) {                               /* schoolbook */
+    for (j = 0, k = 0; j < 4; j++) {
+        t = (((t_uint64) x[i]) * y[j]) + w[i + j] + k;
+        w[i + j] = (uint32) t;
+        k = t >> 32;
+        }
+    w[i + 4] = (uint32) k;
     }
+qp_load (r, w[7], w[6], w[5], w[4]);
 return;
 }
 
-void qp_rsh_s (UQP *r, uint32 sc, uint32 neg)
+#endif
+
+/* Fraction divide - quo = (n * 2^128) / d, truncated, for n < d and d
+   normalized (bit 127 set).  This is Knuth's algorithm D on 32b digits;
+   because d is normalized, no scaling is needed, and the quotient fits
+   in four digits. */
+
+static void qp_div (UQP *n, UQP *d, UQP *quo)
 {
-qp_rsh (r, sc);                                         /* do unsigned right */
-if (neg && sc) {                                        /* negative? */
-    if (sc >= 128)
-        r->f0 = r->f1 = r->f2 = r->f3 = LMASK;          /* > 127? result -1 */
-    else {
-        UQP ones = { LMASK, LMASK, LMASK, LMASK };
-        qp_lsh (&ones, 128 - sc);                       /* shift ones */
-        r->f0 = r->f0 | ones.f0;                        /* or into result */
-        r->f1 = r->f1 | ones.f1;
-        r->f2 = r->f2 | ones.f2;
-        r->f3 = r->f3 | ones.f3;
+uint32 u[8], v[4], q[4];
+t_uint64 qhat, rhat, p;
+t_int64 t, k;
+int32 i, j;
+
+for (i = 0; i < 4; i++) {
+    u[i] = 0;                                           /* dividend */
+    u[i + 4] = QP_GETL (*n, i);
+    v[i] = QP_GETL (*d, i);                             /* divisor */
+    }
+for (j = 3; j >= 0; j--) {                              /* quotient digits */
+    p = (((t_uint64) u[j + 4]) << 32) | u[j + 3];
+    qhat = p / v[3];                                    /* estimate */
+    rhat = p - (qhat * v[3]);
+    while ((qhat >> 32) ||
+        ((qhat * v[2]) > ((rhat << 32) | u[j + 2]))) {
+        qhat = qhat - 1;                                /* refine */
+        rhat = rhat + v[3];
+        if (rhat >> 32)
+            break;
+        }
+    for (i = 0, k = 0; i < 4; i++) {                    /* multiply, subtract */
+        p = qhat * v[i];
+        t = ((t_int64) u[i + j]) - k - ((t_int64) (p & LMASK));
+        u[i + j] = (uint32) t;
+        k = ((t_int64) (p >> 32)) - (t >> 32);
+        }
+    t = ((t_int64) u[j + 4]) - k;
+    u[j + 4] = (uint32) t;
+    q[j] = (uint32) qhat;
+    if (t < 0) {                                        /* too much? */
+        q[j] = q[j] - 1;                                /* add back */
+        for (i = 0, k = 0; i < 4; i++) {
+            t = ((t_int64) u[i + j]) + v[i] + k;
+            u[i + j] = (uint32) t;
+            k = t >> 32;
+            }
+        u[j + 4] = u[j + 4] + (uint32) k;
         }
     }
+qp_load (quo, q[3], q[2], q[1], q[0]);
 return;
 }
 
@@ -1019,15 +1114,14 @@ void h_unpackfd (int32 hi, int32 lo, UFPH *r)
 {
 r->sign = hi & FPSIGN;                                  /* get sign */
 r->exp = FD_GETEXP (hi);                                /* get exponent */
-r->frac.f0 = r->frac.f1 = 0;                            /* low bits 0 */
 if (r->exp == 0) {                                      /* exp = 0? */
     if (r->sign)                                        /* if -, rsvd op */
         RSVD_OPND_FAULT;
-    r->frac.f2 = r->frac.f3 = 0;                        /* else 0 */
+    qp_load (&r->frac, 0, 0, 0, 0);                     /* else 0 */
     return;
     }
-r->frac.f3 = WORDSWAP ((hi & ~(FPSIGN | FD_EXP)) | FD_HB);
-r->frac.f2 = WORDSWAP (lo);
+qp_load (&r->frac, WORDSWAP ((hi & ~(FPSIGN | FD_EXP)) | FD_HB),
+    WORDSWAP (lo), 0, 0);                               /* low bits 0 */
 qp_lsh (&r->frac, FD_GUARD);
 return;
 }
@@ -1036,15 +1130,14 @@ void h_unpackg (int32 hi, int32 lo, UFPH *r)
 {
 r->sign = hi & FPSIGN;                                  /* get sign */
 r->exp = G_GETEXP (hi);                                 /* get exponent */
-r->frac.f0 = r->frac.f1 = 0;                            /* low bits 0 */
 if (r->exp == 0) {                                      /* exp = 0? */
     if (r->sign)                                        /* if -, rsvd op */
         RSVD_OPND_FAULT;
-    r->frac.f2 = r->frac.f3 = 0;                        /* else 0 */
+    qp_load (&r->frac, 0, 0, 0, 0);                     /* else 0 */
     return;
     }
-r->frac.f3 = WORDSWAP ((hi & ~(FPSIGN | G_EXP)) | G_HB);
-r->frac.f2 = WORDSWAP (lo);
+qp_load (&r->frac, WORDSWAP ((hi & ~(FPSIGN | G_EXP)) | G_HB),
+    WORDSWAP (lo), 0, 0);                               /* low bits 0 */
 qp_lsh (&r->frac, G_GUARD);
 return;
 }
@@ -1056,53 +1149,44 @@ r->exp = H_GETEXP (hflt[0]);                            /* get exponent */
 if (r->exp == 0) {                                      /* exp = 0? */
     if (r->sign)                                        /* if -, rsvd op */
         RSVD_OPND_FAULT;
-    r->frac.f0 = r->frac.f1 = 0;                        /* else 0 */
-    r->frac.f2 = r->frac.f3 = 0;
+    qp_load (&r->frac, 0, 0, 0, 0);                     /* else 0 */
     return;
     }
-r->frac.f3 = (hflt[0] & ~(FPSIGN | H_EXP)) | H_HB;      /* del sign, exp, add hb */
-r->frac.f3 = WORDSWAP (r->frac.f3);
-r->frac.f2 = WORDSWAP (hflt[1]);
-r->frac.f1 = WORDSWAP (hflt[2]);
-r->frac.f0 = WORDSWAP (hflt[3]);
+qp_load (&r->frac,                                      /* del sign, exp, add hb */
+    WORDSWAP ((hflt[0] & ~(FPSIGN | H_EXP)) | H_HB),
+    WORDSWAP (hflt[1]), WORDSWAP (hflt[2]), WORDSWAP (hflt[3]));
 qp_lsh (&r->frac, H_GUARD);
 return;
 }
 
 void h_normh (UFPH *r)
 {
-int32 i;
-static uint32 normmask[5] = {
- 0xc0000000, 0xf0000000, 0xff000000, 0xffff0000, 0xffffffff };
-static int32 normtab[6] = { 1, 2, 4, 8, 16, 32};
+int32 sc;
 
-if ((r->frac.f0 == 0) && (r->frac.f1 == 0) &&
-    (r->frac.f2 == 0) && (r->frac.f3 == 0)) {           /* if fraction = 0 */
+if (QP_ISZERO (r->frac)) {                              /* if fraction = 0 */
     r->sign = r->exp = 0;                               /* result is 0 */
     return;
     }
-while ((r->frac.f3 & UH_NM_H) == 0) {                   /* normalized? */
-    for (i = 0; i < 5; i++) {                           /* find first 1 */
-        if (r->frac.f3 & normmask[i])
-            break;
-        }
-    qp_lsh (&r->frac, normtab[i]);                      /* shift frac */
-    r->exp = r->exp - normtab[i];                       /* decr exp */
-    }
+sc = qp_nlz (&r->frac);                                 /* find first 1 */
+qp_lsh (&r->frac, sc);                                  /* shift frac */
+r->exp = r->exp - sc;                                   /* decr exp */
 return;
 }
 
 int32 h_rpackfd (UFPH *r, int32 *rh)
 {
-static UQP f_round = { 0, 0, 0, UH_FRND };
-static UQP d_round = { 0, 0, UH_DRND, 0 };
+UQP rnd;
 
 if (rh)                                                 /* assume 0 */
     *rh = 0;
-if ((r->frac.f3 == 0) && (r->frac.f2 == 0))             /* frac = 0? done */
+if ((QP_GETL (r->frac, 3) == 0) &&                      /* frac = 0? done */
+    (QP_GETL (r->frac, 2) == 0))
     return 0;
-qp_add (&r->frac, rh? &d_round: &f_round);
-if ((r->frac.f3 & UH_NM_H) == 0) {                      /* carry out? */
+if (rh)                                                 /* D or F round */
+    qp_load (&rnd, 0, UH_DRND, 0, 0);
+else qp_load (&rnd, UH_FRND, 0, 0, 0);
+qp_add (&r->frac, &rnd);
+if ((QP_GETL (r->frac, 3) & UH_NM_H) == 0) {            /* carry out? */
     qp_rsh (&r->frac, 1);                               /* renormalize */
     r->exp = r->exp + 1;
     }
@@ -1115,20 +1199,22 @@ if (r->exp <= 0) {                                      /* underflow? */
     }
 qp_rsh (&r->frac, FD_GUARD);                            /* remove guard */
 if (rh)
-    *rh = WORDSWAP (r->frac.f2);
+    *rh = WORDSWAP (QP_GETL (r->frac, 2));
 return r->sign | (r->exp << FD_V_EXP) |
-    (WORDSWAP (r->frac.f3) & ~(FD_HB | FPSIGN | FD_EXP));
+    (WORDSWAP (QP_GETL (r->frac, 3)) & ~(FD_HB | FPSIGN | FD_EXP));
 }
 
 int32 h_rpackg (UFPH *r, int32 *rh)
 {
-static UQP g_round = { 0, 0, UH_GRND, 0 };
+UQP rnd;
 
 *rh = 0;                                                /* assume 0 */
-if ((r->frac.f3 == 0) && (r->frac.f2 == 0))             /* frac = 0? done */
+if ((QP_GETL (r->frac, 3) == 0) &&                      /* frac = 0? done */
+    (QP_GETL (r->frac, 2) == 0))
     return 0;
-qp_add (&r->frac, &g_round);                            /* round */
-if ((r->frac.f3 & UH_NM_H) == 0) {                      /* carry out? */
+qp_load (&rnd, 0, UH_GRND, 0, 0);
+qp_add (&r->frac, &rnd);                                /* round */
+if ((QP_GETL (r->frac, 3) & UH_NM_H) == 0) {            /* carry out? */
     qp_rsh (&r->frac, 1);                               /* renormalize */
     r->exp = r->exp + 1;
     }
@@ -1140,20 +1226,20 @@ if (r->exp <= 0) {                                      /* underflow? */
     return 0;                                           /* else 0 */
     }
 qp_rsh (&r->frac, G_GUARD);                             /* remove guard */
-*rh = WORDSWAP (r->frac.f2);                            /* get low */
+*rh = WORDSWAP (QP_GETL (r->frac, 2));                  /* get low */
 return r->sign | (r->exp << G_V_EXP) |
-    (WORDSWAP (r->frac.f3) & ~(G_HB | FPSIGN | G_EXP));
+    (WORDSWAP (QP_GETL (r->frac, 3)) & ~(G_HB | FPSIGN | G_EXP));
 }
 
 int32 h_rpackh (UFPH *r, int32 *hflt)
 {
-static UQP h_round = { UH_HRND, 0, 0, 0 };
+UQP rnd;
 
 hflt[0] = hflt[1] = hflt[2] = hflt[3] = 0;              /* assume 0 */
-if ((r->frac.f3 == 0) && (r->frac.f2 == 0) &&           /* frac = 0? done */
-    (r->frac.f1 == 0) && (r->frac.f0 == 0))
+if (QP_ISZERO (r->frac))                                /* frac = 0? done */
     return 0;
-if (qp_add (&r->frac, &h_round)) {                      /* round, carry out? */
+qp_load (&rnd, 0, 0, 0, UH_HRND);
+if (qp_add (&r->frac, &rnd)) {                          /* round, carry out? */
     qp_rsh (&r->frac, 1);                               /* renormalize */
     r->exp = r->exp + 1;
     }
@@ -1166,10 +1252,10 @@ if (r->exp <= 0) {                                      /* underflow? */
     }
 qp_rsh (&r->frac, H_GUARD);                             /* remove guard */
 hflt[0] = r->sign | (r->exp << H_V_EXP) |
-    (WORDSWAP (r->frac.f3) & ~(H_HB | FPSIGN | H_EXP));
-hflt[1] = WORDSWAP (r->frac.f2);
-hflt[2] = WORDSWAP (r->frac.f1);
-hflt[3] = WORDSWAP (r->frac.f0);
+    (WORDSWAP (QP_GETL (r->frac, 3)) & ~(H_HB | FPSIGN | H_EXP));
+hflt[1] = WORDSWAP (QP_GETL (r->frac, 2));
+hflt[2] = WORDSWAP (QP_GETL (r->frac, 1));
+hflt[3] = WORDSWAP (QP_GETL (r->frac, 0));
 return hflt[0];
 }
 
@@ -451,8 +451,14 @@ typedef struct {
 
 #define IVCL(dv)        ((IPL_##dv * 32) + INT_V_##dv)
 #define IREQ(dv)        int_req[IPL_##dv]
-#define SET_INT(dv)     int_req[IPL_##dv] = int_req[IPL_##dv] | (INT_##dv)
+#define SET_INT(dv)     int_req[IPL_##dv] = int_req[IPL_##dv] | (INT_##dv), \
+                        int_sum = int_sum | (1u << IPL_##dv)
 #define CLR_INT(dv)     int_req[IPL_##dv] = int_req[IPL_##dv] & ~(INT_##dv)
+
+/* int_sum has a bit for each hardware level that may have a request.
+   SET_INT sets it; eval_int clears it when it finds the level empty. */
+
+extern uint32 int_sum;
 #define IORETURN(f,v)   ((f)? (v): SCPE_OK)             /* cond error return */
 
 /* Logging */
@@ -239,6 +239,7 @@ extern t_stat pal_proc_trap (uint32 type);
 extern t_stat pal_proc_intr (uint32 type);
 extern t_stat pal_proc_inst (uint32 fnc);
 extern uint32 tlb_set_cm (int32 cm);
+extern void tlb_rebuild (void);
 
 /* CPU data structures
 
@@ -382,7 +383,10 @@ if (abortval != 0) {                                    /* exception? */
         }
     reason = pal_proc_excp (abortval);                  /* pal processing */
     }
-else reason = 0;
+else {
+    tlb_rebuild ();                                     /* TLBs may be changed */
+    reason = 0;
+    }
 tlb_set_cm (-1);                                        /* resync cm */
 tracing = ((hst_lnt != 0) || DEBUG_PRS (cpu_dev));
 
@@ -46,28 +46,63 @@
         tlb_ia                  TLB invalidate all
         tlb_is                  TLB invalidate single
         tlb_set_cm              TLB set current mode
+        tlb_rebuild             rebuild TLB hash tables after console changes
+
+   The TLBs are fully associative, with round-robin replacement through the
+   not-last-used (NLU) pointer.  Entry i of itlb/dtlb is always TLB entry i,
+   so loads and reads index the arrays directly.  Valid entries are also
+   chained into a hash table, keyed by the vpn with the entry's granularity
+   hint bits removed; a lookup probes one chain for each granularity hint
+   in use.  In front of the hash table, a direct-mapped micro TLB remembers
+   recent translations.  It is flushed by bumping a generation number
+   whenever a TLB entry or the ASN changes.  The single entry mini TLB
+   still holds the last translation returned.
 */
 
 #include "alpha_defs.h"
 #include "alpha_ev5_defs.h"
 
-#define ITLB_SORT       qsort (itlb, ITLB_SIZE, sizeof (TLBENT), &tlb_comp);
-#define DTLB_SORT       qsort (dtlb, DTLB_SIZE, sizeof (TLBENT), &tlb_comp);
 #define TLB_ESIZE       (sizeof (TLBENT)/sizeof (uint32))
 #define MM_RW(x)        (((x) & PTE_FOW)? EXC_W: EXC_R)
 
+#define TLB_HBITS       7                               /* hash table */
+#define TLB_HSIZE       (1u << TLB_HBITS)
+#define TLB_HMASK       (TLB_HSIZE - 1)
+#define TLB_HASH(k,g)   (((k) ^ ((k) >> TLB_HBITS) ^ ((g) << 5)) & TLB_HMASK)
+#define UTLB_BITS       6                               /* micro TLB */
+#define UTLB_SIZE       (1u << UTLB_BITS)
+#define UTLB_MASK       (UTLB_SIZE - 1)
+#define GH_NUM          (PTE_M_GH + 1)
+
+typedef struct {
+    uint32              tag;                            /* vpn */
+    uint32              gen;                            /* generation */
+    TLBENT              *tlbp;                          /* TLB entry */
+    } UTLBENT;
+
+typedef struct {
+    uint32              size;                           /* # entries */
+    int32               head[TLB_HSIZE];                /* hash chains */
+    int32               next[DTLB_SIZE];                /* chain links */
+    uint32              ngh[GH_NUM];                    /* entries per gh */
+    uint32              gen;                            /* micro TLB gen */
+    UTLBENT             utlb[UTLB_SIZE];                /* micro TLB */
+    } TLBHASH;
+
 uint32 itlb_cm = 0;                                     /* current modes */
 uint32 itlb_spage = 0;                                  /* superpage enables */
 uint32 itlb_asn = 0;
 uint32 itlb_nlu = 0;
 TLBENT i_mini_tlb;
 TLBENT itlb[ITLB_SIZE];
+TLBHASH itlb_h = { ITLB_SIZE };
 uint32 dtlb_cm = 0;
 uint32 dtlb_spage = 0;
 uint32 dtlb_asn = 0;
 uint32 dtlb_nlu = 0;
 TLBENT d_mini_tlb;
 TLBENT dtlb[DTLB_SIZE];
+TLBHASH dtlb_h = { DTLB_SIZE };
 
 uint32 cm_eacc = ACC_E (MODE_K);                        /* precomputed */
 uint32 cm_racc = ACC_R (MODE_K);                        /* access checks */
@@ -81,8 +116,14 @@ uint32 mm_exc (uint32 macc);
 void tlb_inval (TLBENT *tlbp);
 t_stat itlb_reset (void);
 t_stat dtlb_reset (void);
-int tlb_comp (const void *e1, const void *e2);
 t_stat tlb_reset (DEVICE *dptr);
+uint32 tlb_gh (uint32 gh_mask);
+TLBENT *tlb_find (TLBENT *tlb, TLBHASH *th, uint32 asn, uint32 vpn);
+void tlb_hash_ins (TLBENT *tlb, TLBHASH *th, uint32 i);
+void tlb_hash_del (TLBENT *tlb, TLBHASH *th, uint32 i);
+void tlb_hash_clr (TLBHASH *th);
+void tlb_utlb_flush (TLBHASH *th);
+void tlb_rehash (TLBENT *tlb, TLBHASH *th);
 
 /* TLB data structures
 
@@ -198,15 +239,17 @@ uint32 vpn = VA_GETVPN (va);
 TLBENT *itlbp, *dtlbp;
 
 if ((va_sext != 0) && (va_sext != VA_M_SEXT)) return;
-if ((flags & TLB_CI) && (itlbp = itlb_lookup (vpn))) {
+if ((flags & TLB_CI) && (itlbp = tlb_find (itlb, &itlb_h, itlb_asn, vpn))) {
+    tlb_hash_del (itlb, &itlb_h, itlbp->idx);
     tlb_inval (itlbp);
     tlb_inval (&i_mini_tlb);
-    ITLB_SORT;
+    tlb_utlb_flush (&itlb_h);
     }
-if ((flags & TLB_CD) && (dtlbp = dtlb_lookup (vpn))) {
+if ((flags & TLB_CD) && (dtlbp = tlb_find (dtlb, &dtlb_h, dtlb_asn, vpn))) {
+    tlb_hash_del (dtlb, &dtlb_h, dtlbp->idx);
     tlb_inval (dtlbp);
     tlb_inval (&d_mini_tlb);
-    DTLB_SORT;
+    tlb_utlb_flush (&dtlb_h);
     }
 return;
 }
@@ -224,167 +267,165 @@ if (flags & TLB_CA) {
     }
 if (flags & TLB_CI) {
     for (i = 0; i < ITLB_SIZE; i++) {
-        if (!(itlb[i].pte & PTE_ASM)) tlb_inval (&itlb[i]);
+        if (!(itlb[i].pte & PTE_ASM)) {
+            tlb_hash_del (itlb, &itlb_h, i);
+            tlb_inval (&itlb[i]);
+            }
         }
     tlb_inval (&i_mini_tlb);
-    ITLB_SORT;
+    tlb_utlb_flush (&itlb_h);
     }
 if (flags & TLB_CD) {
     for (i = 0; i < DTLB_SIZE; i++) {
-        if (!(dtlb[i].pte & PTE_ASM)) tlb_inval (&dtlb[i]);
+        if (!(dtlb[i].pte & PTE_ASM)) {
+            tlb_hash_del (dtlb, &dtlb_h, i);
+            tlb_inval (&dtlb[i]);
+            }
         }
     tlb_inval (&d_mini_tlb);
-    DTLB_SORT;
+    tlb_utlb_flush (&dtlb_h);
     }
 return;
 }
 
-/* TLB lookup */
+/* TLB lookup
+
+   The mini TLB is checked first; on a hit there, the NLU pointer is not
+   changed.  Otherwise the micro TLB and then the hash table are searched,
+   the translation is copied to the mini TLB, and the NLU pointer is moved
+   past the matching entry.
+*/
 
 TLBENT *itlb_lookup (uint32 vpn)
 {
-int32 p, hi, lo;
+TLBENT *tlbp;
+UTLBENT *up;
 
 if (vpn == i_mini_tlb.tag) return &i_mini_tlb;
-lo = 0;                                                 /* initial bounds */
-hi = ITLB_SIZE - 1;
-do {
-    p = (lo + hi) >> 1;                                 /* probe */
-    if ((itlb_asn == itlb[p].asn) && 
-        (((vpn ^ itlb[p].tag) &
-         ~((uint32) itlb[p].gh_mask)) == 0)) {          /* match to TLB? */
-        i_mini_tlb.tag = vpn;
-        i_mini_tlb.pte = itlb[p].pte;
-        i_mini_tlb.pfn = itlb[p].pfn;
-        itlb_nlu = itlb[p].idx + 1;
-        if (itlb_nlu >= ITLB_SIZE) itlb_nlu = 0;
-        return &i_mini_tlb;
-        }
-    if ((itlb_asn < itlb[p].asn) ||
-        ((itlb_asn == itlb[p].asn) && (vpn < itlb[p].tag)))
-        hi = p - 1;                                     /* go down? p is upper */
-    else lo = p + 1;                                    /* go up? p is lower */
+up = &itlb_h.utlb[vpn & UTLB_MASK];                     /* micro TLB */
+if ((up->tag == vpn) && (up->gen == itlb_h.gen))
+    tlbp = up->tlbp;
+else {
+    if (!(tlbp = tlb_find (itlb, &itlb_h, itlb_asn, vpn)))
+        return NULL;
+    up->tag = vpn;                                      /* fill micro TLB */
+    up->gen = itlb_h.gen;
+    up->tlbp = tlbp;
     }
-while (lo <= hi);
-return NULL;
+i_mini_tlb.tag = vpn;
+i_mini_tlb.pte = tlbp->pte;
+i_mini_tlb.pfn = tlbp->pfn;
+itlb_nlu = tlbp->idx + 1;
+if (itlb_nlu >= ITLB_SIZE) itlb_nlu = 0;
+return &i_mini_tlb;
 }
 
 TLBENT *dtlb_lookup (uint32 vpn)
 {
-int32 p, hi, lo;
+TLBENT *tlbp;
+UTLBENT *up;
 
 if (vpn == d_mini_tlb.tag) return &d_mini_tlb;
-lo = 0;                                                 /* initial bounds */
-hi = DTLB_SIZE - 1;
-do {
-    p = (lo + hi) >> 1;                                 /* probe */
-    if ((dtlb_asn == dtlb[p].asn) && 
-        (((vpn ^ dtlb[p].tag) &
-         ~((uint32) dtlb[p].gh_mask)) == 0)) {          /* match to TLB? */
-        d_mini_tlb.tag = vpn;
-        d_mini_tlb.pte = dtlb[p].pte;
-        d_mini_tlb.pfn = dtlb[p].pfn;
-        dtlb_nlu = dtlb[p].idx + 1;
-        if (dtlb_nlu >= DTLB_SIZE) dtlb_nlu = 0;
-        return &d_mini_tlb;
-        }
-    if ((dtlb_asn < dtlb[p].asn) ||
-        ((dtlb_asn == dtlb[p].asn) && (vpn < dtlb[p].tag)))
-        hi = p - 1;                                     /* go down? p is upper */
-    else lo = p + 1;                                    /* go up? p is lower */
+up = &dtlb_h.utlb[vpn & UTLB_MASK];                     /* micro TLB */
+if ((up->tag == vpn) && (up->gen == dtlb_h.gen))
+    tlbp = up->tlbp;
+else {
+    if (!(tlbp = tlb_find (dtlb, &dtlb_h, dtlb_asn, vpn)))
+        return NULL;
+    up->tag = vpn;                                      /* fill micro TLB */
+    up->gen = dtlb_h.gen;
+    up->tlbp = tlbp;
     }
-while (lo <= hi);
-return NULL;
+d_mini_tlb.tag = vpn;
+d_mini_tlb.pte = tlbp->pte;
+d_mini_tlb.pfn = tlbp->pfn;
+dtlb_nlu = tlbp->idx + 1;
+if (dtlb_nlu >= DTLB_SIZE) dtlb_nlu = 0;
+return &d_mini_tlb;
 }
 
 /* Load TLB entry at NLU pointer, advance NLU pointer */
 
 TLBENT *itlb_load (uint32 vpn, t_uint64 l3pte)
 {
-uint32 i, gh;
+TLBENT *tlbp;
+uint32 gh;
 
-for (i = 0; i < ITLB_SIZE; i++) {
-    if (itlb[i].idx == itlb_nlu) {
-        TLBENT *tlbp = itlb + i;
-        itlb_nlu = itlb_nlu + 1;
-        if (itlb_nlu >= ITLB_SIZE) itlb_nlu = 0;
-        tlbp->tag = vpn;
-        tlbp->pte = (uint32) (l3pte & PTE_MASK) ^ (PTE_FOR|PTE_FOR|PTE_FOE);
-        tlbp->pfn = ((uint32) (l3pte >> PTE_V_PFN)) & PFN_MASK;
-        tlbp->asn = itlb_asn;
-        gh = PTE_GETGH (tlbp->pte);
-        tlbp->gh_mask = (1u << (3 * gh)) - 1;
-        tlb_inval (&i_mini_tlb);
-        ITLB_SORT;
-        return tlbp;
-        }
+if (itlb_nlu >= ITLB_SIZE) {
+    fprintf (stderr, "%%ITLB entry not found, itlb_nlu = %d\n", itlb_nlu);
+    ABORT (-SCPE_IERR);
     }
-fprintf (stderr, "%%ITLB entry not found, itlb_nlu = %d\n", itlb_nlu);
-ABORT (-SCPE_IERR);
-return NULL;
+tlbp = itlb + itlb_nlu;
+tlb_hash_del (itlb, &itlb_h, itlb_nlu);                 /* remove old entry */
+itlb_nlu = itlb_nlu + 1;
+if (itlb_nlu >= ITLB_SIZE) itlb_nlu = 0;
+tlbp->tag = vpn;
+tlbp->pte = (uint32) (l3pte & PTE_MASK) ^ (PTE_FOR|PTE_FOR|PTE_FOE);
+tlbp->pfn = ((uint32) (l3pte >> PTE_V_PFN)) & PFN_MASK;
+tlbp->asn = itlb_asn;
+gh = PTE_GETGH (tlbp->pte);
+tlbp->gh_mask = (1u << (3 * gh)) - 1;
+tlb_hash_ins (itlb, &itlb_h, tlbp->idx);                /* insert new entry */
+tlb_inval (&i_mini_tlb);
+tlb_utlb_flush (&itlb_h);
+return tlbp;
 }
 
 TLBENT *dtlb_load (uint32 vpn, t_uint64 l3pte)
 {
-uint32 i, gh;
+TLBENT *tlbp;
+uint32 gh;
 
-for (i = 0; i < DTLB_SIZE; i++) {
-    if (dtlb[i].idx == dtlb_nlu) {
-        TLBENT *tlbp = dtlb + i;
-        dtlb_nlu = dtlb_nlu + 1;
-        if (dtlb_nlu >= ITLB_SIZE) dtlb_nlu = 0;
-        tlbp->tag = vpn;
-        tlbp->pte = (uint32) (l3pte & PTE_MASK) ^ (PTE_FOR|PTE_FOR|PTE_FOE);
-        tlbp->pfn = ((uint32) (l3pte >> PTE_V_PFN)) & PFN_MASK;
-        tlbp->asn = dtlb_asn;
-        gh = PTE_GETGH (tlbp->pte);
-        tlbp->gh_mask = (1u << (3 * gh)) - 1;
-        tlb_inval (&d_mini_tlb);
-        DTLB_SORT;
-        return tlbp;
-        }
+if (dtlb_nlu >= DTLB_SIZE) {
+    fprintf (stderr, "%%DTLB entry not found, dtlb_nlu = %d\n", dtlb_nlu);
+    ABORT (-SCPE_IERR);
     }
-fprintf (stderr, "%%DTLB entry not found, dtlb_nlu = %d\n", dtlb_nlu);
-ABORT (-SCPE_IERR);
-return NULL;
+tlbp = dtlb + dtlb_nlu;
+tlb_hash_del (dtlb, &dtlb_h, dtlb_nlu);                 /* remove old entry */
+dtlb_nlu = dtlb_nlu + 1;
+if (dtlb_nlu >= DTLB_SIZE) dtlb_nlu = 0;
+tlbp->tag = vpn;
+tlbp->pte = (uint32) (l3pte & PTE_MASK) ^ (PTE_FOR|PTE_FOR|PTE_FOE);
+tlbp->pfn = ((uint32) (l3pte >> PTE_V_PFN)) & PFN_MASK;
+tlbp->asn = dtlb_asn;
+gh = PTE_GETGH (tlbp->pte);
+tlbp->gh_mask = (1u << (3 * gh)) - 1;
+tlb_hash_ins (dtlb, &dtlb_h, tlbp->idx);                /* insert new entry */
+tlb_inval (&d_mini_tlb);
+tlb_utlb_flush (&dtlb_h);
+return tlbp;
 }
 
 /* Read TLB entry at NLU pointer, advance NLU pointer */
 
 t_uint64 itlb_read (void)
 {
-uint8 i;
+TLBENT *tlbp;
 
-for (i = 0; i < ITLB_SIZE; i++) {
-    if (itlb[i].idx == itlb_nlu) {
-        TLBENT *tlbp = itlb + i;
-        itlb_nlu = itlb_nlu + 1;
-        if (itlb_nlu >= ITLB_SIZE) itlb_nlu = 0;
-        return (((t_uint64) tlbp->pfn) << PTE_V_PFN) |
-            ((tlbp->pte ^ (PTE_FOR|PTE_FOR|PTE_FOE)) & PTE_MASK);
-        }
+if (itlb_nlu >= ITLB_SIZE) {
+    fprintf (stderr, "%%ITLB entry not found, itlb_nlu = %d\n", itlb_nlu);
+    ABORT (-SCPE_IERR);
     }
-fprintf (stderr, "%%ITLB entry not found, itlb_nlu = %d\n", itlb_nlu);
-ABORT (-SCPE_IERR);
-return 0;
+tlbp = itlb + itlb_nlu;
+itlb_nlu = itlb_nlu + 1;
+if (itlb_nlu >= ITLB_SIZE) itlb_nlu = 0;
+return (((t_uint64) tlbp->pfn) << PTE_V_PFN) |
+    ((tlbp->pte ^ (PTE_FOR|PTE_FOR|PTE_FOE)) & PTE_MASK);
 }
 
 t_uint64 dtlb_read (void)
 {
-uint8 i;
+TLBENT *tlbp;
 
-for (i = 0; i < DTLB_SIZE; i++) {
-    if (dtlb[i].idx == dtlb_nlu) {
-        TLBENT *tlbp = dtlb + i;
-        dtlb_nlu = dtlb_nlu + 1;
-        if (dtlb_nlu >= DTLB_SIZE) dtlb_nlu = 0;
-        return (((t_uint64) tlbp->pfn) << PTE_V_PFN) |
-            ((tlbp->pte ^ (PTE_FOR|PTE_FOR|PTE_FOE)) & PTE_MASK);
-        }
+if (dtlb_nlu >= DTLB_SIZE) {
+    fprintf (stderr, "%%DTLB entry not found, dtlb_nlu = %d\n", dtlb_nlu);
+    ABORT (-SCPE_IERR);
     }
-fprintf (stderr, "%%DTLB entry not found, dtlb_nlu = %d\n", dtlb_nlu);
-ABORT (-SCPE_IERR);
-return 0;
+tlbp = dtlb + dtlb_nlu;
+dtlb_nlu = dtlb_nlu + 1;
+if (dtlb_nlu >= DTLB_SIZE) dtlb_nlu = 0;
+return (((t_uint64) tlbp->pfn) << PTE_V_PFN) |
+    ((tlbp->pte ^ (PTE_FOR|PTE_FOR|PTE_FOE)) & PTE_MASK);
 }
 
 /* Set ASN - rewrite TLB globals with correct ASN */
@@ -398,7 +439,7 @@ for (i = 0; i < ITLB_SIZE; i++) {
     if (itlb[i].pte & PTE_ASM) itlb[i].asn = asn;
     }
 tlb_inval (&i_mini_tlb);
-ITLB_SORT;
+tlb_utlb_flush (&itlb_h);
 return;
 } 
 
@@ -411,7 +452,7 @@ for (i = 0; i < DTLB_SIZE; i++) {
     if (dtlb[i].pte & PTE_ASM) dtlb[i].asn = asn;
     }
 tlb_inval (&d_mini_tlb);
-DTLB_SORT;
+tlb_utlb_flush (&dtlb_h);
 return;
 }
 
@@ -470,18 +511,138 @@ tlbp->gh_mask = 0;
 return;
 }
 
-/* Compare routine for qsort */
+/* Granularity hint from gh mask */
 
-int tlb_comp (const void *e1, const void *e2)
+uint32 tlb_gh (uint32 gh_mask)
 {
-TLBENT *t1 = (TLBENT *) e1;
-TLBENT *t2 = (TLBENT *) e2;
-
-if (t1->asn > t2->asn) return +1;
-if (t1->asn < t2->asn) return -1;
-if (t1->tag > t2->tag) return +1;
-if (t1->tag < t2->tag) return -1;
-return 0;
+uint32 gh;
+
+for (gh = PTE_M_GH; gh > 0; gh--) {
+    if (gh_mask & (1u << ((3 * gh) - 1))) break;
+    }
+return gh;
+}
+
+/* Find the TLB entry matching vpn in the current ASN, using the hash table */
+
+TLBENT *tlb_find (TLBENT *tlb, TLBHASH *th, uint32 asn, uint32 vpn)
+{
+uint32 gh, key;
+int32 i;
+TLBENT *tlbp;
+
+for (gh = 0; gh < GH_NUM; gh++) {
+    if (th->ngh[gh] == 0) continue;                     /* none with this gh? */
+    key = vpn >> (3 * gh);
+    for (i = th->head[TLB_HASH (key, gh)]; i >= 0; i = th->next[i]) {
+        tlbp = tlb + i;
+        if ((asn == tlbp->asn) &&
+            (((vpn ^ tlbp->tag) & ~((uint32) tlbp->gh_mask)) == 0))
+            return tlbp;
+        }
+    }
+return NULL;
+}
+
+/* Insert TLB entry i in the hash table, if valid */
+
+void tlb_hash_ins (TLBENT *tlb, TLBHASH *th, uint32 i)
+{
+uint32 gh, b;
+
+if (tlb[i].tag == INV_TAG) return;
+gh = tlb_gh (tlb[i].gh_mask);
+b = TLB_HASH (tlb[i].tag >> (3 * gh), gh);
+th->next[i] = th->head[b];
+th->head[b] = i;
+th->ngh[gh]++;
+return;
+}
+
+/* Remove TLB entry i from the hash table, if present */
+
+void tlb_hash_del (TLBENT *tlb, TLBHASH *th, uint32 i)
+{
+uint32 gh;
+int32 *lp;
+
+if (tlb[i].tag == INV_TAG) return;
+gh = tlb_gh (tlb[i].gh_mask);
+for (lp = &th->head[TLB_HASH (tlb[i].tag >> (3 * gh), gh)];
+    *lp >= 0; lp = &th->next[*lp]) {
+    if (*lp == (int32) i) {
+        *lp = th->next[i];
+        th->ngh[gh]--;
+        return;
+        }
+    }
+return;
+}
+
+/* Clear hash table */
+
+void tlb_hash_clr (TLBHASH *th)
+{
+uint32 i;
+
+for (i = 0; i < TLB_HSIZE; i++) th->head[i] = -1;
+for (i = 0; i < GH_NUM; i++) th->ngh[i] = 0;
+tlb_utlb_flush (th);
+return;
+}
+
+/* Flush micro TLB */
+
+void tlb_utlb_flush (TLBHASH *th)
+{
+th->gen = th->gen + 1;
+if (th->gen == 0) {                                     /* wrapped? */
+    memset (th->utlb, 0, sizeof (th->utlb));
+    th->gen = 1;
+    }
+return;
+}
+
+/* Rebuild hash table
+
+   The TLB arrays are visible as registers, and may have been changed from
+   the console or restored from an older save file, in which the entries
+   were kept sorted.  Put each entry back in the slot given by its index,
+   and rebuild the hash table.
+*/
+
+void tlb_rehash (TLBENT *tlb, TLBHASH *th)
+{
+TLBENT old[DTLB_SIZE];
+t_bool used[DTLB_SIZE];
+uint32 i;
+
+memcpy (old, tlb, th->size * sizeof (TLBENT));
+memset (used, 0, sizeof (used));
+for (i = 0; i < th->size; i++) {
+    if ((old[i].idx < th->size) && !used[old[i].idx]) {
+        tlb[old[i].idx] = old[i];
+        used[old[i].idx] = TRUE;
+        }
+    }
+tlb_hash_clr (th);
+for (i = 0; i < th->size; i++) {
+    if (!used[i]) {                                     /* lost entry? */
+        tlb[i].idx = i;
+        tlb_inval (&tlb[i]);
+        }
+    tlb_hash_ins (tlb, th, i);
+    }
+return;
+}
+
+void tlb_rebuild (void)
+{
+tlb_rehash (itlb, &itlb_h);
+tlb_inval (&i_mini_tlb);
+tlb_rehash (dtlb, &dtlb_h);
+tlb_inval (&d_mini_tlb);
+return;
 }
 
 /* ITLB reset */
@@ -499,6 +660,7 @@ for (i = 0; i < ITLB_SIZE; i++) {
     itlb[i].gh_mask = 0;
     itlb[i].idx = i;
     }
+tlb_hash_clr (&itlb_h);
 tlb_inval (&i_mini_tlb);
 return SCPE_OK;
 }
@@ -517,6 +679,7 @@ for (i = 0; i < DTLB_SIZE; i++) {
     dtlb[i].gh_mask = 0;
     dtlb[i].idx = i;
     }
+tlb_hash_clr (&dtlb_h);
 tlb_inval (&d_mini_tlb);
 return SCPE_OK;
 }
@@ -86,19 +86,65 @@
 
 #define CARD_EOF          0x1000         /* This card is end of file card. */
 #define CARD_ERR          0x2000         /* Return error for this card */
-#define DECK_SIZE         1000           /* Number of cards to allocate at a time */
+#define CARD_RING         64             /* Number of cards decoded ahead of reader */
+#define CARD_SIZE         80             /* Assumed bytes per card before any are read */
+#define CARD_FLAGS        (UNIT_CARD_MODE|MODE_LOWER|MODE_CHAR) /* Deck format flags */
 
+/*
+ * The input hopper is a list of decks, each remembered by file name, format
+ * and size when attached. Cards are decoded from the deck being read only as
+ * they are needed, into a small ring which the reader takes cards from. Only
+ * the file of the deck being read is open. The ring is kept full so that the
+ * next card can be checked for EOF, and the count of cards in the hopper is
+ * the number in the ring plus an estimate for the bytes not yet decoded,
+ * based on the average size of the cards decoded so far. uptr->pos is the
+ * number of cards read since the hopper was loaded, moving it backwards
+ * restarts the hopper from the first deck.
+ */
+
+struct card_deck
+{
+    struct card_deck   *next;            /* Next deck in hopper */
+    char               *name;            /* Name of deck file */
+    uint32              flags;           /* Format flags when stacked */
+    int                 eof;             /* Add EOF card after deck */
+    t_addr              cards;           /* Cards in deck, counted at attach */
+    int                 last_eof;        /* Last card in deck is EOF card */
+};
+
+struct _card_buffer {
+   uint8                 buffer[8192+500];    /* Buffer data */
+   int                   len;                 /* Amount of data in buffer */
+   int                   size;                /* Size of last card read */
+};
 
 struct card_context
 {
     t_addr              punch_count;     /* Number of cards punched */
     char                cbuff[1024];     /* Read in buffer for cards */
     uint8               hol_to_ascii[4096]; /* Back conversion table */
-    t_addr              hopper_size;     /* Size of hopper */
-    t_addr              hopper_cards;    /* Number of cards in hopper */
-    uint16              (*images)[1][80];
+    t_addr              hopper_cards;    /* Number of cards taken from hopper */
+    struct card_deck   *decks;           /* Decks in hopper */
+    struct card_deck   *deck;            /* Deck being read */
+    FILE               *deck_file;       /* File of deck being read, opened */
+                                         /* when the hopper reaches it */
+    int                 deck_open;       /* Deck being read is started */
+    int                 deck_eof;        /* EOF card of deck still to come */
+    t_addr              deck_cards;      /* Cards decoded from deck */
+    struct _card_buffer buf;             /* Buffer for deck being read */
+    uint16              ring[CARD_RING][80]; /* Decoded cards */
+    int                 ring_head;       /* Next card to be read */
+    int                 ring_count;      /* Decoded cards not yet read */
 };
 
+t_stat          _sim_parse_card(uint32 flags, DEVICE *dptr, struct _card_buffer *buf, uint16 (*image)[80]);
+static int      _sim_card_fill(UNIT *uptr, struct card_context *data);
+static void     _sim_card_sync(UNIT *uptr, struct card_context *data);
+static void     _sim_card_rewind(struct card_context *data);
+static void     _sim_card_free_decks(struct card_context *data);
+static t_addr   _sim_card_pending(struct card_context *data);
+static t_stat   _sim_card_count(DEVICE *dptr, struct card_deck *deck, FILE *file);
+
 /* Character conversion tables */
 
 const char          sim_six_to_ascii[64] = {
@@ -543,7 +589,8 @@ sim_hopper_size(UNIT * uptr) {
     struct card_context  *data = (struct card_context *)uptr->card_ctx;
     if (data == NULL)
         return 0;
-    return data->hopper_cards;
+    _sim_card_sync(uptr, data);
+    return data->hopper_cards + data->ring_count + _sim_card_pending(data);
 }
 
 t_addr
@@ -557,17 +604,38 @@ sim_punch_count(UNIT * uptr) {
 t_addr
 sim_card_input_hopper_count(UNIT *uptr) {
     struct card_context  *data = (struct card_context *)uptr->card_ctx;
+    struct card_deck     *deck;
     uint16                col;
+    t_addr                cards;
+    t_addr                pending;
+    int                   last_eof;
 
-    if (data == NULL || data->images == NULL)
+    if (data == NULL || data->decks == NULL)
         return 0;           /* attached? */
 
-    if (uptr->pos >= data->hopper_cards)
+    _sim_card_sync(uptr, data);
+    if (data->hopper_cards < uptr->pos)
         return 0;
 
-    col = (*data->images)[data->hopper_cards-1][0];
+    pending = _sim_card_pending(data);
+    cards = data->ring_count + pending;
+    if (cards == 0)
+        return 0;
 
-    return (int)((data->hopper_cards - uptr->pos) - ((col & CARD_EOF) ? 1 : 0));
+    /* Don't count a final EOF card, pending decks have been counted */
+    for (deck = data->deck; deck != NULL && deck->next != NULL; deck = deck->next) ;
+    if (deck != NULL && (deck != data->deck || !data->deck_open)) {
+        last_eof = deck->eof || deck->last_eof;
+    } else if (deck != NULL && data->deck_eof) {
+        last_eof = 1;
+    } else if (deck != NULL && data->deck_file != NULL &&
+               data->deck_cards < deck->cards) {
+        last_eof = deck->last_eof;
+    } else {
+        col = data->ring[(data->ring_head + data->ring_count - 1) % CARD_RING][0];
+        last_eof = (col & CARD_EOF) != 0;
+    }
+    return cards - (last_eof ? 1 : 0);
 }
 
 t_addr
@@ -592,11 +660,12 @@ sim_read_card(UNIT * uptr, uint16 image[80])
 
     if (data == NULL || (uptr->flags & UNIT_ATT) == 0)
         return CDSE_EMPTY;      /* attached? */
-    if (data->hopper_cards == 0 || uptr->pos >= data->hopper_cards)
+    _sim_card_sync(uptr, data);
+    if (data->ring_count == 0)
         return CDSE_EMPTY;
 
     dptr = find_dev_from_unit( uptr);
-    img = &(*data->images)[uptr->pos];
+    img = &data->ring[data->ring_head];
     if (sim_deb && dptr && ((dptr)->dctrl & DEBUG_CARD)) {
          if (image[0] & CARD_EOF) {
              sim_debug(DEBUG_CARD, dptr, "Read hopper EOF\n");
@@ -630,6 +699,9 @@ sim_read_card(UNIT * uptr, uint16 image[80])
     data->punch_count++;
     memcpy(image, img, 80 * sizeof(uint16));
     image[0] &= 0xfff;          /* Remove any CARD_EOF and CARD_ERR Flags */
+    data->ring_head = (data->ring_head + 1) % CARD_RING;
+    data->ring_count--;
+    data->hopper_cards++;
     return r;
 }
 
@@ -642,13 +714,14 @@ sim_card_eof(UNIT *uptr)
     struct card_context  *data = (struct card_context *)uptr->card_ctx;
     uint16                col;
 
-    if (data == NULL || data->images == NULL)
+    if (data == NULL || data->decks == NULL)
         return SCPE_UNATT;      /* attached? */
 
-    if (uptr->pos >= data->hopper_cards)
+    _sim_card_sync(uptr, data);
+    if (data->ring_count == 0)
         return SCPE_UNATT;
 
-    col = (*data->images)[uptr->pos][0];
+    col = data->ring[data->ring_head][0];
 
     if (col & CARD_EOF)
         return 1;
@@ -656,13 +729,6 @@ sim_card_eof(UNIT *uptr)
 }
 
 
-
-struct _card_buffer {
-   uint8                 buffer[8192+500];    /* Buffer data */
-   int                   len;                 /* Amount of data in buffer */
-   int                   size;                /* Size of last card read */
-};
-
 static int _cmpcard(const uint8 *p, const char *s) {
    int  i;
    if (p[0] != '~')
@@ -675,7 +741,7 @@ static int _cmpcard(const uint8 *p, const char *s) {
 }
 
 t_stat
-_sim_parse_card(UNIT *uptr, DEVICE *dptr, struct _card_buffer *buf, uint16 (*image)[80]) {
+_sim_parse_card(uint32 flags, DEVICE *dptr, struct _card_buffer *buf, uint16 (*image)[80]) {
     unsigned int          mode;
     uint16                temp;
     int                   i;
@@ -683,7 +749,7 @@ _sim_parse_card(UNIT *uptr, DEVICE *dptr, struct _card_buffer *buf, uint16 (*ima
     int                   col;
 
     sim_debug(DEBUG_CARD, dptr, "Read card ");
-    if ((uptr->flags & UNIT_CARD_MODE) == MODE_AUTO) {
+    if ((flags & UNIT_CARD_MODE) == MODE_AUTO) {
         mode = MODE_TEXT;   /* Default is text */
 
         /* Check buffer to see if binary card in it. */
@@ -720,14 +786,14 @@ _sim_parse_card(UNIT *uptr, DEVICE *dptr, struct _card_buffer *buf, uint16 (*ima
         }
 
         /* Check if modes match */
-        if ((uptr->flags & UNIT_CARD_MODE) != MODE_AUTO &&
-            (uptr->flags & UNIT_CARD_MODE) != mode) {
+        if ((flags & UNIT_CARD_MODE) != MODE_AUTO &&
+            (flags & UNIT_CARD_MODE) != mode) {
             (*image)[0] = CARD_ERR;
             sim_debug(DEBUG_CARD, dptr, "invalid mode\n");
             return SCPE_OPENERR;
         }
     } else
-        mode = uptr->flags & UNIT_CARD_MODE;
+        mode = flags & UNIT_CARD_MODE;
 
     switch(mode) {
     default:
@@ -805,9 +871,9 @@ _sim_parse_card(UNIT *uptr, DEVICE *dptr, struct _card_buffer *buf, uint16 (*ima
                     break;
                 default:
                     sim_debug(DEBUG_CARD, dptr, "%c", c);
-                    if ((uptr->flags & MODE_LOWER) == 0)
+                    if ((flags & MODE_LOWER) == 0)
                         c = toupper(c);
-                    switch(uptr->flags & MODE_CHAR) {
+                    switch(flags & MODE_CHAR) {
                     default:
                     case MODE_026:
                            temp = ascii_to_hol_026[(int)c];
@@ -954,87 +1020,188 @@ _sim_parse_card(UNIT *uptr, DEVICE *dptr, struct _card_buffer *buf, uint16 (*ima
     return SCPE_OK;
 }
 
-t_stat
-_sim_read_deck(UNIT * uptr, int eof)
+/*
+ * Restart the hopper at the first deck.
+ */
+static void
+_sim_card_rewind(struct card_context *data)
 {
-    struct _card_buffer   buf;
-    struct card_context  *data;
-    DEVICE               *dptr;
-    int                   i;
-    int                   j;
-    int                   l;
-    int                   cards = 0;
-    t_stat                r = SCPE_OK;
+    if (data->deck_file != NULL)
+        fclose(data->deck_file);
+    data->deck_file = NULL;
+    data->deck = data->decks;
+    data->deck_open = 0;
+    data->ring_head = 0;
+    data->ring_count = 0;
+    data->hopper_cards = 0;
+}
 
-    if ((uptr->flags & UNIT_ATT) == 0)
-        return SCPE_UNATT;      /* attached? */
+/*
+ * Empty the hopper.
+ */
+static void
+_sim_card_free_decks(struct card_context *data)
+{
+    struct card_deck     *deck;
 
-    dptr = find_dev_from_unit( uptr);
-    data = (struct card_context *)uptr->card_ctx;
+    while ((deck = data->decks) != NULL) {
+        data->decks = deck->next;
+        free(deck->name);
+        free(deck);
+    }
+    _sim_card_rewind(data);
+}
 
-    buf.len = 0;
-    buf.size = 0;
-    buf.buffer[0] = 0; /* Initialize bufer to empty */
+/*
+ * Decode the next card in the hopper into the ring.
+ * Returns 1 if a card was added, 0 if the hopper is empty.
+ */
+static int
+_sim_card_fill(UNIT *uptr, struct card_context *data)
+{
+    struct _card_buffer  *buf = &data->buf;
+    struct card_deck     *deck;
+    uint16              (*img)[80];
+    int                   i, j, l;
+
+    while ((deck = data->deck) != NULL) {
+        /* Start reading the deck */
+        if (!data->deck_open) {
+            data->deck_file = sim_fopen(deck->name, "rb");
+            if (data->deck_file == NULL) {
+                sim_printf("%s: %s Error (%s) opening deck, deck skipped\n",
+                       sim_uname(uptr), deck->name, strerror(errno));
+            }
+            data->deck_open = 1;
+            data->deck_eof = deck->eof;
+            data->deck_cards = 0;
+            buf->len = 0;
+            buf->size = 0;
+            buf->buffer[0] = 0; /* Initialize bufer to empty */
+        }
 
-    /* Slurp up current file */
-    do {
-        if (buf.len < 500 && !feof(uptr->fileref)) {
-            l = sim_fread(&buf.buffer[buf.len], 1, 8192, uptr->fileref);
-            if (l < 0)
-                r = SCPE_OPENERR;
-            else
-                buf.len += l;
+        if (data->deck_file != NULL && buf->len < 500 && !feof(data->deck_file)) {
+            l = sim_fread(&buf->buffer[buf->len], 1, 8192, data->deck_file);
+            if (l > 0)
+                buf->len += l;
         }
 
-        /* Allocate space for some more cards if needed */
-        if (data->hopper_cards >= data->hopper_size) {
-            data->hopper_size += DECK_SIZE;
-            data->images = (uint16 (*)[1][80])realloc(data->images,
-                       (size_t)data->hopper_size * sizeof(*(data->images)));
-            memset(&data->images[data->hopper_cards], 0,
-                       (size_t)(data->hopper_size - data->hopper_cards) *
-                             sizeof(*(data->images)));
+        img = &data->ring[(data->ring_head + data->ring_count) % CARD_RING];
+
+        /* Process one card, a deck always has at least one */
+        if (data->deck_file != NULL && (buf->len > 0 || data->deck_cards == 0)) {
+            memset(img, 0, sizeof(*img));
+            if (_sim_parse_card(deck->flags, find_dev_from_unit(uptr), buf, img)
+                    != SCPE_OK) {
+                buf->size = buf->len;       /* Drop rest of deck */
+                fclose(data->deck_file);
+                data->deck_file = NULL;
+            }
+            data->ring_count++;
+            data->deck_cards++;
+            /* Move data to start at begining of buffer */
+            /* Data is moved down to simplify the decoding of one card */
+            l = buf->len - buf->size;
+            j = buf->size;
+            for(i = 0; i < l; i++, j++)
+                buf->buffer[i] = buf->buffer[j];
+            buf->len -= buf->size;
+            return 1;
         }
 
-        /* Process one card */
-        cards++;
-        if (_sim_parse_card(uptr, dptr, &buf, &(*data->images)[data->hopper_cards])
-                != SCPE_OK) {
-            r = sim_messagef(SCPE_OPENERR, "%s: %s Error (%s) in card %d\n",
-                   sim_uname(uptr), uptr->filename, sim_error_text(r), cards);
+        /* Create empty card */
+        if (data->deck_eof) {
+            memset(img, 0, sizeof(*img));
+            (*img)[0] = CARD_EOF;
+            data->ring_count++;
+            data->deck_eof = 0;
+            return 1;
         }
+
+        /* Move on to next deck */
+        if (data->deck_file != NULL)
+            fclose(data->deck_file);
+        data->deck_file = NULL;
+        data->deck_open = 0;
+        data->deck = deck->next;
+    }
+    return 0;
+}
+
+/*
+ * Bring the hopper into step with the number of cards read and
+ * fill the ring.
+ */
+static void
+_sim_card_sync(UNIT *uptr, struct card_context *data)
+{
+    if (uptr->pos < data->hopper_cards)
+        _sim_card_rewind(data);
+    while (data->hopper_cards < uptr->pos) {
+        if (data->ring_count == 0 && !_sim_card_fill(uptr, data))
+            break;
+        data->ring_head = (data->ring_head + 1) % CARD_RING;
+        data->ring_count--;
         data->hopper_cards++;
-        /* Move data to start at begining of buffer */
-        /* Data is moved down to simplify the decoding of one card */
-        l = buf.len - buf.size;
-        j = buf.size;
-        for(i = 0; i < l; i++, j++)
-            buf.buffer[i] = buf.buffer[j];
-        buf.len -= buf.size;
-    } while (buf.len > 0 && r == SCPE_OK);
+    }
+    while (data->ring_count < CARD_RING && _sim_card_fill(uptr, data))
+        ;
+}
 
-    /* If there is an error, free just read deck */
-    if (r == SCPE_OK) {
-       if (eof) {
-          /* Allocate space for some more cards if needed */
-          if (data->hopper_cards >= data->hopper_size) {
-              data->hopper_size += DECK_SIZE;
-              data->images = (uint16 (*)[1][80])realloc(data->images,
-                         (size_t)data->hopper_size * sizeof(*(data->images)));
-              memset(&data->images[data->hopper_cards], 0,
-                         (size_t)(data->hopper_size - data->hopper_cards) *
-                               sizeof(*(data->images)));
-          }
-
-          /* Create empty card */
-          (*data->images)[data->hopper_cards][0] = CARD_EOF;
-          data->hopper_cards++;
-       }
+/*
+ * Count the cards in the hopper not yet decoded.
+ */
+static t_addr
+_sim_card_pending(struct card_context *data)
+{
+    struct card_deck     *deck;
+    t_addr                cards = 0;
+
+    for (deck = data->deck; deck != NULL; deck = deck->next) {
+        if (deck == data->deck && data->deck_open) {
+            cards += data->deck_eof;
+            if (data->deck_file != NULL && data->deck_cards < deck->cards)
+                cards += deck->cards - data->deck_cards;
+        } else
+            cards += deck->eof + deck->cards;
     }
+    return cards;
+}
+
+/*
+ * Count the cards in a deck file, decoding it the same way
+ * _sim_card_fill does but keeping no images.  On a bad card the
+ * number of that card is left in the deck and an error returned.
+ */
+static t_stat
+_sim_card_count(DEVICE *dptr, struct card_deck *deck, FILE *file)
+{
+    struct _card_buffer   buf;
+    uint16                image[80];
+    t_stat                r = SCPE_OK;
+    int                   l;
+
+    deck->cards = 0;
+    buf.len = 0;
+    buf.size = 0;
+    buf.buffer[0] = 0;
+    do {
+        if (buf.len < 500 && !feof(file)) {
+            l = sim_fread(&buf.buffer[buf.len], 1, 8192, file);
+            if (l > 0)
+                buf.len += l;
+        }
+        deck->cards++;
+        memset(image, 0, sizeof(image));
+        r = _sim_parse_card(deck->flags, dptr, &buf, &image);
+        deck->last_eof = (image[0] & CARD_EOF) != 0;
+        if (buf.len > buf.size)
+            memmove(&buf.buffer[0], &buf.buffer[buf.size], buf.len - buf.size);
+        buf.len -= buf.size;
+    } while (buf.len > 0 && r == SCPE_OK);
     return r;
 }
 
-
 /* Card punch routine
 
    Modifiers have been checked by the caller
@@ -1336,23 +1503,45 @@ sim_card_attach(UNIT * uptr, CONST char *cptr)
     }
 
     if (uptr->flags & UNIT_RO) {            /* Card Reader? */
-        t_addr  previous_cards = data->hopper_cards;
+        struct card_deck  *deck, **last;
 
         /* Check if we should append to end of existing */
         if ((sim_switches & SWMASK ('S')) == 0) {
-           previous_cards = 0;
-           data->hopper_cards = 0;
-           data->hopper_size = 0;
+           _sim_card_free_decks(data);
            data->punch_count = 0;
-           free(data->images);
-           data->images = NULL;
            free(saved_filename);
            saved_filename = NULL;
            saved_pos = 0;
         }
 
-        /* Go read the deck */
-        r = _sim_read_deck(uptr, eof);
+        /* Stack the deck, cards are read from it as needed */
+        deck = (struct card_deck *)calloc(1, sizeof(struct card_deck));
+        if (deck != NULL)
+            deck->name = (char *)malloc(strlen(cptr) + 1);
+        if (deck == NULL || deck->name == NULL) {
+            free(deck);
+            r = SCPE_MEM;
+        } else {
+            strcpy(deck->name, cptr);
+            deck->flags = uptr->flags & CARD_FLAGS;
+            deck->eof = eof;
+            /* Count the cards, they are decoded again as they are read */
+            if (_sim_card_count(find_dev_from_unit(uptr), deck, uptr->fileref)
+                    != SCPE_OK)
+                r = sim_messagef(SCPE_OPENERR, "%s: %s Error (%s) in card %" T_ADDR_FMT "u\n",
+                       sim_uname(uptr), cptr, sim_error_text(SCPE_OPENERR), deck->cards);
+            if (r != SCPE_OK) {
+                free(deck->name);
+                free(deck);
+                deck = NULL;
+            }
+        }
+        if (deck != NULL) {
+            for (last = &data->decks; *last != NULL; last = &(*last)->next) ;
+            *last = deck;
+            if (data->deck == NULL && !data->deck_open)
+                data->deck = deck;  /* Hopper had run out */
+        }
         uptr->pos = saved_pos;
         detach_unit(uptr);
         if (was_attached) {
@@ -1379,8 +1568,8 @@ sim_card_attach(UNIT * uptr, CONST char *cptr)
                 uptr->filename = (char *)malloc (32 + strlen (cptr));
                 sprintf (uptr->filename, "%s-F %s %s", (eof)?"-E ": "", fmt, cptr);
             }
-            r = sim_messagef(SCPE_OK, "%s: %d card Deck Loaded from %s\n",
-                       sim_uname(uptr), (int)(data->hopper_cards - previous_cards), cptr);
+            r = sim_messagef(SCPE_OK, "%s: %" T_ADDR_FMT "u card Deck Loaded from %s\n",
+                       sim_uname(uptr), deck->cards + deck->eof, cptr);
         } else {
             if (uptr->dynflags & UNIT_ATTMULT)
                 uptr->flags |= UNIT_ATT;
@@ -1399,7 +1588,7 @@ sim_card_detach(UNIT * uptr)
     if (uptr->card_ctx != 0) {
         struct card_context * data = (struct card_context *)uptr->card_ctx;
         /* No clear any existing decks on stack */
-        free(data->images);
+        _sim_card_free_decks(data);
         free(uptr->card_ctx);
         uptr->card_ctx = 0;
     }
@@ -39,6 +39,7 @@
 
    sim_finit            initialize package
    sim_fopen            open file
+   sim_buf_swap_data    swap a buffer of items between host and file order
    sim_fread            endian independent read (formerly fxread)
    sim_write            endian independent write (formerly fxwrite)
    sim_fseek            (now a macro using fseeko)
@@ -74,6 +75,8 @@ t_bool sim_toffset_64;              /* large file (>2GB) support available */
    are size char, then the calls are passed directly to fread or
    fwrite.  Otherwise, these routines perform the necessary byte swaps.
    Sim_fread swaps in place, sim_fwrite uses an intermediate buffer.
+   Sim_buf_swap_data performs the in-place swap for callers that do
+   their own buffering.
 */
 
 int32 sim_finit (void)
@@ -87,18 +90,15 @@ sim_taddr_64 = sim_toffset_64 && (sizeof(t_addr) > sizeof(int32));
 return sim_end;
 }
 
-size_t sim_fread (void *bptr, size_t size, size_t count, FILE *fptr)
+void sim_buf_swap_data (void *bptr, size_t size, size_t count)
 {
-size_t c, j;
+size_t j;
 int32 k;
 unsigned char by, *sptr, *dptr;
 
-if ((size == 0) || (count == 0))                        /* check arguments */
-    return 0;
-c = fread (bptr, size, count, fptr);                    /* read buffer */
-if (sim_end || (size == sizeof (char)) || (c == 0))     /* le, byte, or err? */
-    return c;                                           /* done */
-for (j = 0, dptr = sptr = (unsigned char *) bptr; j < c; j++) { /* loop on items */
+if (sim_end || (size == sizeof (char)))                 /* le or byte? */
+    return;                                             /* nothing to do */
+for (j = 0, dptr = sptr = (unsigned char *) bptr; j < count; j++) { /* loop on items */
     for (k = size - 1; k >= (((int32) size + 1) / 2); k--) {
         by = *sptr;                                     /* swap end-for-end */
         *sptr++ = *(dptr + k);
@@ -106,6 +106,18 @@ for (j = 0, dptr = sptr = (unsigned char *) bptr; j < c; j++) { /* loop on items
         }
     sptr = dptr = dptr + size;                          /* next item */
     }
+}
+
+size_t sim_fread (void *bptr, size_t size, size_t count, FILE *fptr)
+{
+size_t c;
+
+if ((size == 0) || (count == 0))                        /* check arguments */
+    return 0;
+c = fread (bptr, size, count, fptr);                    /* read buffer */
+if (sim_end || (size == sizeof (char)) || (c == 0))     /* le, byte, or err? */
+    return c;                                           /* done */
+sim_buf_swap_data (bptr, size, c);                      /* swap items to host order */
 return c;
 }
 
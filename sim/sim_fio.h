@@ -63,6 +63,7 @@ typedef int32          t_offset;
 int32 sim_finit (void);
 FILE *sim_fopen (const char *file, const char *mode);
 int sim_fseeko (FILE *st, t_offset offset, int whence);
+void sim_buf_swap_data (void *bptr, size_t size, size_t count);
 size_t sim_fread (void *bptr, size_t size, size_t count, FILE *fptr);
 size_t sim_fwrite (void *bptr, size_t size, size_t count, FILE *fptr);
 t_offset sim_ftell (FILE *st);
@@ -32,6 +32,26 @@
    sim_shmem_close          close a shared memory region
    sim_shmem_atomic_add     interlocked add to an atomic variable
    sim_shmem_atomic_cas     interlocked compare and swap to an atomic variable
+   sim_shmem_doorbell_ring  signal processes waiting on a doorbell variable
+   sim_shmem_doorbell_wait  wait for a doorbell variable to be signalled
+   sim_ram_alloc            allocate zeroed, lazily committed memory
+   sim_ram_resize           grow or shrink memory from sim_ram_alloc
+
+   A doorbell is an int32 in shared memory that is incremented each time it
+   is rung. A process waits for a doorbell by passing the last value it saw;
+   the wait returns TRUE as soon as the value differs, or FALSE when the
+   timeout expires. On Linux, the wait blocks on a futex; elsewhere, it
+   rechecks the doorbell every millisecond.
+
+   The sim_ram routines hold a simulator's main memory. sim_ram_alloc
+   reserves address space for the largest size the memory can grow to,
+   but host pages are only committed as the simulator touches them, and
+   Linux is asked to back the region with huge pages. sim_ram_resize
+   grows or shrinks the memory in place, releasing any pages beyond a
+   reduced size; memory added by growing reads as zero. Where address
+   space can't be reserved, the routines fall back to calloc and realloc.
+   Like the calloc'd memory it replaces, the region lives until the
+   simulator exits; there is no call to release it.
 */
 
 #include "sim_defs.h"
@@ -122,11 +142,29 @@ t_bool sim_shmem_atomic_cas (int32 *ptr, int32 oldv, int32 newv)
 return (InterlockedCompareExchange ((LONG volatile *) ptr, newv, oldv) == oldv);
 }
 
+void sim_shmem_doorbell_ring (int32 *ptr)
+{
+InterlockedIncrement ((LONG volatile *) ptr);
+}
+
+t_bool sim_shmem_doorbell_wait (int32 *ptr, int32 val, uint32 msec)
+{
+while ((*((volatile int32 *) ptr) == val) && (msec-- != 0))
+    Sleep (1);
+return (*((volatile int32 *) ptr) != val);
+}
+
 #elif defined (__linux__) || defined (__APPLE__) || defined (__CYGWIN__) || defined (__FreeBSD__)
 #include <unistd.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <sys/mman.h>
+#if defined (__linux__)
+#include <limits.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
 
 struct SHMEM {
     int shm_fd;
@@ -238,6 +276,31 @@ else
 #endif
 }
 
+void sim_shmem_doorbell_ring (int32 *ptr)
+{
+sim_shmem_atomic_add (ptr, 1);
+#if defined (__linux__) && defined (SYS_futex)
+syscall (SYS_futex, ptr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+t_bool sim_shmem_doorbell_wait (int32 *ptr, int32 val, uint32 msec)
+{
+#if defined (__linux__) && defined (SYS_futex)
+struct timespec ts;
+
+if (*((volatile int32 *) ptr) == val) {
+    ts.tv_sec = msec / 1000;
+    ts.tv_nsec = (msec % 1000) * 1000000;
+    syscall (SYS_futex, ptr, FUTEX_WAIT, val, &ts, NULL, 0);
+    }
+#else
+while ((*((volatile int32 *) ptr) == val) && (msec-- != 0))
+    usleep (1000);
+#endif
+return (*((volatile int32 *) ptr) != val);
+}
+
 #else
 
 t_stat sim_shmem_open (const char *name, size_t size, SHMEM **shmem, void **addr)
@@ -258,4 +321,143 @@ t_bool sim_shmem_atomic_cas (int32 *ptr, int32 oldv, int32 newv)
 {
 return FALSE;
 }
+
+void sim_shmem_doorbell_ring (int32 *ptr)
+{
+}
+
+t_bool sim_shmem_doorbell_wait (int32 *ptr, int32 val, uint32 msec)
+{
+return FALSE;
+}
+#endif
+
+/* Simulator main memory */
+
+#if !defined (_WIN32) && (defined (__linux__) || defined (__APPLE__) || defined (__CYGWIN__) || defined (__FreeBSD__))
+#define SIM_RAM_MMAP    1
+#include <unistd.h>
+#include <sys/mman.h>
+#if !defined (MAP_ANONYMOUS)
+#define MAP_ANONYMOUS   MAP_ANON
+#endif
+#if !defined (MAP_NORESERVE)
+#define MAP_NORESERVE   0
+#endif
+#else
+#define SIM_RAM_MMAP    0
+#endif
+
+struct SIMRAM {
+    void *ram_base;
+    size_t ram_size;                    /* current size */
+    size_t ram_max;                     /* reserved size, if mapped */
+    t_bool ram_mapped;                  /* address space reserved? */
+    };
+
+static size_t sim_ram_pagesize (void)
+{
+#if defined (_WIN32)
+SYSTEM_INFO SysInfo;
+
+GetSystemInfo (&SysInfo);
+return (size_t) SysInfo.dwPageSize;
+#elif SIM_RAM_MMAP
+return (size_t) sysconf (_SC_PAGESIZE);
+#else
+return 1;
+#endif
+}
+
+t_stat sim_ram_alloc (size_t size, size_t max, SIMRAM **ram, void **addr)
+{
+void *base = NULL;
+
+*addr = NULL;
+if (max < size)
+    max = size;
+*ram = (SIMRAM *)calloc (1, sizeof(**ram));
+if (*ram == NULL)
+    return SCPE_MEM;
+#if defined (_WIN32)
+base = VirtualAlloc (NULL, max, MEM_RESERVE, PAGE_NOACCESS);
+if ((base != NULL) &&
+    (VirtualAlloc (base, size, MEM_COMMIT, PAGE_READWRITE) == NULL)) {
+    VirtualFree (base, 0, MEM_RELEASE);
+    base = NULL;
+    }
+#elif SIM_RAM_MMAP
+base = mmap (NULL, max, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+if (base == MAP_FAILED)
+    base = NULL;
+#if defined (MADV_HUGEPAGE)
+else
+    madvise (base, max, MADV_HUGEPAGE);
+#endif
+#endif
+if (base != NULL) {                     /* reserved? */
+    (*ram)->ram_mapped = TRUE;
+    (*ram)->ram_max = max;
+    }
+else {                                  /* no, use the heap */
+    base = calloc (size, 1);
+    if (base == NULL) {
+        free (*ram);
+        *ram = NULL;
+        return SCPE_MEM;
+        }
+    }
+(*ram)->ram_base = base;
+(*ram)->ram_size = size;
+*addr = base;
+return SCPE_OK;
+}
+
+t_stat sim_ram_resize (SIMRAM *ram, size_t size, void **addr)
+{
+char *base = (char *) ram->ram_base;
+size_t pgsz, rel;
+void *nbase;
+
+if (ram->ram_mapped && (size <= ram->ram_max)) {        /* in place? */
+    if (size < ram->ram_size) {                         /* shrink */
+        pgsz = sim_ram_pagesize ();
+        rel = ((size + pgsz - 1) / pgsz) * pgsz;        /* 1st whole page */
+        if (rel > ram->ram_size)
+            rel = ram->ram_size;
+        memset (base + size, 0, rel - size);            /* clear partial page */
+        if (rel < ram->ram_size) {                      /* release the rest */
+#if defined (_WIN32)
+            VirtualFree (base + rel, ram->ram_size - rel, MEM_DECOMMIT);
+#elif SIM_RAM_MMAP
+            madvise (base + rel, ram->ram_size - rel, MADV_DONTNEED);
 #endif
+            }
+        }
+#if defined (_WIN32)
+    else if (VirtualAlloc (base, size, MEM_COMMIT, PAGE_READWRITE) == NULL)
+        return SCPE_MEM;
+#endif
+    ram->ram_size = size;
+    *addr = base;
+    return SCPE_OK;
+    }
+nbase = calloc (size, 1);                               /* move to the heap */
+if (nbase == NULL)
+    return SCPE_MEM;
+memcpy (nbase, base, (size < ram->ram_size)? size: ram->ram_size);
+if (ram->ram_mapped) {
+#if defined (_WIN32)
+    VirtualFree (base, 0, MEM_RELEASE);
+#elif SIM_RAM_MMAP
+    munmap (base, ram->ram_max);
+#endif
+    }
+else free (base);
+ram->ram_mapped = FALSE;
+ram->ram_base = nbase;
+ram->ram_size = size;
+*addr = nbase;
+return SCPE_OK;
+}
@@ -31,5 +31,11 @@ t_stat sim_shmem_open (const char *name, size_t size, SHMEM **shmem, void **addr
 void sim_shmem_close (SHMEM *shmem);
 int32 sim_shmem_atomic_add (int32 *ptr, int32 val);
 t_bool sim_shmem_atomic_cas (int32 *ptr, int32 oldv, int32 newv);
+void sim_shmem_doorbell_ring (int32 *ptr);
+t_bool sim_shmem_doorbell_wait (int32 *ptr, int32 val, uint32 msec);
+
+typedef struct SIMRAM SIMRAM;
+t_stat sim_ram_alloc (size_t size, size_t max, SIMRAM **ram, void **addr);
+t_stat sim_ram_resize (SIMRAM *ram, size_t size, void **addr);
 
 #endif
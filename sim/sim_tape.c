@@ -96,6 +96,10 @@
 #include "sim_defs.h"
 #include "sim_tape.h"
 
+#if defined (HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
 struct sim_tape_fmt {
     char                *name;                          /* name */
     int32               uflags;                         /* unit flags */
@@ -126,6 +130,90 @@ static const uint32 bpi [] = {                          /* tape density table, i
 
 #define BPI_COUNT       (sizeof (bpi) / sizeof (bpi [0]))   /* count of density table entries */
 
+/* Tape unit context.
+
+   A context structure is allocated at attach time for units using the SIMH,
+   extended SIMH, or E11 formats and is hung from the unit's "up8" pointer.  It
+   holds the record index, which maps the tape image from the BOT to the
+   "idx_end" position as a contiguous sequence of objects (data records, tape
+   marks, and private markers).  Each object is described by its starting file
+   position and its leading metadatum.  Reverse motion relies on the trailing
+   record length, so that of each data record is read and compared to the
+   leading length the first time the record is crossed in the reverse direction;
+   a mismatch causes the image to be scanned as before.
+
+   The index is built incrementally as objects are read or spaced over in the
+   forward direction and is extended as objects are written at its end.  Any
+   write within the mapped area trims the index at the write position.  Erase
+   gaps and reserved markers are not indexed, so the index stops growing at the
+   first one encountered; positioning beyond that point is done by scanning the
+   image as before.
+
+   The context also holds a stream buffer through which all image file I/O for
+   the unit passes.  Reads are satisfied from the buffer, which is refilled
+   with an aligned block of the file when a read falls outside of it, so that
+   sequential access in either direction makes one host read per block rather
+   than several per record.  Writes that follow one another in the file are
+   collected in the buffer and are written to the file as a single block when
+   the buffer fills, when a read or a non-contiguous write is requested, or when
+   the tape is rewound, reset, or detached.  A host error encountered while
+   writing the buffer is reported by the next library call that tests for I/O
+   errors.  Transfers larger than the buffer bypass it.
+*/
+
+#define tape_ctx        up8                             /* the unit's tape context pointer */
+
+#define IDX_OPEN        0                               /* the image beyond the index end is unknown */
+#define IDX_EOF         1                               /* the index ends at the physical EOF */
+#define IDX_EOM         2                               /* the index ends at an EOM marker */
+
+#define IDX_CHECKED     0x01                            /* trailing record length verified */
+
+#define IDX_INCR        1024                            /* index allocation increment */
+
+#define TBUF_SIZE       65536                           /* stream buffer size (a power of two) */
+
+#if defined (HAVE_ZLIB)
+
+#define ZBUF_SIZE       65536                           /* compressed input buffer size */
+#define ZPT_SPACING     (1024 * 1024)                   /* seek point spacing in image bytes */
+
+struct tape_zpoint {
+    t_addr              pos;                            /* image position */
+    t_offset            foff;                           /* file offset of the next compressed byte */
+    z_stream            strm;                           /* copy of the decompression state */
+    };
+
+#endif
+
+struct tape_context {
+    t_addr              *idx_pos;                       /* object starting positions */
+    t_mtrlnt            *idx_meta;                      /* object leading metadata */
+    uint8               *idx_flags;                     /* object flags */
+    uint32              idx_count;                      /* count of indexed objects */
+    uint32              idx_size;                       /* allocated index entries */
+    uint32              idx_hint;                       /* entry of the last successful lookup */
+    uint32              idx_state;                      /* state of the image at the index end */
+    t_addr              idx_end;                        /* position following the last object */
+    uint8               *buf;                           /* stream buffer */
+    t_addr              buf_base;                       /* file position of the buffer start */
+    uint32              buf_len;                        /* count of bytes in the buffer */
+    t_bool              buf_dirty;                      /* TRUE = buffer holds unwritten data */
+    t_bool              buf_eof;                        /* TRUE = last read reached the EOF */
+    t_bool              buf_err;                        /* TRUE = host I/O error occurred */
+    t_addr              pos;                            /* current stream position */
+#if defined (HAVE_ZLIB)
+    z_stream            *zs;                            /* decompression stream (NULL if not compressed) */
+    uint8               *zbuf;                          /* compressed input buffer */
+    t_offset            zfoff;                          /* file offset following the compressed input */
+    t_addr              zpos;                           /* image position of the decompression stream */
+    struct tape_zpoint  *zpt;                           /* seek points */
+    uint32              zpt_count;                      /* count of seek points */
+    uint32              zpt_size;                       /* allocated seek points */
+    t_bool              zcompress;                      /* TRUE = compress the image at detach */
+#endif
+    };
+
 static t_stat sim_tape_ioerr (UNIT *uptr);
 static t_stat sim_tape_wrdata (UNIT *uptr, uint32 dat);
 static uint32 sim_tape_tpc_map (UNIT *uptr, t_addr *map);
@@ -134,6 +222,31 @@ static t_stat tape_read      (UNIT *uptr, uint8 *buffer, t_mtrlnt *class_count,
 static t_stat tape_erase     (UNIT *uptr, t_mtrlnt byte_count);
 static t_stat tape_erase_fwd (UNIT *uptr, t_mtrlnt gap_size);
 static t_stat tape_erase_rev (UNIT *uptr, t_mtrlnt gap_size);
+static t_stat tape_index_alloc (UNIT *uptr);
+static void   tape_index_free  (UNIT *uptr);
+static void   tape_index_add   (UNIT *uptr, t_addr pos, t_mtrlnt meta, t_addr next, uint8 flags);
+static void   tape_index_end   (UNIT *uptr, t_addr pos, uint32 state);
+static t_bool tape_index_trim  (UNIT *uptr, t_addr pos);
+static t_bool tape_index_fwd   (UNIT *uptr, uint32 accept, t_mtrlnt *bc, t_stat *status);
+static t_bool tape_index_rev   (UNIT *uptr, uint32 accept, t_mtrlnt *bc, t_stat *status);
+static int    tape_seek        (UNIT *uptr, t_addr pos);
+static size_t tape_fread       (UNIT *uptr, void *bptr, size_t size, size_t count);
+static size_t tape_fwrite      (UNIT *uptr, void *bptr, size_t size, size_t count);
+static t_stat tape_flush       (UNIT *uptr);
+static int    tape_fsize       (UNIT *uptr, uint32 *size);
+static int    tape_ferror      (UNIT *uptr);
+static int    tape_feof        (UNIT *uptr);
+static void   tape_clearerr    (UNIT *uptr);
+static size_t tape_get         (UNIT *uptr, t_addr pos, uint8 *bptr, size_t len);
+
+#if defined (HAVE_ZLIB)
+static t_stat tape_zopen       (UNIT *uptr);
+static void   tape_zclose      (UNIT *uptr);
+static t_bool tape_zpoint_add  (UNIT *uptr);
+static size_t tape_zinflate    (UNIT *uptr, uint8 *bptr, size_t len);
+static size_t tape_zread       (UNIT *uptr, t_addr pos, uint8 *bptr, size_t len);
+static t_stat tape_zcompress   (UNIT *uptr, const char *tname);
+#endif
 
 
 /* Attach tape unit */
@@ -171,6 +284,27 @@ switch (MT_GET_FMT (uptr)) {                            /* case on format */
         sim_tape_tpc_map (uptr, (t_addr *) uptr->filebuf);      /* fill map */
         break;
 
+    case MTUF_F_STD:                                    /* SIMH */
+    case MTUF_F_EXT:                                    /* extended SIMH */
+    case MTUF_F_E11:                                    /* E11 */
+        if (tape_index_alloc (uptr) != SCPE_OK) {       /* context allocated? */
+            sim_tape_detach (uptr);
+            return SCPE_MEM;                            /* no, complain */
+            }
+#if defined (HAVE_ZLIB)
+        r = tape_zopen (uptr);                          /* check for a compressed image */
+        if (r != SCPE_OK) {                             /* unusable? */
+            sim_tape_detach (uptr);
+            return r;                                   /* yes, complain */
+            }
+#else
+        if (sim_switches & SWMASK ('Z')) {              /* compression requested? */
+            sim_tape_detach (uptr);
+            return SCPE_NOFNC;                          /* not available */
+            }
+#endif
+        break;
+
     default:
         break;
     }
@@ -185,10 +319,36 @@ t_stat sim_tape_detach (UNIT *uptr)
 {
 uint32 f = MT_GET_FMT (uptr);
 t_stat r;
-
+#if defined (HAVE_ZLIB)
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+t_bool zcompress = FALSE;
+char   fname [CBUFSIZE], tname [CBUFSIZE + 4];
+#endif
+
+if (tape_flush (uptr) != SCPE_OK)                       /* write any buffered data; if it fails */
+    sim_tape_ioerr (uptr);                              /*   then report the error */
+#if defined (HAVE_ZLIB)
+if ((ctx != NULL) && ctx->zcompress && (uptr->flags & UNIT_ATT)) {  /* compress at detach? */
+    strncpy (fname, uptr->filename, CBUFSIZE - 1);      /* save the image name */
+    fname [CBUFSIZE - 1] = '\0';
+    sprintf (tname, "%s.tmp", fname);                   /*   and form the temporary name */
+    zcompress = (tape_zcompress (uptr, tname) == SCPE_OK);
+    if (!zcompress)                                     /* compression failed? */
+        sim_printf ("Magtape library: %s not compressed\n", fname);
+    }
+#endif
 r = detach_unit (uptr);                                 /* detach unit */
 if (r != SCPE_OK)
     return r;
+#if defined (HAVE_ZLIB)
+if (zcompress) {                                        /* replace the image */
+    remove (fname);                                     /*   with the compressed copy */
+    if (rename (tname, fname) != 0) {                   /* failed? */
+        sim_printf ("Magtape library: compressed image left in %s\n", tname);
+        r = SCPE_IOERR;
+        }
+    }
+#endif
 switch (f) {                                            /* case on format */
 
     case MTUF_F_TPC:                                    /* TPC */
@@ -199,11 +359,12 @@ switch (f) {                                            /* case on format */
         break;
 
     default:
+        tape_index_free (uptr);                         /* free the context if present */
         break;
         }
 
 sim_tape_rewind (uptr);
-return SCPE_OK;
+return r;
 }
 
 
@@ -365,7 +526,12 @@ MT_CLR_PNU (uptr);                                      /* clear the position-no
 if ((uptr->flags & UNIT_ATT) == 0)                      /* if the unit is not attached */
     return MTSE_UNATT;                                  /*   then quit with an error */
 
-if (sim_fseek (uptr->fileref, uptr->pos, SEEK_SET)) {   /* set the initial tape position; if it fails */
+if (tape_index_fwd (uptr, (f == MTUF_F_EXT              /* if the record index */
+                             ? (uint32) *bc             /*   describes the next acceptable object */
+                             : MTB_STANDARD), bc, &status))
+    return status;                                      /*     then return it without scanning */
+
+if (tape_seek (uptr, uptr->pos)) {                      /* set the initial tape position; if it fails */
     MT_SET_PNU (uptr);                                  /*   then set position not updated */
     status = sim_tape_ioerr (uptr);                     /*     and quit with I/O error status */
     }
@@ -403,10 +569,10 @@ else switch (f) {                                       /* otherwise the read me
                     bufcap = sizeof (buffer)            /*     to the full size of the buffer */
                                / sizeof (buffer [0]);
 
-                bufcap = sim_fread (buffer, sizeof (t_mtrlnt),  /* fill the buffer */
-                                    bufcap, uptr->fileref);     /*   with tape metadata */
+                bufcap = tape_fread (uptr, buffer,              /* fill the buffer */
+                                     sizeof (t_mtrlnt), bufcap);    /*   with tape metadata */
 
-                if (ferror (uptr->fileref)) {           /* if a file I/O error occurred */
+                if (tape_ferror (uptr)) {               /* if a file I/O error occurred */
                     if (bufcntr == 0)                   /*   then if this is the initial read */
                         MT_SET_PNU (uptr);              /*     then set position-not-updated */
 
@@ -419,10 +585,15 @@ else switch (f) {                                       /* otherwise the read me
                     if (bufcntr == 0)                   /*     then if this is the initial read */
                         MT_SET_PNU (uptr);              /*       then set position not updated */
 
-                    if (bufcap == 0)                    /* if an EOM marker was not read */
+                    if (bufcap == 0) {                  /* if an EOM marker was not read */
                         *bc = 0;                        /*   then zero the marker value */
-                    else                                /* otherwise */
+                        tape_index_end (uptr, uptr->pos, IDX_EOF);  /*     and note the EOF in the index */
+                        }
+
+                    else {                              /* otherwise */
                         *bc = MTR_EOM;                  /*   store the EOM value */
+                        tape_index_end (uptr, uptr->pos, IDX_EOM);  /*     and note the EOM in the index */
+                        }
 
                     status = MTSE_EOM;                  /* report the end-of-medium */
                     break;                              /*   and quit */
@@ -435,14 +606,17 @@ else switch (f) {                                       /* otherwise the read me
             *bc = buffer [bufcntr++];                   /* store the metadata marker value */
 
             if (*bc == MTR_EOM) {                       /* if an end-of-medium marker is seen */
-                status = MTSE_EOM;                      /*   then report the end-of-medium */
-                break;                                  /*     and quit */
+                tape_index_end (uptr, uptr->pos, IDX_EOM);  /*   then note it in the index */
+                status = MTSE_EOM;                      /*     and report the end-of-medium */
+                break;                                  /*       and quit */
                 }
 
             uptr->pos = uptr->pos + sizeof (t_mtrlnt);  /* space over the marker */
 
             if (*bc == MTR_TMK) {                       /* if the marker is a tape mark */
-                status = MTSE_TMK;                      /*   then quit with tape mark status */
+                tape_index_add (uptr, uptr->pos - sizeof (t_mtrlnt),    /*   then add it to the index */
+                                *bc, uptr->pos, 0);
+                status = MTSE_TMK;                      /*     and quit with tape mark status */
                 break;
                 }
 
@@ -452,7 +626,7 @@ else switch (f) {                                       /* otherwise the read me
             else if (*bc == MTR_FHGAP) {                        /* otherwise if the marker if a half gap */
                 uptr->pos = uptr->pos - sizeof (t_mtrlnt) / 2;  /*   then back up to resync */
 
-                if (sim_fseek (uptr->fileref, uptr->pos, SEEK_SET)) {   /* set the tape position; if it fails */
+                if (tape_seek (uptr, uptr->pos)) {                      /* set the tape position; if it fails */
                     status = sim_tape_ioerr (uptr);                     /*   then quit with I/O error status */
                     break;
                     }
@@ -474,13 +648,18 @@ else switch (f) {                                       /* otherwise the read me
                     if (classbit == MTB_SMARK)          /*   then if it's a SIMH-reserved marker */
                         status = MTSE_RESERVED;         /*     then return reserved status */
 
-                    else if (classbit == MTB_PMARK)     /*   otherwise if it's a private marker */
-                        status = MTSE_OK;               /*     then return successful status */
+                    else if (classbit == MTB_PMARK) {   /*   otherwise if it's a private marker */
+                        tape_index_add (uptr, uptr->pos - sizeof (t_mtrlnt),    /* then add it to the index */
+                                        *bc, uptr->pos, 0);
+                        status = MTSE_OK;               /*     and return successful status */
+                        }
 
                     else if (bufcntr == bufcap                  /*   otherwise if the record starts after the buffer */
-                      || sim_fseek (uptr->fileref,              /*     or repositioning to the start */
-                                    uptr->pos, SEEK_SET) == 0)  /*       of the data area succeeds */
-                        uptr->pos = next_pos;                   /*         then position past the record */
+                      || tape_seek (uptr, uptr->pos) == 0) {    /*     or repositioning to the start of the data succeeds */
+                        tape_index_add (uptr, uptr->pos - sizeof (t_mtrlnt),    /* then add it to the index */
+                                        *bc, next_pos, 0);
+                        uptr->pos = next_pos;                   /*         and position past the record */
+                        }
 
                     else                                /*   otherwise the seek failed */
                         status = sim_tape_ioerr (uptr); /*     so quit with I/O error status */
@@ -489,9 +668,11 @@ else switch (f) {                                       /* otherwise the read me
                     }
 
                 else if (classbit & MTB_RECORDSET) {    /* otherwise if ignoring a data record */
-                    uptr->pos = next_pos;               /*   then position past the record */
+                    tape_index_add (uptr, uptr->pos - sizeof (t_mtrlnt),    /* then add it to the index */
+                                    *bc, next_pos, 0);
+                    uptr->pos = next_pos;               /*   and position past the record */
 
-                    if (sim_fseek (uptr->fileref, uptr->pos, SEEK_SET)) {   /* set the new position; if it fails */
+                    if (tape_seek (uptr, uptr->pos)) {                      /* set the new position; if it fails */
                         status = sim_tape_ioerr (uptr);                     /*   then quit with I/O error status */
                         break;
                         }
@@ -499,6 +680,10 @@ else switch (f) {                                       /* otherwise the read me
                     bufcntr = bufcap;                   /* mark the buffer as invalid to force a read */
                     }
 
+                else if (classbit == MTB_PMARK)         /* otherwise if ignoring a private marker */
+                    tape_index_add (uptr, uptr->pos - sizeof (t_mtrlnt),    /* then add it to the index */
+                                    *bc, uptr->pos, 0);
+
                 runaway_counter = max_gap;              /* ignoring a marker or record resets the counter */
                 }
             }
@@ -514,14 +699,14 @@ else switch (f) {                                       /* otherwise the read me
 
 
     case MTUF_F_TPC:
-        sim_fread (&tpcbc, sizeof (t_tpclnt), 1, uptr->fileref);
+        tape_fread (uptr, &tpcbc, sizeof (t_tpclnt), 1);
         *bc = tpcbc;                                    /* save rec lnt */
 
-        if (ferror (uptr->fileref)) {                   /* error? */
+        if (tape_ferror (uptr)) {                       /* error? */
             MT_SET_PNU (uptr);                          /* pos not upd */
             status = sim_tape_ioerr (uptr);
             }
-        else if (feof (uptr->fileref)) {                /* eof? */
+        else if (tape_feof (uptr)) {                    /* eof? */
             MT_SET_PNU (uptr);                          /* pos not upd */
             status = MTSE_EOM;
             }
@@ -537,14 +722,14 @@ else switch (f) {                                       /* otherwise the read me
 
     case MTUF_F_P7B:
         for (sbc = 0, all_eof = 1; ; sbc++) {           /* loop thru record */
-            sim_fread (&c, sizeof (uint8), 1, uptr->fileref);
+            tape_fread (uptr, &c, sizeof (uint8), 1);
 
-            if (ferror (uptr->fileref)) {               /* error? */
+            if (tape_ferror (uptr)) {                   /* error? */
                 MT_SET_PNU (uptr);                      /* pos not upd */
                 status = sim_tape_ioerr (uptr);
                 break;
                 }
-            else if (feof (uptr->fileref)) {            /* eof? */
+            else if (tape_feof (uptr)) {                /* eof? */
                 if (sbc == 0)                           /* no data? eom */
                     status = MTSE_EOM;
                 break;                                  /* treat like eor */
@@ -557,7 +742,7 @@ else switch (f) {                                       /* otherwise the read me
 
         if (status == MTSE_OK) {
             *bc = sbc;                                      /* save rec lnt */
-            sim_fseek (uptr->fileref, uptr->pos, SEEK_SET); /* for read */
+            tape_seek (uptr, uptr->pos);                    /* for read */
             uptr->pos = uptr->pos + sbc;                    /* spc over record */
             if (all_eof)                                    /* tape mark? */
                 status = MTSE_TMK;
@@ -682,6 +867,11 @@ if ((uptr->flags & UNIT_ATT) == 0)                      /* if the unit is not at
 else if (sim_tape_bot (uptr))                           /* otherwise if the unit is positioned at the BOT */
     status = MTSE_BOT;                                  /*   then reading backward is not possible */
 
+else if (tape_index_rev (uptr, (f == MTUF_F_EXT         /* otherwise if the record index */
+                                  ? (uint32) *bc        /*   describes the preceding acceptable object */
+                                  : MTB_STANDARD), bc, &status))
+    return status;                                      /*     then return it without scanning */
+
 else switch (f) {                                       /* otherwise the read method depends on the tape format */
 
     case MTUF_F_EXT:
@@ -727,14 +917,13 @@ else switch (f) {                                       /* otherwise the read me
                     bufcap = sizeof (buffer)            /*   to the full size of the buffer */
                                / sizeof (buffer [0]);
 
-                sim_fseek (uptr->fileref,                           /* seek back to the location */
-                           uptr->pos - bufcap * sizeof (t_mtrlnt),  /*   corresponding to the start */
-                           SEEK_SET);                               /*     of the buffer */
+                tape_seek (uptr,                                    /* seek back to the location */
+                           uptr->pos - bufcap * sizeof (t_mtrlnt)); /*   corresponding to the start of the buffer */
 
-                bufcntr = sim_fread (buffer, sizeof (t_mtrlnt), /* fill the buffer */
-                                     bufcap, uptr->fileref);    /*   with tape metadata */
+                bufcntr = tape_fread (uptr, buffer,             /* fill the buffer */
+                                      sizeof (t_mtrlnt), bufcap);   /*   with tape metadata */
 
-                if (ferror (uptr->fileref)) {           /* if a file I/O error occurred */
+                if (tape_ferror (uptr)) {               /* if a file I/O error occurred */
                     if (uptr->pos == ppos)              /*   then if this is the initial read */
                         MT_SET_PNU (uptr);              /*     then set position not updated */
 
@@ -778,9 +967,8 @@ else switch (f) {                                       /* otherwise the read me
                     else if (classbit == MTB_PMARK)     /*   otherwise if it's a private marker */
                         status = MTSE_OK;               /*     then return successful status */
 
-                    else if (sim_fseek (uptr->fileref,                  /*   otherwise position to the start */
-                                        next_pos + sizeof (t_mtrlnt),   /*     of the data area */
-                                        SEEK_SET) == 0)                 /*       and if the seek succeeds */
+                    else if (tape_seek (uptr,                           /*   otherwise position to the start */
+                                        next_pos + sizeof (t_mtrlnt)) == 0) /*     of the data area and if the seek succeeds */
                         uptr->pos = next_pos;                           /*         then position past the record */
 
                     else                                /*   otherwise the seek failed */
@@ -792,7 +980,7 @@ else switch (f) {                                       /* otherwise the read me
                 else if (classbit & MTB_RECORDSET) {    /* otherwise if ignoring a data record */
                     uptr->pos = next_pos;               /*   then position before the record */
 
-                    if (sim_fseek (uptr->fileref, uptr->pos, SEEK_SET)) {   /* set the new position; if it fails */
+                    if (tape_seek (uptr, uptr->pos)) {                      /* set the new position; if it fails */
                         status = sim_tape_ioerr (uptr);                     /*   then quit with I/O error status */
                         break;
                         }
@@ -813,34 +1001,34 @@ else switch (f) {                                       /* otherwise the read me
 
     case MTUF_F_TPC:
         ppos = sim_tape_tpc_fnd (uptr, (t_addr *) uptr->filebuf); /* find prev rec */
-        sim_fseek (uptr->fileref, ppos, SEEK_SET);      /* position */
-        sim_fread (&tpcbc, sizeof (t_tpclnt), 1, uptr->fileref);
+        tape_seek (uptr, ppos);                         /* position */
+        tape_fread (uptr, &tpcbc, sizeof (t_tpclnt), 1);
         *bc = tpcbc;                                    /* save rec lnt */
 
-        if (ferror (uptr->fileref))                     /* error? */
+        if (tape_ferror (uptr))                         /* error? */
             status = sim_tape_ioerr (uptr);
-        else if (feof (uptr->fileref))                  /* eof? */
+        else if (tape_feof (uptr))                      /* eof? */
             status = MTSE_EOM;
         else {
             uptr->pos = ppos;                           /* spc over record */
             if (*bc == MTR_TMK)                         /* tape mark? */
                 status = MTSE_TMK;
             else
-                sim_fseek (uptr->fileref, uptr->pos + sizeof (t_tpclnt), SEEK_SET);
+                tape_seek (uptr, uptr->pos + sizeof (t_tpclnt));
             }
         break;
 
 
     case MTUF_F_P7B:
         for (sbc = 1, all_eof = 1; (t_addr) sbc <= uptr->pos ; sbc++) {
-            sim_fseek (uptr->fileref, uptr->pos - sbc, SEEK_SET);
-            sim_fread (&c, sizeof (uint8), 1, uptr->fileref);
+            tape_seek (uptr, uptr->pos - sbc);
+            tape_fread (uptr, &c, sizeof (uint8), 1);
 
-            if (ferror (uptr->fileref)) {               /* error? */
+            if (tape_ferror (uptr)) {                   /* error? */
                 status = sim_tape_ioerr (uptr);
                 break;
                 }
-            else if (feof (uptr->fileref)) {            /* eof? */
+            else if (tape_feof (uptr)) {                /* eof? */
                 status = MTSE_EOM;
                 break;
                 }
@@ -855,7 +1043,7 @@ else switch (f) {                                       /* otherwise the read me
         if (status == MTSE_OK) {
             uptr->pos = uptr->pos - sbc;                    /* update position */
             *bc = sbc;                                      /* save rec lnt */
-            sim_fseek (uptr->fileref, uptr->pos, SEEK_SET); /* for read */
+            tape_seek (uptr, uptr->pos);                    /* for read */
             if (all_eof)                                    /* tape mark? */
                 status = MTSE_TMK;
             }
@@ -954,12 +1142,12 @@ if (rbc > bufsize)                                      /* if the record won't f
     st = MTSE_INVRL;                                    /*   then return invalid length status */
 
 else {                                                      /* otherwise */
-    sim_fread (buffer, sizeof (uint8), rbc, uptr->fileref); /*   read the data payload into the supplied buffer */
+    tape_fread (uptr, buffer, sizeof (uint8), rbc);         /*   read the data payload into the supplied buffer */
 
-    if (ferror (uptr->fileref))                         /* if a host I/O error occurred */
+    if (tape_ferror (uptr))                             /* if a host I/O error occurred */
         st = sim_tape_ioerr (uptr);                     /*    then return I/O error status */
 
-    else if (feof (uptr->fileref))                      /* otherwise if the read was incomplete */
+    else if (tape_feof (uptr))                          /* otherwise if the read was incomplete */
         st = MTSE_INVRL;                                /*   then report a record length error */
 
     else if (f == MTUF_F_P7B)                            /* otherwise if the format is P7B */
@@ -1050,6 +1238,7 @@ t_stat sim_tape_wrrecf (UNIT *uptr, uint8 *buf, t_mtrlnt clbc)
 const uint32 f = MT_GET_FMT (uptr);                     /* the tape format */
 t_mtrlnt     sbc;
 uint32       classbit;
+t_bool       at_eof;
 
 MT_CLR_PNU (uptr);                                      /* clear the position-not-updated flag */
 
@@ -1078,7 +1267,9 @@ if ((uptr->flags & UNIT_ATT) == 0)                      /* if the unit is not at
 else if (sim_tape_wrp (uptr))                           /* otherwise if the tape is write protected */
     return MTSE_WRP;                                    /*   then report it */
 
-sim_fseek (uptr->fileref, uptr->pos, SEEK_SET);         /* set the tape position */
+at_eof = tape_index_trim (uptr, uptr->pos);             /* discard index entries at or beyond the write */
+
+tape_seek (uptr, uptr->pos);                            /* set the tape position */
 
 switch (f) {                                            /* dispatch on the format */
 
@@ -1089,21 +1280,25 @@ switch (f) {                                            /* dispatch on the forma
     /* fall through into the E11 handler */
 
     case MTUF_F_E11:                                    /* E11 */
-        sim_fwrite (&clbc, sizeof (t_mtrlnt), 1, uptr->fileref);
-        sim_fwrite (buf, sizeof (uint8), sbc, uptr->fileref);
-        sim_fwrite (&clbc, sizeof (t_mtrlnt), 1, uptr->fileref);
-        if (ferror (uptr->fileref)) {                   /* error? */
+        tape_fwrite (uptr, &clbc, sizeof (t_mtrlnt), 1);
+        tape_fwrite (uptr, buf, sizeof (uint8), sbc);
+        tape_fwrite (uptr, &clbc, sizeof (t_mtrlnt), 1);
+        if (tape_ferror (uptr)) {                       /* error? */
             MT_SET_PNU (uptr);
             return sim_tape_ioerr (uptr);
             }
+        tape_index_add (uptr, uptr->pos, clbc,                  /* index the record */
+                        uptr->pos + sbc + (2 * sizeof (t_mtrlnt)), IDX_CHECKED);
         uptr->pos = uptr->pos + sbc + (2 * sizeof (t_mtrlnt));  /* move tape */
+        if (at_eof)                                             /* written at EOF? */
+            tape_index_end (uptr, uptr->pos, IDX_EOF);          /* still at EOF */
         break;
 
     case MTUF_F_P7B:                                    /* Pierce 7B */
         buf[0] = buf[0] | P7B_SOR;                      /* mark start of rec */
-        sim_fwrite (buf, sizeof (uint8), sbc, uptr->fileref);
-        sim_fwrite (buf, sizeof (uint8), 1, uptr->fileref); /* delimit rec */
-        if (ferror (uptr->fileref)) {                   /* error? */
+        tape_fwrite (uptr, buf, sizeof (uint8), sbc);
+        tape_fwrite (uptr, buf, sizeof (uint8), 1);         /* delimit rec */
+        if (tape_ferror (uptr)) {                       /* error? */
             MT_SET_PNU (uptr);
             return sim_tape_ioerr (uptr);
             }
@@ -1119,18 +1314,27 @@ return MTSE_OK;
 
 static t_stat sim_tape_wrdata (UNIT *uptr, uint32 dat)
 {
+t_bool at_eof;
+
 MT_CLR_PNU (uptr);
 if ((uptr->flags & UNIT_ATT) == 0)                      /* not attached? */
     return MTSE_UNATT;
 if (sim_tape_wrp (uptr))                                /* write prot? */
     return MTSE_WRP;
-sim_fseek (uptr->fileref, uptr->pos, SEEK_SET);         /* set pos */
-sim_fwrite (&dat, sizeof (t_mtrlnt), 1, uptr->fileref);
-if (ferror (uptr->fileref)) {                           /* error? */
+at_eof = tape_index_trim (uptr, uptr->pos);             /* trim index at pos */
+tape_seek (uptr, uptr->pos);                            /* set pos */
+tape_fwrite (uptr, &dat, sizeof (t_mtrlnt), 1);
+if (tape_ferror (uptr)) {                               /* error? */
     MT_SET_PNU (uptr);
     return sim_tape_ioerr (uptr);
     }
+if (dat == MTR_EOM)                                     /* end of medium? */
+    tape_index_end (uptr, uptr->pos, IDX_EOM);          /* index ends here */
+else if (dat == MTR_TMK || MTR_CF (dat) == MTC_PMARK)   /* tape mark or private marker? */
+    tape_index_add (uptr, uptr->pos, dat, uptr->pos + sizeof (t_mtrlnt), 0);
 uptr->pos = uptr->pos + sizeof (t_mtrlnt);              /* move tape */
+if (at_eof && dat != MTR_EOM)                           /* appended at EOF? */
+    tape_index_end (uptr, uptr->pos, IDX_EOF);          /* still at EOF */
 return MTSE_OK;
 }
 
@@ -1251,7 +1455,9 @@ if (gaps [0] == 0)                                      /* if the gap block has
     for (count = 0; count < buffer_size; count++)       /*   then fill the block with erase gaps */
         gaps [count] = MTR_GAP;                         /*     to improve write performance */
 
-sim_fseek (uptr->fileref, uptr->pos, SEEK_SET);         /* seek to the start of the gap */
+tape_index_trim (uptr, uptr->pos);                      /* gaps are not indexed, so trim the index here */
+
+tape_seek (uptr, uptr->pos);                            /* seek to the start of the gap */
 
 byte_count = (byte_count + 1) & ~1;                     /* round the count to an even number */
 
@@ -1259,8 +1465,7 @@ if (byte_count < meta_size)                             /* if the size is smalle
     byte_count = meta_size;                             /*   then increase the size to one marker */
 
 else if (byte_count % meta_size > 0) {                  /* otherwise if an integral number of markers won't fit */
-    sim_fwrite (half_gap, sizeof (uint8), 2,            /*   then start the gap */
-                uptr->fileref);                         /*     with a half-gap marker */
+    tape_fwrite (uptr, half_gap, sizeof (uint8), 2);    /*   then start the gap with a half-gap marker */
 
     uptr->pos  = uptr->pos  + sizeof half_gap;          /* advance the tape position */
     byte_count = byte_count - sizeof half_gap;          /*   and drop the byte count for the half-gap */
@@ -1274,12 +1479,12 @@ while (marker_count > 0) {                              /* while full gaps are n
     else                                                /* otherwise */
         count = marker_count;                           /*   write the remaining size needed */
 
-    sim_fwrite (gaps, meta_size, count, uptr->fileref); /* write the erase gap */
+    tape_fwrite (uptr, gaps, meta_size, count);         /* write the erase gap */
 
     marker_count = marker_count - count;                /* reduce the count by the amount erased */
     }
 
-if (ferror (uptr->fileref)) {                           /* if a host I/O error occurred */
+if (tape_ferror (uptr)) {                               /* if a host I/O error occurred */
     uptr->pos = gap_pos;                                /*   then reposition back to the gap start */
 
     MT_SET_PNU (uptr);                                  /* report that the position was not updated */
@@ -1479,16 +1684,15 @@ else if (gap_size == 0                                  /* otherwise if the gap
 
 MT_SET_PNU (uptr);                                      /* errors from here on do not update the position */
 
-file_size = sim_fsize (uptr->fileref);                  /* get the file size */
-
-if (sim_fseek (uptr->fileref, uptr->pos, SEEK_SET))     /* position the tape; if it fails */
-    return sim_tape_ioerr (uptr);                       /*   then quit with I/O error status */
+if (tape_fsize (uptr, &file_size)                       /* get the file size; if writing the pending data fails */
+  || tape_seek (uptr, uptr->pos))                       /*   or positioning the tape fails */
+    return sim_tape_ioerr (uptr);                       /*     then quit with I/O error status */
 
 
 do {                                                        /* scan the area to be erased */
-    xfer = sim_fread (&meta, meta_size, 1, uptr->fileref);  /*   starting with the next metadatum in the file */
+    xfer = tape_fread (uptr, &meta, meta_size, 1);          /*   starting with the next metadatum in the file */
 
-    if (ferror (uptr->fileref)) {                       /* if a read error occurred */
+    if (tape_ferror (uptr)) {                           /* if a read error occurred */
         status = sim_tape_ioerr (uptr);                 /*   then report an I/O error */
         break;                                          /*     and quit the search */
         }
@@ -1514,7 +1718,7 @@ do {                                                        /* scan the area to
     else if (meta == MTR_FHGAP) {                       /* otherwise if a half-gap is seen */
         uptr->pos = uptr->pos - meta_size / 2;          /*   then back up to resync */
 
-        if (sim_fseek (uptr->fileref, uptr->pos, SEEK_SET)) {   /* position the tape; if it fails */
+        if (tape_seek (uptr, uptr->pos)) {                      /* position the tape; if it fails */
             status = sim_tape_ioerr (uptr);                     /*   then report an I/O error */
             break;                                              /*     and quit the search */
             }
@@ -1534,14 +1738,14 @@ do {                                                        /* scan the area to
 
         uptr->pos = uptr->pos + (sbc + 1) & ~1;         /* position to the trailing length marker */
 
-        if (sim_fseek (uptr->fileref, uptr->pos, SEEK_SET)) {   /* position the tape; if it fails */
+        if (tape_seek (uptr, uptr->pos)) {                      /* position the tape; if it fails */
             status = sim_tape_ioerr (uptr);                     /*   then report an I/O error */
             break;                                              /*     and quit the search */
             }
 
-        xfer = sim_fread (&meta, meta_size, 1, uptr->fileref);  /* read the metadatum */
+        xfer = tape_fread (uptr, &meta, meta_size, 1);          /* read the metadatum */
 
-        if (ferror (uptr->fileref)) {                   /* if a read error occurred */
+        if (tape_ferror (uptr)) {                       /* if a read error occurred */
             status = sim_tape_ioerr (uptr);             /*   then report an I/O error */
             break;                                      /*     and quit the search */
             }
@@ -1653,25 +1857,26 @@ if (gap_size == meta_size) {                            /* if the request is for
     else                                                /*   otherwise */
         uptr->pos -= meta_size;                         /*     back up the file pointer */
 
-    if (sim_fseek (uptr->fileref, uptr->pos, SEEK_SET)) /* position the tape; if it fails */
+    if (tape_seek (uptr, uptr->pos))                    /* position the tape; if it fails */
         return sim_tape_ioerr (uptr);                   /*   then quit with I/O error status */
 
-    sim_fread (&metadatum, meta_size, 1, uptr->fileref);    /* read a metadatum */
+    tape_fread (uptr, &metadatum, meta_size, 1);            /* read a metadatum */
 
-    if (ferror (uptr->fileref))                             /* if a file I/O error occurred */
+    if (tape_ferror (uptr))                                 /* if a file I/O error occurred */
         return sim_tape_ioerr (uptr);                       /*   then report the error and quit */
 
     else if (metadatum == MTR_TMK)                          /* otherwise if a tape mark is present */
-        if (sim_fseek (uptr->fileref, uptr->pos, SEEK_SET)) /*   then reposition the tape; if it fails */
+        if (tape_seek (uptr, uptr->pos))                    /*   then reposition the tape; if it fails */
             return sim_tape_ioerr (uptr);                   /*     then quit with I/O error status */
 
         else {                                              /*   otherwise */
-            metadatum = MTR_GAP;                            /*     replace it with an erase gap marker */
+            tape_index_trim (uptr, uptr->pos);              /*     trim the index at the tape mark */
+            metadatum = MTR_GAP;                            /*       and replace it with an erase gap marker */
 
-            xfer = sim_fwrite (&metadatum, meta_size,   /* write the gap marker */
-                               1, uptr->fileref);
+            xfer = tape_fwrite (uptr, &metadatum,       /* write the gap marker */
+                                meta_size, 1);
 
-            if (ferror (uptr->fileref) || xfer == 0)    /* if a file I/O error occurred */
+            if (tape_ferror (uptr) || xfer == 0)        /* if a file I/O error occurred */
                 return sim_tape_ioerr (uptr);           /* report the error and quit */
             else                                        /* otherwise the write succeeded */
                 status = MTSE_OK;                       /*   so return success */
@@ -1975,6 +2180,8 @@ t_stat sim_tape_rewind (UNIT *uptr)
 {
 uptr->pos = 0;
 MT_CLR_PNU (uptr);
+if (tape_flush (uptr) != SCPE_OK)                       /* write any buffered data; if it fails */
+    return sim_tape_ioerr (uptr);                       /*   then report the error */
 return MTSE_OK;
 }
 
@@ -1983,6 +2190,8 @@ return MTSE_OK;
 t_stat sim_tape_reset (UNIT *uptr)
 {
 MT_CLR_PNU (uptr);
+if (tape_flush (uptr) != SCPE_OK)                       /* write any buffered data; if it fails */
+    return sim_tape_ioerr (uptr);                       /*   then report the error */
 return MTSE_OK;
 }
 
@@ -2014,7 +2223,7 @@ return ((uptr->flags & MTUF_WRP) || (MT_GET_FMT (uptr) == MTUF_F_TPC)) ? TRUE :
 static t_stat sim_tape_ioerr (UNIT *uptr)
 {
 perror ("Magtape library I/O error");
-clearerr (uptr->fileref);
+tape_clearerr (uptr);
 return MTSE_IOERR;
 }
 
@@ -2127,8 +2336,8 @@ uint32 i, objc;
 if ((uptr == NULL) || (uptr->fileref == NULL))
     return 0;
 for (objc = 0, tpos = 0;; ) {
-    sim_fseek (uptr->fileref, tpos, SEEK_SET);
-    i = sim_fread (&bc, sizeof (t_tpclnt), 1, uptr->fileref);
+    tape_seek (uptr, tpos);
+    i = tape_fread (uptr, &bc, sizeof (t_tpclnt), 1);
     if (i == 0)
         break;
     if (map)
@@ -2162,6 +2371,872 @@ while (lo <= hi);
 return ((p == 0) ? map[p] : map[p - 1]);
 }
 
+
+/* Allocate the tape context for a unit */
+
+static t_stat tape_index_alloc (UNIT *uptr)
+{
+struct tape_context *ctx;
+
+ctx = (struct tape_context *) calloc (1, sizeof (struct tape_context));
+if (ctx == NULL)                                        /* allocation failed? */
+    return SCPE_MEM;
+ctx->buf = (uint8 *) malloc (TBUF_SIZE);                /* allocate the stream buffer */
+if (ctx->buf == NULL) {                                 /* allocation failed? */
+    free (ctx);
+    return SCPE_MEM;
+    }
+ctx->idx_state = IDX_OPEN;                              /* empty index at BOT */
+uptr->tape_ctx = ctx;
+return SCPE_OK;
+}
+
+/* Free the tape context for a unit */
+
+static void tape_index_free (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+
+if (ctx == NULL)                                        /* no context? */
+    return;
+free (ctx->idx_pos);
+free (ctx->idx_meta);
+free (ctx->idx_flags);
+free (ctx->buf);
+#if defined (HAVE_ZLIB)
+tape_zclose (uptr);
+#endif
+free (ctx);
+uptr->tape_ctx = NULL;
+}
+
+/* Find a position in the record index.
+
+   The entry number of the object starting at "pos" is returned.  If "pos" is
+   the end of the index, the object count is returned, and if "pos" is not the
+   start of an indexed object, -1 is returned.  The entry of the last successful
+   lookup and the entry following it are checked first, so that sequential
+   access in either direction does not require a search.
+*/
+
+static int32 tape_index_find (struct tape_context *ctx, t_addr pos)
+{
+uint32 lo, hi, p;
+
+if (pos == ctx->idx_end)                                /* at the end? */
+    return (int32) ctx->idx_count;
+if (ctx->idx_count == 0 || pos > ctx->idx_end)          /* outside the index? */
+    return -1;
+p = ctx->idx_hint;
+if (p < ctx->idx_count && ctx->idx_pos [p] == pos)      /* same as last? */
+    return (int32) p;
+if (p + 1 < ctx->idx_count && ctx->idx_pos [p + 1] == pos)  /* next after last? */
+    return (int32) (p + 1);
+lo = 0;                                                 /* binary search */
+hi = ctx->idx_count;
+while (lo < hi) {
+    p = (lo + hi) >> 1;
+    if (ctx->idx_pos [p] == pos)
+        return (int32) p;
+    else if (ctx->idx_pos [p] < pos)
+        lo = p + 1;
+    else hi = p;
+    }
+return -1;
+}
+
+/* Add an object to the end of the record index.
+
+   The object starting at "pos" with leading metadatum "meta" and ending at
+   "next" is appended with the supplied flags if it immediately follows the
+   last indexed object.  If the index cannot be expanded, it simply stops
+   growing.
+*/
+
+static void tape_index_add (UNIT *uptr, t_addr pos, t_mtrlnt meta, t_addr next, uint8 flags)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+t_addr *npos;
+t_mtrlnt *nmeta;
+uint8 *nflags;
+uint32 nsize;
+
+if (ctx == NULL                                         /* no index */
+    || ctx->idx_state != IDX_OPEN                       /* or end is known */
+    || pos != ctx->idx_end)                             /* or not contiguous? */
+    return;
+if (ctx->idx_count == ctx->idx_size) {                  /* index full? */
+    nsize = (ctx->idx_size == 0)? IDX_INCR: ctx->idx_size * 2;
+    npos = (t_addr *) realloc (ctx->idx_pos, nsize * sizeof (t_addr));
+    if (npos == NULL)
+        return;
+    ctx->idx_pos = npos;
+    nmeta = (t_mtrlnt *) realloc (ctx->idx_meta, nsize * sizeof (t_mtrlnt));
+    if (nmeta == NULL)
+        return;
+    ctx->idx_meta = nmeta;
+    nflags = (uint8 *) realloc (ctx->idx_flags, nsize * sizeof (uint8));
+    if (nflags == NULL)
+        return;
+    ctx->idx_flags = nflags;
+    ctx->idx_size = nsize;
+    }
+ctx->idx_pos [ctx->idx_count] = pos;
+ctx->idx_meta [ctx->idx_count] = meta;
+ctx->idx_flags [ctx->idx_count] = flags;
+ctx->idx_count = ctx->idx_count + 1;
+ctx->idx_end = next;
+}
+
+/* Record the state of the image at the end of the record index */
+
+static void tape_index_end (UNIT *uptr, t_addr pos, uint32 state)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+
+if (ctx != NULL && ctx->idx_state == IDX_OPEN && pos == ctx->idx_end)
+    ctx->idx_state = state;
+}
+
+/* Trim the record index before a write.
+
+   All objects that end after position "pos" are discarded, and the image
+   beyond the new end of the index is marked as unknown.  TRUE is returned if
+   "pos" was the physical end of the file, i.e., if the write will append to
+   the image.
+*/
+
+static t_bool tape_index_trim (UNIT *uptr, t_addr pos)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+t_bool at_eof;
+uint32 lo, hi, p;
+
+if (ctx == NULL)                                        /* no index? */
+    return FALSE;
+at_eof = (ctx->idx_state == IDX_EOF) && (pos == ctx->idx_end);
+if (pos < ctx->idx_end) {                               /* write within index? */
+    lo = 0;                                             /* find first object */
+    hi = ctx->idx_count;                                /*   starting after pos */
+    while (lo < hi) {
+        p = (lo + hi) >> 1;
+        if (ctx->idx_pos [p] <= pos)
+            lo = p + 1;
+        else hi = p;
+        }
+    ctx->idx_count = lo - 1;                            /* drop the preceding one too */
+    ctx->idx_end = ctx->idx_pos [lo - 1];
+    if (ctx->idx_hint >= ctx->idx_count)
+        ctx->idx_hint = 0;
+    }
+ctx->idx_state = IDX_OPEN;
+return at_eof;
+}
+
+/* Read record length forward using the record index.
+
+   If the tape is positioned at an indexed object, the next object accepted by
+   the class set "accept" is located in the index, and the tape is positioned
+   and the return status and metadatum are set exactly as "sim_tape_rdlntf"
+   would set them.  FALSE is returned if the object cannot be determined from
+   the index alone, and the caller must scan the image instead.
+*/
+
+static t_bool tape_index_fwd (UNIT *uptr, uint32 accept, t_mtrlnt *bc, t_stat *status)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+int32 start;
+uint32 n, classbit;
+t_mtrlnt meta;
+
+if (ctx == NULL || (start = tape_index_find (ctx, uptr->pos)) < 0)
+    return FALSE;
+for (n = (uint32) start; n < ctx->idx_count; n++) {     /* search forward */
+    meta = ctx->idx_meta [n];
+    classbit = MTR_FB (meta);
+    if (meta == MTR_TMK)                                /* tape mark? */
+        *status = MTSE_TMK;
+    else if ((classbit & accept) == 0)                  /* not accepted? */
+        continue;                                       /* skip it */
+    else if (classbit == MTB_PMARK)                     /* private marker? */
+        *status = MTSE_OK;
+    else if (tape_seek (uptr, ctx->idx_pos [n] + sizeof (t_mtrlnt))) {
+        uptr->pos = ctx->idx_pos [n] + sizeof (t_mtrlnt);   /* seek failed */
+        *bc = meta;
+        *status = sim_tape_ioerr (uptr);
+        return TRUE;
+        }
+    else *status = MTSE_OK;                             /* data record */
+    uptr->pos = (n + 1 < ctx->idx_count)?               /* position past object */
+        ctx->idx_pos [n + 1]: ctx->idx_end;
+    ctx->idx_hint = n;
+    *bc = meta;
+    return TRUE;
+    }
+if (ctx->idx_state == IDX_OPEN)                         /* unknown beyond end? */
+    return FALSE;                                       /* must scan */
+if (n == (uint32) start)                                /* nothing skipped? */
+    MT_SET_PNU (uptr);                                  /* pos not upd */
+uptr->pos = ctx->idx_end;
+*bc = (ctx->idx_state == IDX_EOM)? MTR_EOM: 0;
+*status = MTSE_EOM;
+return TRUE;
+}
+
+/* Read record length reverse using the record index.
+
+   If the tape is positioned at the end of an indexed object, the preceding
+   object accepted by the class set "accept" is located in the index, and the
+   tape is positioned and the return status and metadatum are set exactly as
+   "sim_tape_rdlntr" would set them.  FALSE is returned if the tape is not
+   positioned within the index or if a data record's trailing length does not
+   match its leading length, and the caller must scan the image instead.
+*/
+
+static t_bool tape_index_rev (UNIT *uptr, uint32 accept, t_mtrlnt *bc, t_stat *status)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+int32 start;
+uint32 n, classbit;
+t_mtrlnt meta = 0, trail;
+t_addr next;
+
+if (ctx == NULL || (start = tape_index_find (ctx, uptr->pos)) < 0)
+    return FALSE;
+for (n = (uint32) start; n > 0; ) {                     /* search backward */
+    meta = ctx->idx_meta [--n];
+    classbit = MTR_FB (meta);
+    next = (n + 1 < ctx->idx_count)? ctx->idx_pos [n + 1]: ctx->idx_end;
+    if (meta != MTR_TMK                                 /* data record */
+        && (classbit & MTB_RECORDSET)                   /*   not yet checked? */
+        && (ctx->idx_flags [n] & IDX_CHECKED) == 0) {
+        if (tape_seek (uptr, next - sizeof (t_mtrlnt))
+            || tape_fread (uptr, &trail, sizeof (t_mtrlnt), 1) != 1
+            || trail != meta) {                         /* trailing length differs? */
+            tape_clearerr (uptr);
+            return FALSE;                               /* must scan */
+            }
+        ctx->idx_flags [n] |= IDX_CHECKED;
+        }
+    if (meta == MTR_TMK)                                /* tape mark? */
+        *status = MTSE_TMK;
+    else if ((classbit & accept) == 0)                  /* not accepted? */
+        continue;                                       /* skip it */
+    else if (classbit == MTB_PMARK)                     /* private marker? */
+        *status = MTSE_OK;
+    else if (tape_seek (uptr, ctx->idx_pos [n] + sizeof (t_mtrlnt))) {
+        uptr->pos = next - sizeof (t_mtrlnt);           /* seek failed */
+        *bc = meta;
+        *status = sim_tape_ioerr (uptr);
+        return TRUE;
+        }
+    else *status = MTSE_OK;                             /* data record */
+    uptr->pos = ctx->idx_pos [n];                       /* position before object */
+    ctx->idx_hint = n;
+    *bc = meta;
+    return TRUE;
+    }
+uptr->pos = 0;                                          /* backed into BOT */
+*bc = meta;
+*status = MTSE_BOT;
+return TRUE;
+}
+
+/* Tape image stream I/O.
+
+   These routines are the analogs of "sim_fseek", "sim_fread", "sim_fwrite",
+   "ferror", "feof", and "clearerr" for the tape image file attached to a unit.
+   If the unit has a tape context, the transfers are made through the context's
+   stream buffer; otherwise, they are passed directly to the file routines.
+
+   The buffer holds either data read from the file starting at "buf_base" or
+   data written by the caller that has not yet been written to the file (i.e.,
+   "buf_dirty" is set).  Seeking simply sets the stream position, so a seek to a
+   location within a buffer of read data costs nothing.  A read that is not
+   satisfied by the buffer refills it with the block containing the stream
+   position; blocks are aligned to the buffer size, so that reverse motion
+   through the image is also served from the buffer.  A write discards any read
+   data, and a write that does not continue the pending data writes that data
+   first.  As with "sim_fread" and "sim_fwrite", multi-byte items are stored
+   in little-endian order.  All data are obtained from the file by
+   "tape_get", which decompresses the data if the image is compressed.
+
+
+   Implementation notes:
+
+    1. A read or a write that is at least as large as the buffer transfers
+       directly between the caller's area and the file, after any buffered data
+       preceding it has been consumed or written.
+
+    2. The EOF flag is set when a read cannot be completed because the end of
+       the file was reached.  Seeking clears it, as "fseek" does.
+
+    3. Only units attached with the SIMH, extended SIMH, or E11 formats have a
+       tape context.  TPC and P7B units have none, so their transfers always
+       go directly to the file.
+
+    4. A position that wraps below zero, e.g., from a reverse read over a
+       corrupt record length, is rejected with EINVAL as the host seek would
+       reject it.  That can only happen when the position is as wide as the
+       file offset; otherwise, the wrapped position is simply beyond the end
+       of the file.
+*/
+
+static int tape_seek (UNIT *uptr, t_addr pos)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+
+if (ctx == NULL)                                        /* if the unit is not buffered */
+    return sim_fseek (uptr->fileref, pos, SEEK_SET);    /*   then position the file directly */
+
+#if (T_ADDR_W == 64) || defined (DONT_DO_LARGEFILE)     /* if a position can exceed the offset range */
+if ((t_offset) pos < 0) {                               /*   then if the position is before the start of the file */
+    errno = EINVAL;                                     /*     then fail as the host seek would */
+    ctx->buf_err = TRUE;                                /*       and fail the next transfer */
+    return -1;
+    }
+#endif
+
+ctx->pos = pos;                                         /* set the stream position */
+ctx->buf_eof = FALSE;                                   /*   and clear the EOF condition */
+return 0;
+}
+
+static size_t tape_fread (UNIT *uptr, void *bptr, size_t size, size_t count)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+uint8  *dptr = (uint8 *) bptr;
+size_t bytes, done, xfer;
+
+if (ctx == NULL)                                        /* if the unit is not buffered */
+    return sim_fread (bptr, size, count, uptr->fileref);    /*   then read the file directly */
+
+if (size == 0 || count == 0)                            /* if there is nothing to read */
+    return 0;                                           /*   then we are done */
+
+if (tape_flush (uptr) != SCPE_OK)                       /* write any pending data; if it fails */
+    return 0;                                           /*   then report the error */
+
+bytes = size * count;
+
+for (done = 0; done < bytes; ) {
+    if (ctx->pos >= ctx->buf_base                       /* if the stream position */
+      && ctx->pos < ctx->buf_base + ctx->buf_len) {     /*   lies within the buffer */
+        xfer = (size_t) (ctx->buf_base + ctx->buf_len - ctx->pos);
+
+        if (xfer > bytes - done)                        /* limit the transfer */
+            xfer = bytes - done;                        /*   to the remaining request */
+
+        memcpy (dptr + done, ctx->buf + (size_t) (ctx->pos - ctx->buf_base), xfer);
+        }
+
+    else if (bytes - done >= TBUF_SIZE) {               /* otherwise if the remainder is large */
+        xfer = tape_get (uptr, ctx->pos,                /*   then read it directly */
+                         dptr + done, bytes - done);
+
+        if (xfer < bytes - done) {                      /* if the read is incomplete */
+            done = done + xfer;                         /*   then count what was read */
+            ctx->pos = ctx->pos + xfer;
+
+            if (!ctx->buf_err)                          /* if a host error did not occur */
+                ctx->buf_eof = TRUE;                    /*   then the EOF was reached */
+            break;
+            }
+        }
+
+    else {                                              /* otherwise refill the buffer */
+        ctx->buf_base = ctx->pos & ~(t_addr) (TBUF_SIZE - 1);   /*   with the block containing the position */
+        ctx->buf_len = (uint32) tape_get (uptr, ctx->buf_base, ctx->buf, TBUF_SIZE);
+
+        if (ctx->pos >= ctx->buf_base + ctx->buf_len) { /* if the position was not reached */
+            if (!ctx->buf_err)                          /*   then if a host error did not occur */
+                ctx->buf_eof = TRUE;                    /*     then the EOF was reached */
+            break;
+            }
+
+        continue;                                       /* copy from the new buffer */
+        }
+
+    done = done + xfer;                                 /* count the bytes transferred */
+    ctx->pos = ctx->pos + xfer;                         /*   and advance the position */
+    }
+
+count = done / size;                                    /* count the complete items */
+
+if (!sim_end)                                           /* if the host is big-endian */
+    sim_buf_swap_data (bptr, size, count);              /*   then swap the items to host order */
+
+return count;
+}
+
+static size_t tape_get (UNIT *uptr, t_addr pos, uint8 *bptr, size_t len)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+size_t xfer;
+
+#if defined (HAVE_ZLIB)
+if (ctx->zs != NULL)                                    /* if the image is compressed */
+    return tape_zread (uptr, pos, bptr, len);           /*   then decompress the data */
+#endif
+
+if (sim_fseek (uptr->fileref, pos, SEEK_SET)) {         /* if the seek fails */
+    ctx->buf_err = TRUE;                                /*   then report a host error */
+    return 0;
+    }
+
+xfer = fread (bptr, 1, len, uptr->fileref);             /* read the data */
+
+if (xfer < len && ferror (uptr->fileref))               /* if a host error occurred */
+    ctx->buf_err = TRUE;                                /*   then report it */
+
+return xfer;
+}
+
+static size_t tape_fwrite (UNIT *uptr, void *bptr, size_t size, size_t count)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+size_t bytes, xfer;
+
+if (ctx == NULL)                                        /* if the unit is not buffered */
+    return sim_fwrite (bptr, size, count, uptr->fileref);   /*   then write the file directly */
+
+if (size == 0 || count == 0)                            /* if there is nothing to write */
+    return 0;                                           /*   then we are done */
+
+bytes = size * count;
+
+if (!ctx->buf_dirty)                                    /* if the buffer holds read data */
+    ctx->buf_len = 0;                                   /*   then discard it */
+
+else if (ctx->pos != ctx->buf_base + ctx->buf_len       /* otherwise if the write does not continue the data */
+  || ctx->buf_len + bytes > TBUF_SIZE)                  /*   or will not fit in the buffer */
+    if (tape_flush (uptr) != SCPE_OK)                   /*     then write the pending data; if it fails */
+        return 0;                                       /*       then report the error */
+
+if (bytes >= TBUF_SIZE) {                               /* if the write is large */
+    if (sim_fseek (uptr->fileref, ctx->pos, SEEK_SET))  /*   then write it directly */
+        xfer = 0;
+    else
+        xfer = sim_fwrite (bptr, size, count, uptr->fileref);
+
+    if (xfer < count)                                   /* if the write is incomplete */
+        ctx->buf_err = TRUE;                            /*   then report a host error */
+
+    ctx->pos = ctx->pos + xfer * size;                  /* advance past the data written */
+    return xfer;
+    }
+
+if (ctx->buf_len == 0)                                  /* if the buffer is empty */
+    ctx->buf_base = ctx->pos;                           /*   then it starts at the stream position */
+
+memcpy (ctx->buf + ctx->buf_len, bptr, bytes);          /* add the data to the buffer */
+
+if (!sim_end)                                           /* if the host is big-endian */
+    sim_buf_swap_data (ctx->buf + ctx->buf_len, size, count);   /*   then store the items little-endian */
+
+ctx->buf_len = ctx->buf_len + (uint32) bytes;           /* count the data */
+ctx->buf_dirty = TRUE;                                  /*   as pending */
+ctx->pos = ctx->pos + bytes;                            /*     and advance the position */
+
+return count;
+}
+
+/* Write the pending data in the stream buffer to the file.
+
+   SCPE_OK is returned if the buffer held no pending data or the data was
+   written successfully.  Otherwise, the stream error flag is set, and
+   SCPE_IOERR is returned.  In either case, the buffer is empty on return.
+*/
+
+static t_stat tape_flush (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+uint32 len;
+
+if (ctx == NULL || !ctx->buf_dirty)                     /* if there is nothing to write */
+    return SCPE_OK;                                     /*   then we are done */
+
+len = ctx->buf_len;                                     /* get the pending byte count */
+
+ctx->buf_len = 0;                                       /* empty the buffer */
+ctx->buf_dirty = FALSE;
+
+if (sim_fseek (uptr->fileref, ctx->buf_base, SEEK_SET)  /* if positioning */
+  || fwrite (ctx->buf, 1, len, uptr->fileref) != len) { /*   or writing the data fails */
+    ctx->buf_err = TRUE;                                /*     then set the error flag */
+    return SCPE_IOERR;                                  /*       and report the failure */
+    }
+
+return SCPE_OK;
+}
+
+/* Get the size of the tape image file, including any pending data.
+
+   The size is stored via "size", and 0 is returned.  If the pending data
+   cannot be written, the stream error flag is set and -1 is returned, as for
+   "tape_seek".
+*/
+
+static int tape_fsize (UNIT *uptr, uint32 *size)
+{
+if (tape_flush (uptr) != SCPE_OK)                       /* write any pending data; if that fails */
+    return -1;                                          /*   then the error flag is set */
+
+*size = sim_fsize (uptr->fileref);
+return 0;
+}
+
+/* Test the stream error and EOF flags and clear them */
+
+static int tape_ferror (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+
+return (ctx != NULL && ctx->buf_err) || ferror (uptr->fileref);
+}
+
+static int tape_feof (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+
+return (ctx != NULL)? ctx->buf_eof: feof (uptr->fileref);
+}
+
+static void tape_clearerr (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+
+if (ctx != NULL)
+    ctx->buf_err = ctx->buf_eof = FALSE;
+clearerr (uptr->fileref);
+}
+
+#if defined (HAVE_ZLIB)
+
+/* Compressed tape images.
+
+   A tape image compressed with "gzip" is recognized at attach time by the
+   magic bytes at the start of the file and is attached read-only.  Reads are
+   satisfied by decompressing the file as a stream, so the image is never
+   expanded on disk.  A gzip file may contain several concatenated members; the
+   decompressed data of all members forms the image.
+
+   Forward motion simply continues the decompression.  To position the stream
+   backward, e.g., for a reverse read or a rewind, the decompressor is restored
+   from a seek point.  A seek point is a copy of the decompression state made
+   each time the stream reaches a ZPT_SPACING boundary of the image for the
+   first time, together with the position of the next compressed byte in the
+   file.  Restoring a seek point and decompressing forward to the desired
+   position therefore costs at most ZPT_SPACING bytes of decompression.  The
+   seek point at position 0 is made when the image is attached.
+
+   If the "-Z" switch is given when an uncompressed image is attached, the
+   image is read and written normally while it is attached and is replaced by
+   its gzip-compressed equivalent when it is detached.  This is the means of
+   creating new compressed images.
+
+
+   Implementation notes:
+
+    1. The decompression state is copied with "inflateCopy," which includes the
+       32 KB history window.  Seek points are therefore made sparingly; at the
+       default spacing, they occupy about four percent of the image size.
+
+    2. A failure to allocate a seek point is not an error; positioning simply
+       decompresses from the preceding point.
+*/
+
+/* Check for and open a compressed tape image.
+
+   The file attached to the unit is examined for the gzip magic bytes.  If they
+   are present, the unit is made read-only, and the decompression stream and the
+   initial seek point are established.  Otherwise, the unit is marked for
+   compression at detach if the "-Z" switch was given.  SCPE_OK is returned if
+   the unit is ready for use, or an error status otherwise.
+*/
+
+static t_stat tape_zopen (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+DEVICE *dptr;
+uint8  magic [2];
+size_t count = 0;
+
+if (sim_fseek (uptr->fileref, 0, SEEK_SET) == 0)        /* read the first two bytes */
+    count = fread (magic, 1, sizeof (magic), uptr->fileref);    /*   of the image file */
+
+if (count < sizeof (magic)                              /* if the file is too short */
+  || magic [0] != 0x1F || magic [1] != 0x8B) {          /*   or does not have the gzip magic bytes */
+    if ((sim_switches & SWMASK ('Z'))                   /*   then if compression was requested */
+      && (uptr->flags & UNIT_RO) == 0)                  /*     and the image is writable */
+        ctx->zcompress = TRUE;                          /*       then compress the image at detach */
+    return SCPE_OK;                                     /* the image is not compressed */
+    }
+
+if ((uptr->flags & (UNIT_RO | UNIT_ROABLE)) == 0)       /* if the unit cannot be read-only */
+    return SCPE_NORO;                                   /*   then the image cannot be attached */
+
+ctx->zs = (z_stream *) calloc (1, sizeof (z_stream));   /* allocate the decompression stream */
+ctx->zbuf = (uint8 *) malloc (ZBUF_SIZE);               /*   and the compressed input buffer */
+
+if (ctx->zs == NULL || ctx->zbuf == NULL
+  || inflateInit2 (ctx->zs, 15 + 16) != Z_OK) {         /* initialize for gzip decoding; if it fails */
+    free (ctx->zs);                                     /*   then release the stream */
+    ctx->zs = NULL;
+    return SCPE_MEM;                                    /*     and report the failure */
+    }
+
+ctx->zfoff = 0;                                         /* the stream starts */
+ctx->zpos = 0;                                          /*   at the beginning of the file */
+rewind (uptr->fileref);
+
+if (tape_zpoint_add (uptr) == FALSE) {                  /* make the initial seek point; if it fails */
+    tape_zclose (uptr);                                 /*   then release the stream */
+    return SCPE_MEM;                                    /*     and report the failure */
+    }
+
+uptr->flags = uptr->flags | UNIT_RO;                    /* compressed images are read-only */
+
+dptr = find_dev_from_unit (uptr);
+
+if (!sim_quiet && dptr != NULL)
+    sim_printf ("%s: compressed image, unit is read only\n", sim_dname (dptr));
+
+return SCPE_OK;
+}
+
+
+/* Release the decompression stream and seek points */
+
+static void tape_zclose (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+uint32 i;
+
+if (ctx->zs != NULL) {                                  /* if the image is compressed */
+    inflateEnd (ctx->zs);                               /*   then release the stream */
+    free (ctx->zs);
+    ctx->zs = NULL;
+    }
+
+for (i = 0; i < ctx->zpt_count; i++)                    /* release the seek point states */
+    inflateEnd (&ctx->zpt [i].strm);
+
+free (ctx->zpt);
+free (ctx->zbuf);
+
+ctx->zpt = NULL;
+ctx->zbuf = NULL;
+ctx->zpt_count = ctx->zpt_size = 0;
+}
+
+
+/* Add a seek point at the current decompression stream position */
+
+static t_bool tape_zpoint_add (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+struct tape_zpoint  *npt;
+uint32 nsize;
+
+if (ctx->zpt_count == ctx->zpt_size) {                  /* if the array is full */
+    nsize = (ctx->zpt_size == 0)? 64: ctx->zpt_size * 2;    /*   then double its size */
+    npt = (struct tape_zpoint *) realloc (ctx->zpt, nsize * sizeof (struct tape_zpoint));
+
+    if (npt == NULL)                                    /* if the allocation failed */
+        return FALSE;                                   /*   then do without the point */
+
+    ctx->zpt = npt;
+    ctx->zpt_size = nsize;
+    }
+
+npt = &ctx->zpt [ctx->zpt_count];
+
+if (inflateCopy (&npt->strm, ctx->zs) != Z_OK)          /* copy the decompression state; if it fails */
+    return FALSE;                                       /*   then do without the point */
+
+npt->pos = ctx->zpos;                                   /* save the image position */
+npt->foff = ctx->zfoff - ctx->zs->avail_in;             /*   and the file offset of the unconsumed input */
+ctx->zpt_count = ctx->zpt_count + 1;
+return TRUE;
+}
+
+
+/* Decompress data from the current stream position.
+
+   Up to "len" bytes are decompressed into the buffer pointed to by "bptr", and
+   the count of bytes produced is returned.  A count less than "len" indicates
+   that the end of the image was reached or that an error occurred; in the
+   latter case, the stream error flag is set.  Seek points are made as ZPT_SPACING
+   boundaries beyond the last point are reached.  A point that cannot be made
+   when its boundary is reached is made at the next opportunity instead.
+*/
+
+static size_t tape_zinflate (UNIT *uptr, uint8 *bptr, size_t len)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+z_stream *zs = ctx->zs;
+t_addr   boundary;
+size_t   done = 0, limit;
+int      zr;
+
+while (done < len) {
+    boundary = ctx->zpt [ctx->zpt_count - 1].pos + ZPT_SPACING;    /* the position of the next seek point */
+
+    if (ctx->zpos >= boundary                           /* if the stream has reached or passed it */
+      && tape_zpoint_add (uptr))                        /*   and a point is made here */
+        boundary = ctx->zpos + ZPT_SPACING;             /*     then the next one follows it */
+
+    limit = len - done;                                 /* decompress the remaining amount */
+
+    if (ctx->zpos < boundary && boundary - ctx->zpos < limit)   /* but stop at the next seek point */
+        limit = (size_t) (boundary - ctx->zpos);
+
+    if (zs->avail_in == 0) {                            /* if the input buffer is empty */
+        zs->next_in = ctx->zbuf;                        /*   then refill it */
+        zs->avail_in = (uInt) fread (ctx->zbuf, 1, ZBUF_SIZE, uptr->fileref);
+        ctx->zfoff = ctx->zfoff + zs->avail_in;
+
+        if (zs->avail_in == 0) {                        /* if no more input is available */
+            if (ferror (uptr->fileref))                 /*   then if a host error occurred */
+                ctx->buf_err = TRUE;                    /*     then report it */
+            break;                                      /* the end of the image is reached */
+            }
+        }
+
+    zs->next_out = bptr + done;
+    zs->avail_out = (uInt) limit;
+
+    zr = inflate (zs, Z_NO_FLUSH);                      /* decompress the data */
+
+    done = done + (limit - zs->avail_out);              /* count the bytes produced */
+    ctx->zpos = ctx->zpos + (limit - zs->avail_out);
+
+    if (zr == Z_STREAM_END)                             /* if a member ended */
+        inflateReset (zs);                              /*   then prepare for a following member */
+
+    else if (zr != Z_OK && zr != Z_BUF_ERROR) {         /* otherwise if the data are corrupt */
+        ctx->buf_err = TRUE;                            /*   then report an error */
+        errno = EIO;
+        break;
+        }
+    }
+
+return done;
+}
+
+
+/* Read data from a compressed image.
+
+   Up to "len" bytes at image position "pos" are decompressed into the buffer
+   pointed to by "bptr", and the count of bytes read is returned.  If the
+   position is not ahead of the current decompression position, or is ahead of
+   a seek point beyond it, then the stream is restored from the nearest seek
+   point preceding the position.  The data between the stream position and the
+   requested position are decompressed into the caller's buffer and discarded.
+*/
+
+static size_t tape_zread (UNIT *uptr, t_addr pos, uint8 *bptr, size_t len)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+struct tape_zpoint  *pt;
+uint32 lo, hi, mid;
+size_t skip;
+
+lo = 0;                                                 /* find the last seek point */
+hi = ctx->zpt_count - 1;                                /*   at or before the position */
+
+while (lo < hi) {
+    mid = (lo + hi + 1) / 2;
+
+    if (ctx->zpt [mid].pos <= pos)
+        lo = mid;
+    else
+        hi = mid - 1;
+    }
+
+pt = &ctx->zpt [lo];
+
+if (pos < ctx->zpos || pt->pos > ctx->zpos) {           /* if the point is closer than the stream position */
+    inflateEnd (ctx->zs);                               /*   then replace the stream state */
+
+    if (inflateCopy (ctx->zs, &pt->strm) != Z_OK        /*     with that of the seek point; if it fails */
+      || sim_fseek (uptr->fileref, pt->foff, SEEK_SET)) {   /*       or the file cannot be positioned */
+        memset (ctx->zs, 0, sizeof (z_stream));         /*         then reinitialize the stream */
+        inflateInit2 (ctx->zs, 15 + 16);                /*           to start over */
+        ctx->zfoff = ctx->zpos = 0;
+        rewind (uptr->fileref);
+        ctx->buf_err = TRUE;                            /*             and report the error */
+        return 0;
+        }
+
+    ctx->zs->next_in = ctx->zbuf;                       /* discard the input */
+    ctx->zs->avail_in = 0;                              /*   copied with the state */
+    ctx->zfoff = pt->foff;
+    ctx->zpos = pt->pos;
+    }
+
+while (ctx->zpos < pos) {                               /* skip forward to the position */
+    skip = (pos - ctx->zpos < len)? (size_t) (pos - ctx->zpos): len;
+
+    if (tape_zinflate (uptr, bptr, skip) < skip)        /* if the image ends or an error occurs */
+        return 0;                                       /*   then nothing can be read */
+    }
+
+return tape_zinflate (uptr, bptr, len);                 /* read the data */
+}
+
+
+/* Compress the image attached to a unit.
+
+   The image is copied with gzip compression to the file named "tname".  SCPE_OK
+   is returned if the copy succeeded, or SCPE_IOERR if it did not.  Pending data
+   must have been written to the image before calling.
+*/
+
+static t_stat tape_zcompress (UNIT *uptr, const char *tname)
+{
+struct tape_context *ctx = (struct tape_context *) uptr->tape_ctx;
+gzFile gz;
+size_t count;
+t_bool error = FALSE;
+
+gz = gzopen (tname, "wb");                              /* create the compressed file */
+
+if (gz == NULL)                                         /* if it cannot be created */
+    return SCPE_IOERR;                                  /*   then report the failure */
+
+if (sim_fseek (uptr->fileref, 0, SEEK_SET))             /* start at the beginning of the image */
+    error = TRUE;
+
+while (!error) {                                        /* copy the image */
+    count = fread (ctx->buf, 1, TBUF_SIZE, uptr->fileref);  /*   using the stream buffer */
+
+    if (count > 0 && gzwrite (gz, ctx->buf, (unsigned) count) != (int) count)
+        error = TRUE;
+    else if (count < TBUF_SIZE) {
+        error = (ferror (uptr->fileref) != 0);
+        break;
+        }
+    }
+
+if (gzclose (gz) != Z_OK)                               /* finish the compressed file */
+    error = TRUE;
+
+ctx->buf_len = 0;                                       /* the stream buffer contents are gone */
+
+if (error) {                                            /* if the copy failed */
+    remove (tname);                                     /*   then discard the partial file */
+    return SCPE_IOERR;
+    }
+
+return SCPE_OK;
+}
+
+#endif
+
+
+
 /* Set tape capacity */
 
 t_stat sim_tape_set_capac (UNIT *uptr, int32 val, char *cptr, void *desc)
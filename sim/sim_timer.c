@@ -46,6 +46,7 @@
    sim_timer_init       initialize timing system
    sim_activate_after   activate for specified number of microseconds
    sim_idle             virtual machine idle
+   sim_idle_doorbell    set doorbell poll unit and wait routine for idle
    sim_os_msec          return elapsed time in msec
    sim_os_sleep         sleep specified number of seconds
    sim_os_ms_sleep      sleep specified number of milliseconds
@@ -63,6 +64,8 @@ t_bool sim_idle_enab = FALSE;                           /* global flag */
 
 static uint32 sim_idle_rate_ms = 0;
 static uint32 sim_idle_stable = SIM_IDLE_STDFLT;
+static UNIT *sim_idle_db_uptr = NULL;                   /* doorbell poll unit */
+static t_bool (*sim_idle_db_wait) (uint32 msec) = NULL; /* doorbell wait */
 static uint32 sim_throt_ms_start = 0;
 static uint32 sim_throt_ms_stop = 0;
 static uint32 sim_throt_type = 0;
@@ -394,15 +397,21 @@ return (sim_idle_rate_ms != 0);
 t_bool sim_idle (uint32 tmr, t_bool sin_cyc)
 {
 static uint32 cyc_ms = 0;
-uint32 w_ms, w_idle, act_ms;
-int32 act_cyc;
+uint32 w_ms, w_idle, act_ms, start;
+int32 act_cyc, db_time = 0;
+t_bool rung = FALSE;
 
+if (sim_idle_enab && (sim_idle_db_uptr != NULL) &&      /* doorbell poll active? */
+    ((db_time = sim_is_active (sim_idle_db_uptr)) != 0))
+    sim_cancel (sim_idle_db_uptr);                      /* don't let it block idle */
 if ((!sim_idle_enab) ||                                 /* idling disabled */
     (sim_clock_queue == NULL) ||                        /* clock queue empty? */
     ((sim_clock_queue->flags & UNIT_IDLE) == 0) ||      /* event not idle-able? */
     (rtc_elapsed[tmr] < sim_idle_stable)) {             /* timer not stable? */
     if (sin_cyc)
         sim_interval = sim_interval - 1;
+    if (db_time != 0)                                   /* resume polling */
+        sim_activate (sim_idle_db_uptr, db_time - 1);
     return FALSE;
     }
 if (cyc_ms == 0)                                        /* not computed yet? */
@@ -410,6 +419,8 @@ if (cyc_ms == 0)                                        /* not computed yet? */
 if ((sim_idle_rate_ms == 0) || (cyc_ms == 0)) {         /* not possible? */
     if (sin_cyc)
         sim_interval = sim_interval - 1;
+    if (db_time != 0)
+        sim_activate (sim_idle_db_uptr, db_time - 1);
     return FALSE;
     }
 w_ms = (uint32) sim_interval / cyc_ms;                  /* ms to wait */
@@ -417,16 +428,47 @@ w_idle = w_ms / sim_idle_rate_ms;                       /* intervals to wait */
 if (w_idle == 0) {                                      /* none? */
     if (sin_cyc)
         sim_interval = sim_interval - 1;
+    if (db_time != 0)
+        sim_activate (sim_idle_db_uptr, db_time - 1);
     return FALSE;
     }
-act_ms = sim_os_ms_sleep (w_ms);                        /* wait */
+if (db_time != 0) {                                     /* doorbell? */
+    start = sim_os_msec ();
+    rung = sim_idle_db_wait (w_ms);                     /* wait for it */
+    act_ms = sim_os_msec () - start;
+    }
+else act_ms = sim_os_ms_sleep (w_ms);                   /* wait */
 act_cyc = act_ms * cyc_ms;
 if (sim_interval > act_cyc)
     sim_interval = sim_interval - act_cyc;              /* count down sim_interval */
 else sim_interval = 0;                                  /* or fire immediately */
+if (db_time != 0)                                       /* poll now if rung */
+    sim_activate (sim_idle_db_uptr, rung? 0: db_time - 1);
 return TRUE;
 }
 
+/* sim_idle_doorbell - set doorbell for idle
+
+   Inputs:
+        uptr =  unit polling for events from another process
+        wait =  routine to wait for the other process to signal
+
+   A device that polls for events signalled by another process keeps the
+   simulator busy, because its poll unit is always at the head of the
+   event queue. While idling, sim_idle takes the poll unit off the queue
+   and calls the wait routine instead of sleeping. The wait routine
+   returns TRUE if it was woken by a signal, and the poll unit is then
+   scheduled immediately; otherwise polling resumes where it left off.
+   A NULL unit removes the doorbell.
+*/
+
+void sim_idle_doorbell (UNIT *uptr, t_bool (*wait) (uint32 msec))
+{
+sim_idle_db_uptr = (wait != NULL)? uptr: NULL;
+sim_idle_db_wait = wait;
+return;
+}
+
 /* Set idling - implicitly disables throttling */
 
 t_stat sim_set_idle (UNIT *uptr, int32 val, char *cptr, void *desc)
@@ -59,6 +59,7 @@ int32 sim_rtc_init (int32 time);
 int32 sim_rtc_calb (int32 ticksper);
 t_stat sim_activate_after (UNIT *uptr, int32 usec_delay);
 t_bool sim_idle (uint32 tmr, t_bool sin_cyc);
+void sim_idle_doorbell (UNIT *uptr, t_bool (*wait) (uint32 msec));
 t_stat sim_set_throt (int32 arg, char *cptr);
 t_stat sim_show_throt (FILE *st, DEVICE *dnotused, UNIT *unotused, int32 flag, char *cptr);
 t_stat sim_set_idle (UNIT *uptr, int32 val, char *cptr, void *desc);